@@ -6,6 +6,7 @@
 #include <glm/gtc/type_ptr.hpp>
 
 #include "shaders/shader.hpp"
+#include "glState.hpp"
 #include "root_directory.h"
 
 #include <iostream>
@@ -78,12 +79,12 @@ int main()
     glGenBuffers(1, &VBO);
     glGenBuffers(1, &EBO);
     // bind the Vertex Array Object first, then bind and set vertex buffer(s), and then configure vertex attributes(s).
-    glBindVertexArray(VAO);
+    GLState::Get().BindVertexArray(VAO);
 
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    GLState::Get().BindBuffer(GL_ARRAY_BUFFER, VBO);
     glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
 
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+    GLState::Get().BindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
     glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
 
     // position attribute
@@ -153,22 +154,22 @@ int main()
 
         // Render quad 1
         glUniformMatrix4fv(transformLoc, 1, GL_FALSE, glm::value_ptr(transform1));
-        glBindVertexArray(VAO);
+        GLState::Get().BindVertexArray(VAO);
         glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
 
         // Render quad 2
         glUniformMatrix4fv(transformLoc, 1, GL_FALSE, glm::value_ptr(transform2));
-        glBindVertexArray(VAO);
+        GLState::Get().BindVertexArray(VAO);
         glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
 
         // Render quad 3
         glUniformMatrix4fv(transformLoc, 1, GL_FALSE, glm::value_ptr(transform3));
-        glBindVertexArray(VAO);
+        GLState::Get().BindVertexArray(VAO);
         glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
 
         // Render quad 4
         glUniformMatrix4fv(transformLoc, 1, GL_FALSE, glm::value_ptr(transform4));
-        glBindVertexArray(VAO);
+        GLState::Get().BindVertexArray(VAO);
         glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
 
         // glfw: swap buffers and poll IO events (keys pressed/released, mouse moved etc.)
@@ -179,9 +180,9 @@ int main()
 
     // optional: de-allocate all resources once they've outlived their purpose:
     // ------------------------------------------------------------------------
-    glDeleteVertexArrays(1, &VAO);
-    glDeleteBuffers(1, &VBO);
-    glDeleteBuffers(1, &EBO);
+    GLState::Get().DeleteVertexArrays(1, &VAO);
+    GLState::Get().DeleteBuffers(1, &VBO);
+    GLState::Get().DeleteBuffers(1, &EBO);
 
     // glfw: terminate, clearing all previously allocated GLFW resources.
     // ------------------------------------------------------------------
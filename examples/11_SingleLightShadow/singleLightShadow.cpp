@@ -9,6 +9,10 @@
 #include <glm/gtc/type_ptr.hpp>
 
 #include "shaders/shader.hpp"
+#include "glState.hpp"
+#include "geometryArena.hpp"
+#include "uniformBlocks.hpp"
+#include "textureCache.hpp"
 #include "root_directory.h"
 #include "cameras/cameraFirstPerson.hpp"
 #include "performanceMonitor.hpp"
@@ -32,8 +36,8 @@ float deltaTime = 0.0f;
 float lastFrame = 0.0f;
 
 struct RenderObject {
-    unsigned int VAO, VBO;
-    unsigned indexCount;
+    // range of the object's vertices and indices in the geometry arena
+    GeometryHandle geometry;
     glm::mat4 transform;
     unsigned int textureId;
     glm::vec3 ka, kd, ks, color;
@@ -173,526 +177,525 @@ int main()
         return -1;
     }
 
-    // configure global opengl state
-    // -----------------------------
-    glEnable(GL_DEPTH_TEST);
-
-    // build and compile our shader zprogram
-    // ------------------------------------
-    Shader pointLightTexShader(getPath("source/shaders/PointLightShadowTexShader.vs").string().c_str(), 
-                               getPath("source/shaders/PointLightShadowTexShader.fs").string().c_str() );
-    Shader pointLightClrShader(getPath("source/shaders/PointLightShadowClrShader.vs").string().c_str(), 
-                               getPath("source/shaders/PointLightShadowClrShader.fs").string().c_str() );
-    Shader dirLightTexShader(getPath("source/shaders/DirLightShadowTexShader.vs").string().c_str(), 
-                               getPath("source/shaders/DirLightShadowTexShader.fs").string().c_str() );
-    Shader dirLightClrShader(getPath("source/shaders/DirLightShadowClrShader.vs").string().c_str(), 
-                               getPath("source/shaders/DirLightShadowClrShader.fs").string().c_str() );
-    Shader spotLightTexShader(getPath("source/shaders/SpotLightShadowTexShader.vs").string().c_str(), 
-                               getPath("source/shaders/SpotLightShadowTexShader.fs").string().c_str() );
-    Shader spotLightClrShader(getPath("source/shaders/SpotLightShadowClrShader.vs").string().c_str(), 
-                               getPath("source/shaders/SpotLightShadowClrShader.fs").string().c_str() );
-    Shader lightCubeShader(getPath("source/shaders/colorMVPShader.vs").string().c_str(), 
-                           getPath("source/shaders/colorMVPShader.fs").string().c_str() );
-    Shader depthMappingShader(getPath("source/shaders/ShadowMapDepthShader.vs").string().c_str(), 
-                           getPath("source/shaders/ShadowMapDepthShader.fs").string().c_str() );
-    Shader depthDebugShader(getPath("source/shaders/depthMapping.vs").string().c_str(), 
-                           getPath("source/shaders/depthMapping.fs").string().c_str() );
-    Shader* currentLightTexShader = nullptr;
-    Shader* currentLightClrShader = nullptr;
-
-    // shader configuration
-    // --------------------
-    depthDebugShader.use();
-    depthDebugShader.setInt("depthMap", 0);
+    // everything that owns GL objects lives in this scope and is destroyed before glfwTerminate()
+    {
+        // configure global opengl state
+        // -----------------------------
+        glEnable(GL_DEPTH_TEST);
+
+        // build and compile our shader zprogram
+        // ------------------------------------
+        Shader pointLightTexShader(getPath("source/shaders/PointLightShadowTexShader.vs").string().c_str(), 
+                                   getPath("source/shaders/PointLightShadowTexShader.fs").string().c_str() );
+        Shader pointLightClrShader(getPath("source/shaders/PointLightShadowClrShader.vs").string().c_str(), 
+                                   getPath("source/shaders/PointLightShadowClrShader.fs").string().c_str() );
+        Shader dirLightTexShader(getPath("source/shaders/DirLightShadowTexShader.vs").string().c_str(), 
+                                   getPath("source/shaders/DirLightShadowTexShader.fs").string().c_str() );
+        Shader dirLightClrShader(getPath("source/shaders/DirLightShadowClrShader.vs").string().c_str(), 
+                                   getPath("source/shaders/DirLightShadowClrShader.fs").string().c_str() );
+        Shader spotLightTexShader(getPath("source/shaders/SpotLightShadowTexShader.vs").string().c_str(), 
+                                   getPath("source/shaders/SpotLightShadowTexShader.fs").string().c_str() );
+        Shader spotLightClrShader(getPath("source/shaders/SpotLightShadowClrShader.vs").string().c_str(), 
+                                   getPath("source/shaders/SpotLightShadowClrShader.fs").string().c_str() );
+        Shader lightCubeShader(getPath("source/shaders/colorMVPShader.vs").string().c_str(), 
+                               getPath("source/shaders/colorMVPShader.fs").string().c_str() );
+        Shader depthMappingShader(getPath("source/shaders/ShadowMapDepthShader.vs").string().c_str(), 
+                               getPath("source/shaders/ShadowMapDepthShader.fs").string().c_str() );
+        Shader depthDebugShader(getPath("source/shaders/depthMapping.vs").string().c_str(), 
+                               getPath("source/shaders/depthMapping.fs").string().c_str() );
+        Shader* currentLightTexShader = nullptr;
+        Shader* currentLightClrShader = nullptr;
+
+        // shader configuration
+        // --------------------
+        depthDebugShader.use();
+        depthDebugShader.setInt("depthMap", 0);
 
-    pointLightTexShader.use();
-    pointLightTexShader.setInt("texture_diffuse0", 0);
-    pointLightTexShader.setInt("shadowMap", 1);
+        pointLightTexShader.use();
+        pointLightTexShader.setInt("texture_diffuse0", 0);
+        pointLightTexShader.setInt("shadowMap", 1);
     
-    pointLightClrShader.use();
-    pointLightClrShader.setInt("shadowMap", 0);
+        pointLightClrShader.use();
+        pointLightClrShader.setInt("shadowMap", 0);
 
-    dirLightTexShader.use();
-    dirLightTexShader.setInt("texture_diffuse0", 0);
-    dirLightTexShader.setInt("shadowMap", 1);
+        dirLightTexShader.use();
+        dirLightTexShader.setInt("texture_diffuse0", 0);
+        dirLightTexShader.setInt("shadowMap", 1);
 
-    dirLightClrShader.use();
-    dirLightClrShader.setInt("shadowMap", 0);
+        dirLightClrShader.use();
+        dirLightClrShader.setInt("shadowMap", 0);
 
-    spotLightTexShader.use();
-    spotLightTexShader.setInt("texture_diffuse0", 0);
-    spotLightTexShader.setInt("shadowMap", 1);
+        spotLightTexShader.use();
+        spotLightTexShader.setInt("texture_diffuse0", 0);
+        spotLightTexShader.setInt("shadowMap", 1);
 
-    spotLightClrShader.use();
-    spotLightClrShader.setInt("shadowMap", 0);
+        spotLightClrShader.use();
+        spotLightClrShader.setInt("shadowMap", 0);
      
-    // Lights settings
-    PointLight* pointLight = new PointLight;
-    pointLight->position = glm::vec3(1.2f, 1.2f, 1.0f);
-    pointLight->ambient = glm::vec3(0.5f);
-    pointLight->diffuse = glm::vec3(1.0f);
-    pointLight->specular = glm::vec3(1.0f);
-    pointLight->constant = 1.0f;
-    pointLight->linear = 0.09f;
-    pointLight->quadratic = 0.032f;
-    pointLight->nearPlane = 0.1f;
-    pointLight->farPlane = 40.0f;
-    pointLight->fov = 95.0f;
-    pointLight->projection = glm::perspective(glm::radians(pointLight->fov), 1.0f, pointLight->nearPlane, pointLight->farPlane);
-
-    DirectionalLight* dirLight = new DirectionalLight;
-    dirLight->direction = glm::normalize(glm::vec3(1.0f, -1.0f, 0.5f));
-    dirLight->ambient = glm::vec3(0.5f);
-    dirLight->diffuse = glm::vec3(1.0f);
-    dirLight->specular = glm::vec3(1.0f);
-    dirLight->nearPlane = 0.01f;
-    dirLight->farPlane = 17.5f;
-    dirLight->orthoDim = 10.0f;
-    dirLight->projection = glm::ortho(-dirLight->orthoDim, dirLight->orthoDim, -dirLight->orthoDim, dirLight->orthoDim, dirLight->nearPlane, dirLight->farPlane);
-
-    SpotLight* spotLight = new SpotLight;
-    spotLight->position = glm::vec3(1.0f);
-    spotLight->direction = glm::vec3(1.0f);
-    spotLight->cutOff = glm::cos(glm::radians(15.0f));
-    spotLight->outerCutOff = glm::cos(glm::radians(20.0f));
-    spotLight->ambient = glm::vec3(0.1f);
-    spotLight->diffuse = glm::vec3(1.0f);
-    spotLight->specular = glm::vec3(1.0f);
-    spotLight->constant = 1.0f;
-    spotLight->linear = 0.09f;
-    spotLight->quadratic = 0.032f;
-    spotLight->nearPlane = 0.1f;
-    spotLight->farPlane = 50.0f;
-    spotLight->projection = glm::perspective(glm::radians(75.0f), 1.0f, spotLight->nearPlane, spotLight->farPlane);
-
-    // Render batches
-    RenderBatch phongTexObjects;
-    RenderBatch phongClrObjects;
-    RenderBatch coloredObjects;
-
-    // configure depth map FBO for each light type
-    // -----------------------
-    const unsigned int SHADOW_WIDTH = 1024, SHADOW_HEIGHT = 1024;
-
-    /// ------- FOR DIRECTIONAL LIGHT --------
-    glGenFramebuffers(1, &(dirLight->depthMapFBO));
-    glGenTextures(1, &(dirLight->depthMap)); // create depth texture
-    glBindTexture(GL_TEXTURE_2D, (dirLight->depthMap));
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT, SHADOW_WIDTH, SHADOW_HEIGHT, 0, GL_DEPTH_COMPONENT, GL_FLOAT, NULL);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
-    float borderColor[] = { 1.0, 1.0, 1.0, 1.0 };
-    glTexParameterfv(GL_TEXTURE_2D, GL_TEXTURE_BORDER_COLOR, borderColor);
-    // attach depth texture as FBO's depth buffer
-    glBindFramebuffer(GL_FRAMEBUFFER, (dirLight->depthMapFBO));
-    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, (dirLight->depthMap), 0);
-    glDrawBuffer(GL_NONE);
-    glReadBuffer(GL_NONE);
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
-    // ------- FOR POINTLIGHT --------
-    glGenFramebuffers(1, &(pointLight->depthMapFBO));
-    glGenTextures(1, &(pointLight->depthMap)); // create depth texture
-    glBindTexture(GL_TEXTURE_2D, (pointLight->depthMap));
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT, SHADOW_WIDTH, SHADOW_HEIGHT, 0, GL_DEPTH_COMPONENT, GL_FLOAT, NULL);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
-    glTexParameterfv(GL_TEXTURE_2D, GL_TEXTURE_BORDER_COLOR, borderColor);
-    // attach depth texture as FBO's depth buffer
-    glBindFramebuffer(GL_FRAMEBUFFER, (pointLight->depthMapFBO));
-    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, (pointLight->depthMap), 0);
-    glDrawBuffer(GL_NONE);
-    glReadBuffer(GL_NONE);
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
-    // ------- FOR SPOTLIGHT --------
-    glGenFramebuffers(1, &(spotLight->depthMapFBO));
-    glGenTextures(1, &(spotLight->depthMap)); // create depth texture
-    glBindTexture(GL_TEXTURE_2D, (spotLight->depthMap));
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT, SHADOW_WIDTH, SHADOW_HEIGHT, 0, GL_DEPTH_COMPONENT, GL_FLOAT, NULL);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
-    glTexParameterfv(GL_TEXTURE_2D, GL_TEXTURE_BORDER_COLOR, borderColor);
-    // attach depth texture as FBO's depth buffer
-    glBindFramebuffer(GL_FRAMEBUFFER, (spotLight->depthMapFBO));
-    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, (spotLight->depthMap), 0);
-    glDrawBuffer(GL_NONE);
-    glReadBuffer(GL_NONE);
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
-
-    // Phong textured objects
-    RenderObjectPtr floor = createTexCube("assets/wood.png", 5.0f);
-    floor->transform = glm::translate(floor->transform, glm::vec3(0.0f, -8.0f, 0.0f));
-    floor->transform = glm::scale(floor->transform, glm::vec3(16.0f));
-    phongTexObjects.push_back(floor);
-    RenderObjectPtr box = createTexCube("assets/box.png", 1.0f);
-    box->transform = glm::translate(box->transform, glm::vec3(5.0f, 2.0f, 4.0f));
-    box->transform = glm::rotate(box->transform, glm::radians(45.0f), glm::vec3(0.0f, 1.0f, 0.0f));
-    box->transform = glm::scale(box->transform, glm::vec3(1.0f));
-    phongTexObjects.push_back(box);
-    RenderObjectPtr box2 = createTexCube("assets/box.png", 1.0f);
-    box2->transform = glm::translate(box2->transform, glm::vec3(1.0f, 0.3501f, 3.0f));
-    box2->transform = glm::scale(box2->transform, glm::vec3(0.7f));
-    phongTexObjects.push_back(box2);
-
-    // Phong colored objects
-    RenderObjectPtr wall = createClrCube(glm::vec3(1.0f, 0.5f, 0.0f));
-    wall->transform = glm::translate(wall->transform, glm::vec3(16.0f, 0.0f, 0.0f));
-    wall->transform = glm::scale(wall->transform, glm::vec3(16.0f));
-    phongClrObjects.push_back(wall);
-    RenderObjectPtr jumpingBox = createClrCube(glm::vec3(0.3f, 0.0f, 1.0f));
-    phongClrObjects.push_back(jumpingBox);
-    RenderObjectPtr rotBox = createClrCube(glm::vec3(0.2f, 1.0f, 0.0f));
-    phongClrObjects.push_back(rotBox);
-
-    // Depth map quad object
-    RenderObjectPtr depthQuad = createTexQuad();
-
-    // light cube
-    coloredObjects.push_back(createLightCube(pointLight->position));
-
-    PerformanceMonitor pMonitor(glfwGetTime(), 0.5f);
-
-    // Use fcae culling to fix peter panning problwms with shadows
-    //glEnable(GL_CULL_FACE);
-
-    // render loop
-    // -----------
-    while (!glfwWindowShouldClose(window))
-    {
-        // per-frame time logic
-        // --------------------
-        float currentFrame = glfwGetTime();
-        deltaTime = currentFrame - lastFrame;
-        lastFrame = currentFrame;
-
-        pMonitor.update(glfwGetTime());
-        stringstream ss;
-        ss << title << " " << pMonitor;
-        glfwSetWindowTitle(window, ss.str().c_str());
-
-        // input
-        // -----
-        processInput(window);
-
-        // refreshing the transforms
-        jumpingBox->transform = glm::translate(glm::mat4(1.0f), 
-                                    glm::vec3(0.0f, 
-                                            glm::abs(glm::sin(glfwGetTime()*1.2f)*4.0f), 
-                                            0.0f));
-        jumpingBox->transform = glm::translate(jumpingBox->transform, glm::vec3(5.0f, 0.6f, -4.0f));
-        jumpingBox->transform = glm::scale(jumpingBox->transform, glm::vec3(1.2f));
-        rotBox->transform = glm::translate(glm::mat4(1.0f), glm::vec3(-4.0f, 2.5f, 0.0f));
-        rotBox->transform = glm::rotate(rotBox->transform, (float)glfwGetTime()*1.0f, 
-                                        glm::vec3(1.0f, 0.0f, 0.0f));
-        rotBox->transform = glm::rotate(rotBox->transform, (float)glfwGetTime()*1.0f, 
-                                        glm::vec3(0.0f, 1.0f, 0.0f));
-        rotBox->transform = glm::rotate(rotBox->transform, (float)glfwGetTime()*1.0f, 
-                                        glm::vec3(0.0f, 0.0f, 1.0f));
-        rotBox->transform = glm::scale(rotBox->transform, glm::vec3(1.2f, 1.2f, 4.0f));
-
-        switch (currentLighting)
-        {
-        case ELightType::Point:
-            currentLightTexShader = &pointLightTexShader;
-            currentLightClrShader = &pointLightClrShader;
-            break;
-        case ELightType::Directional:
-            currentLightTexShader = &dirLightTexShader;
-            currentLightClrShader = &dirLightClrShader;
-            break;
-        case ELightType::Spot:
-            currentLightTexShader = &spotLightTexShader;
-            currentLightClrShader = &spotLightClrShader;
-            break;
-        default:
-            break;
-        }
-        
-        float cameraNear = 0.1f;
-        float cameraFar = 100.0f;
-        // render
-        // ------
-        glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-        
-        // 1. render depth of scene to texture (for each light type)
-        // --------------------------------------------------------------
-        //glCullFace(GL_FRONT);
-
-        // RENDER DEPTH MAP FOR POINT LIGHT
-        glm::vec3 goalPoint = camera.Position + camera.Front*( (cameraFar-cameraNear)/2.0f );
-        pointLight->direction = glm::normalize( goalPoint - pointLight->position);
-        pointLight->view = glm::lookAt(pointLight->position, pointLight->position + pointLight->direction, glm::vec3(0.0, 1.0, 0.0));
-        pointLight->spaceMatrix = pointLight->projection * pointLight->view;
-        // render the scene to the buffer
-        glViewport(0, 0, SHADOW_WIDTH, SHADOW_HEIGHT);
-        glBindFramebuffer(GL_FRAMEBUFFER, (pointLight->depthMapFBO));
-        glClear(GL_DEPTH_BUFFER_BIT);
-        depthMappingShader.use();
-        depthMappingShader.setMat4("lightSpaceMat", pointLight->spaceMatrix);
-        // Render the textured objects
-        for(auto& toRender: phongTexObjects) {
-            depthMappingShader.setMat4("model", toRender->transform);
-            // bind textures on corresponding texture units
-            glBindVertexArray(toRender->VAO);
-            glDrawElements(GL_TRIANGLES, toRender->indexCount, GL_UNSIGNED_INT, 0);
-        }
-        // Render the colored objects
-        for(auto& toRender: phongClrObjects) {
-            // material properties
-            depthMappingShader.setMat4("model", toRender->transform);
-            // bind textures on corresponding texture units
-            glBindVertexArray(toRender->VAO);
-            glDrawElements(GL_TRIANGLES, toRender->indexCount, GL_UNSIGNED_INT, 0);
-        }
-        glBindFramebuffer(GL_FRAMEBUFFER, 0);
-
-        // RENDER DEPTH MAP FOR DIRECTIONAL LIGHT
-        dirLight->position = dirLight->direction * -8.0f;
-        dirLight->view = glm::lookAt(dirLight->position, dirLight->position + glm::normalize(dirLight->direction), glm::vec3(0.0, 1.0, 0.0));
-        dirLight->spaceMatrix = dirLight->projection * dirLight->view;
-        // render the scene to the buffer
-        glViewport(0, 0, SHADOW_WIDTH, SHADOW_HEIGHT);
+        // Lights settings
+        PointLight* pointLight = new PointLight;
+        pointLight->position = glm::vec3(1.2f, 1.2f, 1.0f);
+        pointLight->ambient = glm::vec3(0.5f);
+        pointLight->diffuse = glm::vec3(1.0f);
+        pointLight->specular = glm::vec3(1.0f);
+        pointLight->constant = 1.0f;
+        pointLight->linear = 0.09f;
+        pointLight->quadratic = 0.032f;
+        pointLight->nearPlane = 0.1f;
+        pointLight->farPlane = 40.0f;
+        pointLight->fov = 95.0f;
+        pointLight->projection = glm::perspective(glm::radians(pointLight->fov), 1.0f, pointLight->nearPlane, pointLight->farPlane);
+
+        DirectionalLight* dirLight = new DirectionalLight;
+        dirLight->direction = glm::normalize(glm::vec3(1.0f, -1.0f, 0.5f));
+        dirLight->ambient = glm::vec3(0.5f);
+        dirLight->diffuse = glm::vec3(1.0f);
+        dirLight->specular = glm::vec3(1.0f);
+        dirLight->nearPlane = 0.01f;
+        dirLight->farPlane = 17.5f;
+        dirLight->orthoDim = 10.0f;
+        dirLight->projection = glm::ortho(-dirLight->orthoDim, dirLight->orthoDim, -dirLight->orthoDim, dirLight->orthoDim, dirLight->nearPlane, dirLight->farPlane);
+
+        SpotLight* spotLight = new SpotLight;
+        spotLight->position = glm::vec3(1.0f);
+        spotLight->direction = glm::vec3(1.0f);
+        spotLight->cutOff = glm::cos(glm::radians(15.0f));
+        spotLight->outerCutOff = glm::cos(glm::radians(20.0f));
+        spotLight->ambient = glm::vec3(0.1f);
+        spotLight->diffuse = glm::vec3(1.0f);
+        spotLight->specular = glm::vec3(1.0f);
+        spotLight->constant = 1.0f;
+        spotLight->linear = 0.09f;
+        spotLight->quadratic = 0.032f;
+        spotLight->nearPlane = 0.1f;
+        spotLight->farPlane = 50.0f;
+        spotLight->projection = glm::perspective(glm::radians(75.0f), 1.0f, spotLight->nearPlane, spotLight->farPlane);
+
+        // Render batches
+        RenderBatch phongTexObjects;
+        RenderBatch phongClrObjects;
+        RenderBatch coloredObjects;
+
+        // configure depth map FBO for each light type
+        // -----------------------
+        const unsigned int SHADOW_WIDTH = 1024, SHADOW_HEIGHT = 1024;
+
+        /// ------- FOR DIRECTIONAL LIGHT --------
+        glGenFramebuffers(1, &(dirLight->depthMapFBO));
+        glGenTextures(1, &(dirLight->depthMap)); // create depth texture
+        GLState::Get().BindTexture(GL_TEXTURE_2D, (dirLight->depthMap));
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT, SHADOW_WIDTH, SHADOW_HEIGHT, 0, GL_DEPTH_COMPONENT, GL_FLOAT, NULL);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
+        float borderColor[] = { 1.0, 1.0, 1.0, 1.0 };
+        glTexParameterfv(GL_TEXTURE_2D, GL_TEXTURE_BORDER_COLOR, borderColor);
+        // attach depth texture as FBO's depth buffer
         glBindFramebuffer(GL_FRAMEBUFFER, (dirLight->depthMapFBO));
-        glClear(GL_DEPTH_BUFFER_BIT);
-        depthMappingShader.use();
-        depthMappingShader.setMat4("lightSpaceMat", dirLight->spaceMatrix);
-        // Render the textured objects
-        for(auto& toRender: phongTexObjects) {
-            depthMappingShader.setMat4("model", toRender->transform);
-            // bind textures on corresponding texture units
-            glBindVertexArray(toRender->VAO);
-            glDrawElements(GL_TRIANGLES, toRender->indexCount, GL_UNSIGNED_INT, 0);
-        }
-        // Render the colored objects
-        for(auto& toRender: phongClrObjects) {
-            // material properties
-            depthMappingShader.setMat4("model", toRender->transform);
-            // bind textures on corresponding texture units
-            glBindVertexArray(toRender->VAO);
-            glDrawElements(GL_TRIANGLES, toRender->indexCount, GL_UNSIGNED_INT, 0);
-        }
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, (dirLight->depthMap), 0);
+        glDrawBuffer(GL_NONE);
+        glReadBuffer(GL_NONE);
         glBindFramebuffer(GL_FRAMEBUFFER, 0);
-
-        // RENDER DEPTH MAP FOR SPOT LIGHT
-        spotLight->position = camera.Position + camera.Right*0.6f - camera.WorldUp*0.7f;
-        spotLight->direction = camera.Front;
-        spotLight->view = glm::lookAt(spotLight->position, spotLight->position + spotLight->direction, glm::vec3(0.0, 1.0, 0.0));
-        spotLight->spaceMatrix = spotLight->projection * spotLight->view;
-        // render the scene to the buffer
-        glViewport(0, 0, SHADOW_WIDTH, SHADOW_HEIGHT);
+        // ------- FOR POINTLIGHT --------
+        glGenFramebuffers(1, &(pointLight->depthMapFBO));
+        glGenTextures(1, &(pointLight->depthMap)); // create depth texture
+        GLState::Get().BindTexture(GL_TEXTURE_2D, (pointLight->depthMap));
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT, SHADOW_WIDTH, SHADOW_HEIGHT, 0, GL_DEPTH_COMPONENT, GL_FLOAT, NULL);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
+        glTexParameterfv(GL_TEXTURE_2D, GL_TEXTURE_BORDER_COLOR, borderColor);
+        // attach depth texture as FBO's depth buffer
+        glBindFramebuffer(GL_FRAMEBUFFER, (pointLight->depthMapFBO));
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, (pointLight->depthMap), 0);
+        glDrawBuffer(GL_NONE);
+        glReadBuffer(GL_NONE);
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        // ------- FOR SPOTLIGHT --------
+        glGenFramebuffers(1, &(spotLight->depthMapFBO));
+        glGenTextures(1, &(spotLight->depthMap)); // create depth texture
+        GLState::Get().BindTexture(GL_TEXTURE_2D, (spotLight->depthMap));
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT, SHADOW_WIDTH, SHADOW_HEIGHT, 0, GL_DEPTH_COMPONENT, GL_FLOAT, NULL);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
+        glTexParameterfv(GL_TEXTURE_2D, GL_TEXTURE_BORDER_COLOR, borderColor);
+        // attach depth texture as FBO's depth buffer
         glBindFramebuffer(GL_FRAMEBUFFER, (spotLight->depthMapFBO));
-        glClear(GL_DEPTH_BUFFER_BIT);
-        depthMappingShader.use();
-        depthMappingShader.setMat4("lightSpaceMat", spotLight->spaceMatrix);
-        // Render the textured objects
-        for(auto& toRender: phongTexObjects) {
-            depthMappingShader.setMat4("model", toRender->transform);
-            // bind textures on corresponding texture units
-            glBindVertexArray(toRender->VAO);
-            glDrawElements(GL_TRIANGLES, toRender->indexCount, GL_UNSIGNED_INT, 0);
-        }
-        // Render the colored objects
-        for(auto& toRender: phongClrObjects) {
-            // material properties
-            depthMappingShader.setMat4("model", toRender->transform);
-            // bind textures on corresponding texture units
-            glBindVertexArray(toRender->VAO);
-            glDrawElements(GL_TRIANGLES, toRender->indexCount, GL_UNSIGNED_INT, 0);
-        }
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, (spotLight->depthMap), 0);
+        glDrawBuffer(GL_NONE);
+        glReadBuffer(GL_NONE);
         glBindFramebuffer(GL_FRAMEBUFFER, 0);
 
-        // reset viewport
-        glViewport(0, 0, SCR_WIDTH, SCR_HEIGHT);
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-        //glCullFace(GL_BACK);
-        // 2. render scene as normal using the generated depth/shadow map  
-        // --------------------------------------------------------------
-
-        currentLightTexShader->use();
-        // light properties
-        if (currentLighting==ELightType::Point) {
-            currentLightTexShader->setVec3("light.position", pointLight->position);
-            currentLightTexShader->setMat4("lightSpaceMat", pointLight->spaceMatrix);
-            currentLightTexShader->setVec3("light.ambient", pointLight->ambient);
-            currentLightTexShader->setVec3("light.diffuse", pointLight->diffuse);
-            currentLightTexShader->setVec3("light.specular", pointLight->specular);
-            currentLightTexShader->setFloat("light.constant", pointLight->constant);
-            currentLightTexShader->setFloat("light.linear", pointLight->linear);
-            currentLightTexShader->setFloat("light.quadratic", pointLight->quadratic);
-            glActiveTexture(GL_TEXTURE1);
-            glBindTexture(GL_TEXTURE_2D, pointLight->depthMap);
-        }
-        else if (currentLighting==ELightType::Directional)
+        // Phong textured objects
+        RenderObjectPtr floor = createTexCube("assets/wood.png", 5.0f);
+        floor->transform = glm::translate(floor->transform, glm::vec3(0.0f, -8.0f, 0.0f));
+        floor->transform = glm::scale(floor->transform, glm::vec3(16.0f));
+        phongTexObjects.push_back(floor);
+        RenderObjectPtr box = createTexCube("assets/box.png", 1.0f);
+        box->transform = glm::translate(box->transform, glm::vec3(5.0f, 2.0f, 4.0f));
+        box->transform = glm::rotate(box->transform, glm::radians(45.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+        box->transform = glm::scale(box->transform, glm::vec3(1.0f));
+        phongTexObjects.push_back(box);
+        RenderObjectPtr box2 = createTexCube("assets/box.png", 1.0f);
+        box2->transform = glm::translate(box2->transform, glm::vec3(1.0f, 0.3501f, 3.0f));
+        box2->transform = glm::scale(box2->transform, glm::vec3(0.7f));
+        phongTexObjects.push_back(box2);
+
+        // Phong colored objects
+        RenderObjectPtr wall = createClrCube(glm::vec3(1.0f, 0.5f, 0.0f));
+        wall->transform = glm::translate(wall->transform, glm::vec3(16.0f, 0.0f, 0.0f));
+        wall->transform = glm::scale(wall->transform, glm::vec3(16.0f));
+        phongClrObjects.push_back(wall);
+        RenderObjectPtr jumpingBox = createClrCube(glm::vec3(0.3f, 0.0f, 1.0f));
+        phongClrObjects.push_back(jumpingBox);
+        RenderObjectPtr rotBox = createClrCube(glm::vec3(0.2f, 1.0f, 0.0f));
+        phongClrObjects.push_back(rotBox);
+
+        // Depth map quad object
+        RenderObjectPtr depthQuad = createTexQuad();
+
+        // light cube
+        coloredObjects.push_back(createLightCube(pointLight->position));
+
+        PerformanceMonitor pMonitor(glfwGetTime(), 0.5f);
+
+        // Use fcae culling to fix peter panning problwms with shadows
+        //glEnable(GL_CULL_FACE);
+
+        // camera data shared by every shader through the Camera block
+        UniformBuffer cameraBlock(CAMERA_BLOCK_BINDING);
+
+        // every RenderObject lives in the shared geometry arena, one VAO per vertex format
+        GeometryArena& arena = GeometryArena::Get();
+
+        // render loop
+        // -----------
+        while (!glfwWindowShouldClose(window))
         {
-            currentLightTexShader->setVec3("light.direction", dirLight->direction);
-            currentLightTexShader->setVec3("light.position",  dirLight->position);
-            currentLightTexShader->setMat4("lightSpaceMat", dirLight->spaceMatrix);
-            currentLightTexShader->setVec3("light.ambient", dirLight->ambient);
-            currentLightTexShader->setVec3("light.diffuse", dirLight->diffuse);
-            currentLightTexShader->setVec3("light.specular", dirLight->specular);
-            glActiveTexture(GL_TEXTURE1);
-            glBindTexture(GL_TEXTURE_2D, dirLight->depthMap);
-        }
-        else if (currentLighting==ELightType::Spot)
-        {
-            currentLightTexShader->setVec3("light.position", spotLight->position);
-            currentLightTexShader->setVec3("light.direction", spotLight->direction);
-            currentLightTexShader->setMat4("lightSpaceMat", spotLight->spaceMatrix);
-            currentLightTexShader->setVec3("light.ambient", spotLight->ambient);
-            currentLightTexShader->setVec3("light.diffuse", spotLight->diffuse);
-            currentLightTexShader->setVec3("light.specular", spotLight->specular);
-            currentLightTexShader->setFloat("light.cutOff", spotLight->cutOff);
-            currentLightTexShader->setFloat("light.outerCutOff", spotLight->outerCutOff);
-            currentLightTexShader->setFloat("light.constant", spotLight->constant);
-            currentLightTexShader->setFloat("light.linear", spotLight->linear);
-            currentLightTexShader->setFloat("light.quadratic", spotLight->quadratic);
-            glActiveTexture(GL_TEXTURE1);
-            glBindTexture(GL_TEXTURE_2D, spotLight->depthMap);	
-        }
-        // view/projection transformations
-        currentLightTexShader->setVec3("viewPos", camera.Position);
-        glm::mat4 projection = glm::perspective(glm::radians(camera.Zoom), (float)SCR_WIDTH / (float)SCR_HEIGHT, cameraNear, cameraFar);
-        currentLightTexShader->setMat4("projection", projection);
-        currentLightTexShader->setMat4("view", camera.GetViewMatrix());
-        for(auto& toRender: phongTexObjects) {
-            // material properties
-            currentLightTexShader->setVec3("material.ambient", toRender->ka);
-            currentLightTexShader->setVec3("material.diffuse", toRender->kd);
-            currentLightTexShader->setVec3("material.specular", toRender->ks); // specular lighting doesn't have full effect on this object's material
-            currentLightTexShader->setFloat("material.shininess", toRender->shininess);
-            currentLightTexShader->setMat4("model", toRender->transform);
-            // bind textures on corresponding texture units
-            glActiveTexture(GL_TEXTURE0);
-            glBindTexture(GL_TEXTURE_2D, toRender->textureId);
-            glBindVertexArray(toRender->VAO);
-            glDrawElements(GL_TRIANGLES, toRender->indexCount, GL_UNSIGNED_INT, 0);
-        }
-
-        // be sure to activate shader when setting uniforms/drawing objects
-        currentLightClrShader->use();
-        // light properties
-        if (currentLighting==ELightType::Point) {
-            currentLightClrShader->setVec3("light.position", pointLight->position);
-            currentLightClrShader->setMat4("lightSpaceMat", pointLight->spaceMatrix);
-            currentLightClrShader->setVec3("light.ambient", pointLight->ambient);
-            currentLightClrShader->setVec3("light.diffuse", pointLight->diffuse);
-            currentLightClrShader->setVec3("light.specular", pointLight->specular);
-            currentLightClrShader->setFloat("light.constant", pointLight->constant);
-            currentLightClrShader->setFloat("light.linear", pointLight->linear);
-            currentLightClrShader->setFloat("light.quadratic", pointLight->quadratic);
-            glActiveTexture(GL_TEXTURE0);
-            glBindTexture(GL_TEXTURE_2D, pointLight->depthMap);
-        }
-        else if (currentLighting==ELightType::Directional)
-        {
-            currentLightClrShader->setVec3("light.direction", dirLight->direction);
-            currentLightClrShader->setVec3("light.position", dirLight->position);
-            currentLightClrShader->setMat4("lightSpaceMat", dirLight->spaceMatrix);
-            currentLightClrShader->setVec3("light.ambient", dirLight->ambient);
-            currentLightClrShader->setVec3("light.diffuse", dirLight->diffuse);
-            currentLightClrShader->setVec3("light.specular", dirLight->specular);
-            glActiveTexture(GL_TEXTURE0);
-            glBindTexture(GL_TEXTURE_2D, dirLight->depthMap);
-        }
-        else if (currentLighting==ELightType::Spot)
-        {
-            currentLightClrShader->setVec3("light.position", spotLight->position);
-            currentLightClrShader->setVec3("light.direction", spotLight->direction);
-            currentLightClrShader->setMat4("lightSpaceMat", spotLight->spaceMatrix);
-            currentLightClrShader->setVec3("light.ambient", spotLight->ambient);
-            currentLightClrShader->setVec3("light.diffuse", spotLight->diffuse);
-            currentLightClrShader->setVec3("light.specular", spotLight->specular);
-            currentLightClrShader->setFloat("light.cutOff", spotLight->cutOff);
-            currentLightClrShader->setFloat("light.outerCutOff", spotLight->outerCutOff);
-            currentLightClrShader->setFloat("light.constant", spotLight->constant);
-            currentLightClrShader->setFloat("light.linear", spotLight->linear);
-            currentLightClrShader->setFloat("light.quadratic", spotLight->quadratic);
-            glActiveTexture(GL_TEXTURE0);
-            glBindTexture(GL_TEXTURE_2D, spotLight->depthMap);	
-        }
-        // view/projection transformations
-        currentLightClrShader->setVec3("viewPos", camera.Position);
-        currentLightClrShader->setMat4("projection", projection);
-        currentLightClrShader->setMat4("view", camera.GetViewMatrix());
-        for(auto& toRender: phongClrObjects) {
-            // material properties
-            currentLightClrShader->setVec3("material.ambient", toRender->ka);
-            currentLightClrShader->setVec3("material.diffuse", toRender->kd);
-            currentLightClrShader->setVec3("material.specular", toRender->ks); // specular lighting doesn't have full effect on this object's material
-            currentLightClrShader->setFloat("material.shininess", toRender->shininess);
-            currentLightClrShader->setVec3("color", toRender->color);
-            currentLightClrShader->setMat4("model", toRender->transform);
-            
-            // bind textures on corresponding texture units
-            glBindVertexArray(toRender->VAO);
-            glDrawElements(GL_TRIANGLES, toRender->indexCount, GL_UNSIGNED_INT, 0);
-        }
-
-        lightCubeShader.use();
-        lightCubeShader.setMat4("projection", projection);
-        lightCubeShader.setMat4("view", camera.GetViewMatrix());
-        for(auto& toRender: coloredObjects) {
-
-            lightCubeShader.setVec3("Color", (currentLighting==ELightType::Point)?toRender->color:glm::vec3(0.0f));
-            lightCubeShader.setMat4("model", toRender->transform);
-            lightCubeShader.setMat4("model", toRender->transform);        
-            glBindVertexArray(toRender->VAO);
-            glDrawArrays(GL_TRIANGLES, 0, toRender->indexCount);
-        }
-
-        if (currentDepthMap != EDepthMap::None) {
-            depthDebugShader.use();
-            glActiveTexture(GL_TEXTURE0);
-            if (currentLighting==ELightType::Point) 
+            // per-frame time logic
+            // --------------------
+            float currentFrame = glfwGetTime();
+            deltaTime = currentFrame - lastFrame;
+            lastFrame = currentFrame;
+
+            pMonitor.update(glfwGetTime());
+            stringstream ss;
+            ss << title << " " << pMonitor;
+            glfwSetWindowTitle(window, ss.str().c_str());
+
+            // input
+            // -----
+            processInput(window);
+
+            // refreshing the transforms
+            jumpingBox->transform = glm::translate(glm::mat4(1.0f), 
+                                        glm::vec3(0.0f, 
+                                                glm::abs(glm::sin(glfwGetTime()*1.2f)*4.0f), 
+                                                0.0f));
+            jumpingBox->transform = glm::translate(jumpingBox->transform, glm::vec3(5.0f, 0.6f, -4.0f));
+            jumpingBox->transform = glm::scale(jumpingBox->transform, glm::vec3(1.2f));
+            rotBox->transform = glm::translate(glm::mat4(1.0f), glm::vec3(-4.0f, 2.5f, 0.0f));
+            rotBox->transform = glm::rotate(rotBox->transform, (float)glfwGetTime()*1.0f, 
+                                            glm::vec3(1.0f, 0.0f, 0.0f));
+            rotBox->transform = glm::rotate(rotBox->transform, (float)glfwGetTime()*1.0f, 
+                                            glm::vec3(0.0f, 1.0f, 0.0f));
+            rotBox->transform = glm::rotate(rotBox->transform, (float)glfwGetTime()*1.0f, 
+                                            glm::vec3(0.0f, 0.0f, 1.0f));
+            rotBox->transform = glm::scale(rotBox->transform, glm::vec3(1.2f, 1.2f, 4.0f));
+
+            switch (currentLighting)
             {
-                glBindTexture(GL_TEXTURE_2D, pointLight->depthMap);
-                depthDebugShader.setBool("orthographic", false);
-                depthDebugShader.setFloat("nearPlane", pointLight->nearPlane);
-                depthDebugShader.setFloat("farPlane", pointLight->farPlane);
+            case ELightType::Point:
+                currentLightTexShader = &pointLightTexShader;
+                currentLightClrShader = &pointLightClrShader;
+                break;
+            case ELightType::Directional:
+                currentLightTexShader = &dirLightTexShader;
+                currentLightClrShader = &dirLightClrShader;
+                break;
+            case ELightType::Spot:
+                currentLightTexShader = &spotLightTexShader;
+                currentLightClrShader = &spotLightClrShader;
+                break;
+            default:
+                break;
+            }
+        
+            float cameraNear = 0.1f;
+            float cameraFar = 100.0f;
+            // render
+            // ------
+            glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        
+            // 1. render depth of scene to texture (for each light type)
+            // --------------------------------------------------------------
+            //glCullFace(GL_FRONT);
+
+            // RENDER DEPTH MAP FOR POINT LIGHT
+            glm::vec3 goalPoint = camera.Position + camera.Front*( (cameraFar-cameraNear)/2.0f );
+            pointLight->direction = glm::normalize( goalPoint - pointLight->position);
+            pointLight->view = glm::lookAt(pointLight->position, pointLight->position + pointLight->direction, glm::vec3(0.0, 1.0, 0.0));
+            pointLight->spaceMatrix = pointLight->projection * pointLight->view;
+            // render the scene to the buffer
+            glViewport(0, 0, SHADOW_WIDTH, SHADOW_HEIGHT);
+            glBindFramebuffer(GL_FRAMEBUFFER, (pointLight->depthMapFBO));
+            glClear(GL_DEPTH_BUFFER_BIT);
+            depthMappingShader.use();
+            depthMappingShader.setMat4("lightSpaceMat", pointLight->spaceMatrix);
+            // Render the textured objects
+            for(auto& toRender: phongTexObjects) {
+                depthMappingShader.setMat4("model", toRender->transform);
+                // bind textures on corresponding texture units
+                arena.Bind(toRender->geometry);
+                arena.Draw(toRender->geometry);
+            }
+            // Render the colored objects
+            for(auto& toRender: phongClrObjects) {
+                // material properties
+                depthMappingShader.setMat4("model", toRender->transform);
+                // bind textures on corresponding texture units
+                arena.Bind(toRender->geometry);
+                arena.Draw(toRender->geometry);
+            }
+            glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+            // RENDER DEPTH MAP FOR DIRECTIONAL LIGHT
+            dirLight->position = dirLight->direction * -8.0f;
+            dirLight->view = glm::lookAt(dirLight->position, dirLight->position + glm::normalize(dirLight->direction), glm::vec3(0.0, 1.0, 0.0));
+            dirLight->spaceMatrix = dirLight->projection * dirLight->view;
+            // render the scene to the buffer
+            glViewport(0, 0, SHADOW_WIDTH, SHADOW_HEIGHT);
+            glBindFramebuffer(GL_FRAMEBUFFER, (dirLight->depthMapFBO));
+            glClear(GL_DEPTH_BUFFER_BIT);
+            depthMappingShader.use();
+            depthMappingShader.setMat4("lightSpaceMat", dirLight->spaceMatrix);
+            // Render the textured objects
+            for(auto& toRender: phongTexObjects) {
+                depthMappingShader.setMat4("model", toRender->transform);
+                // bind textures on corresponding texture units
+                arena.Bind(toRender->geometry);
+                arena.Draw(toRender->geometry);
+            }
+            // Render the colored objects
+            for(auto& toRender: phongClrObjects) {
+                // material properties
+                depthMappingShader.setMat4("model", toRender->transform);
+                // bind textures on corresponding texture units
+                arena.Bind(toRender->geometry);
+                arena.Draw(toRender->geometry);
+            }
+            glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+            // RENDER DEPTH MAP FOR SPOT LIGHT
+            spotLight->position = camera.Position + camera.Right*0.6f - camera.WorldUp*0.7f;
+            spotLight->direction = camera.Front;
+            spotLight->view = glm::lookAt(spotLight->position, spotLight->position + spotLight->direction, glm::vec3(0.0, 1.0, 0.0));
+            spotLight->spaceMatrix = spotLight->projection * spotLight->view;
+            // render the scene to the buffer
+            glViewport(0, 0, SHADOW_WIDTH, SHADOW_HEIGHT);
+            glBindFramebuffer(GL_FRAMEBUFFER, (spotLight->depthMapFBO));
+            glClear(GL_DEPTH_BUFFER_BIT);
+            depthMappingShader.use();
+            depthMappingShader.setMat4("lightSpaceMat", spotLight->spaceMatrix);
+            // Render the textured objects
+            for(auto& toRender: phongTexObjects) {
+                depthMappingShader.setMat4("model", toRender->transform);
+                // bind textures on corresponding texture units
+                arena.Bind(toRender->geometry);
+                arena.Draw(toRender->geometry);
+            }
+            // Render the colored objects
+            for(auto& toRender: phongClrObjects) {
+                // material properties
+                depthMappingShader.setMat4("model", toRender->transform);
+                // bind textures on corresponding texture units
+                arena.Bind(toRender->geometry);
+                arena.Draw(toRender->geometry);
+            }
+            glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+            // reset viewport
+            glViewport(0, 0, SCR_WIDTH, SCR_HEIGHT);
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+            //glCullFace(GL_BACK);
+            // 2. render scene as normal using the generated depth/shadow map  
+            // --------------------------------------------------------------
+
+            currentLightTexShader->use();
+            // light properties
+            if (currentLighting==ELightType::Point) {
+                currentLightTexShader->setVec3("light.position", pointLight->position);
+                currentLightTexShader->setMat4("lightSpaceMat", pointLight->spaceMatrix);
+                currentLightTexShader->setVec3("light.ambient", pointLight->ambient);
+                currentLightTexShader->setVec3("light.diffuse", pointLight->diffuse);
+                currentLightTexShader->setVec3("light.specular", pointLight->specular);
+                currentLightTexShader->setFloat("light.constant", pointLight->constant);
+                currentLightTexShader->setFloat("light.linear", pointLight->linear);
+                currentLightTexShader->setFloat("light.quadratic", pointLight->quadratic);
+                GLState::Get().ActiveTexture(GL_TEXTURE1);
+                GLState::Get().BindTexture(GL_TEXTURE_2D, pointLight->depthMap);
             }
             else if (currentLighting==ELightType::Directional)
             {
-                glBindTexture(GL_TEXTURE_2D, dirLight->depthMap);
-                depthDebugShader.setBool("orthographic", true);
-                depthDebugShader.setFloat("nearPlane", dirLight->nearPlane);
-                depthDebugShader.setFloat("farPlane", dirLight->farPlane);
+                currentLightTexShader->setVec3("light.direction", dirLight->direction);
+                currentLightTexShader->setVec3("light.position",  dirLight->position);
+                currentLightTexShader->setMat4("lightSpaceMat", dirLight->spaceMatrix);
+                currentLightTexShader->setVec3("light.ambient", dirLight->ambient);
+                currentLightTexShader->setVec3("light.diffuse", dirLight->diffuse);
+                currentLightTexShader->setVec3("light.specular", dirLight->specular);
+                GLState::Get().ActiveTexture(GL_TEXTURE1);
+                GLState::Get().BindTexture(GL_TEXTURE_2D, dirLight->depthMap);
             }
-            else if (currentLighting==ELightType::Spot) 
+            else if (currentLighting==ELightType::Spot)
             {
-                glBindTexture(GL_TEXTURE_2D, spotLight->depthMap);
-                depthDebugShader.setBool("orthographic", false);
-                depthDebugShader.setFloat("nearPlane", spotLight->nearPlane);
-                depthDebugShader.setFloat("farPlane", spotLight->farPlane);
+                currentLightTexShader->setVec3("light.position", spotLight->position);
+                currentLightTexShader->setVec3("light.direction", spotLight->direction);
+                currentLightTexShader->setMat4("lightSpaceMat", spotLight->spaceMatrix);
+                currentLightTexShader->setVec3("light.ambient", spotLight->ambient);
+                currentLightTexShader->setVec3("light.diffuse", spotLight->diffuse);
+                currentLightTexShader->setVec3("light.specular", spotLight->specular);
+                currentLightTexShader->setFloat("light.cutOff", spotLight->cutOff);
+                currentLightTexShader->setFloat("light.outerCutOff", spotLight->outerCutOff);
+                currentLightTexShader->setFloat("light.constant", spotLight->constant);
+                currentLightTexShader->setFloat("light.linear", spotLight->linear);
+                currentLightTexShader->setFloat("light.quadratic", spotLight->quadratic);
+                GLState::Get().ActiveTexture(GL_TEXTURE1);
+                GLState::Get().BindTexture(GL_TEXTURE_2D, spotLight->depthMap);	
+            }
+            // view/projection transformations
+            glm::mat4 projection = glm::perspective(glm::radians(camera.Zoom), (float)SCR_WIDTH / (float)SCR_HEIGHT, cameraNear, cameraFar);
+            cameraBlock.Upload(CameraBlock{ projection, camera.GetViewMatrix(), camera.Position });
+            for(auto& toRender: phongTexObjects) {
+                // material properties
+                currentLightTexShader->setVec3("material.ambient", toRender->ka);
+                currentLightTexShader->setVec3("material.diffuse", toRender->kd);
+                currentLightTexShader->setVec3("material.specular", toRender->ks); // specular lighting doesn't have full effect on this object's material
+                currentLightTexShader->setFloat("material.shininess", toRender->shininess);
+                currentLightTexShader->setModel(toRender->transform);
+                // bind textures on corresponding texture units
+                GLState::Get().ActiveTexture(GL_TEXTURE0);
+                GLState::Get().BindTexture(GL_TEXTURE_2D, toRender->textureId);
+                arena.Bind(toRender->geometry);
+                arena.Draw(toRender->geometry);
             }
-            glBindVertexArray(depthQuad->VAO);
-            glDrawElements(GL_TRIANGLES, depthQuad->indexCount, GL_UNSIGNED_INT, 0);
-        }
 
-        // glfw: swap buffers and poll IO events (keys pressed/released, mouse moved etc.)
-        // -------------------------------------------------------------------------------
-        glfwSwapBuffers(window);
-        glfwPollEvents();
-    }
+            // be sure to activate shader when setting uniforms/drawing objects
+            currentLightClrShader->use();
+            // light properties
+            if (currentLighting==ELightType::Point) {
+                currentLightClrShader->setVec3("light.position", pointLight->position);
+                currentLightClrShader->setMat4("lightSpaceMat", pointLight->spaceMatrix);
+                currentLightClrShader->setVec3("light.ambient", pointLight->ambient);
+                currentLightClrShader->setVec3("light.diffuse", pointLight->diffuse);
+                currentLightClrShader->setVec3("light.specular", pointLight->specular);
+                currentLightClrShader->setFloat("light.constant", pointLight->constant);
+                currentLightClrShader->setFloat("light.linear", pointLight->linear);
+                currentLightClrShader->setFloat("light.quadratic", pointLight->quadratic);
+                GLState::Get().ActiveTexture(GL_TEXTURE0);
+                GLState::Get().BindTexture(GL_TEXTURE_2D, pointLight->depthMap);
+            }
+            else if (currentLighting==ELightType::Directional)
+            {
+                currentLightClrShader->setVec3("light.direction", dirLight->direction);
+                currentLightClrShader->setVec3("light.position", dirLight->position);
+                currentLightClrShader->setMat4("lightSpaceMat", dirLight->spaceMatrix);
+                currentLightClrShader->setVec3("light.ambient", dirLight->ambient);
+                currentLightClrShader->setVec3("light.diffuse", dirLight->diffuse);
+                currentLightClrShader->setVec3("light.specular", dirLight->specular);
+                GLState::Get().ActiveTexture(GL_TEXTURE0);
+                GLState::Get().BindTexture(GL_TEXTURE_2D, dirLight->depthMap);
+            }
+            else if (currentLighting==ELightType::Spot)
+            {
+                currentLightClrShader->setVec3("light.position", spotLight->position);
+                currentLightClrShader->setVec3("light.direction", spotLight->direction);
+                currentLightClrShader->setMat4("lightSpaceMat", spotLight->spaceMatrix);
+                currentLightClrShader->setVec3("light.ambient", spotLight->ambient);
+                currentLightClrShader->setVec3("light.diffuse", spotLight->diffuse);
+                currentLightClrShader->setVec3("light.specular", spotLight->specular);
+                currentLightClrShader->setFloat("light.cutOff", spotLight->cutOff);
+                currentLightClrShader->setFloat("light.outerCutOff", spotLight->outerCutOff);
+                currentLightClrShader->setFloat("light.constant", spotLight->constant);
+                currentLightClrShader->setFloat("light.linear", spotLight->linear);
+                currentLightClrShader->setFloat("light.quadratic", spotLight->quadratic);
+                GLState::Get().ActiveTexture(GL_TEXTURE0);
+                GLState::Get().BindTexture(GL_TEXTURE_2D, spotLight->depthMap);	
+            }
+            for(auto& toRender: phongClrObjects) {
+                // material properties
+                currentLightClrShader->setVec3("material.ambient", toRender->ka);
+                currentLightClrShader->setVec3("material.diffuse", toRender->kd);
+                currentLightClrShader->setVec3("material.specular", toRender->ks); // specular lighting doesn't have full effect on this object's material
+                currentLightClrShader->setFloat("material.shininess", toRender->shininess);
+                currentLightClrShader->setVec3("color", toRender->color);
+                currentLightClrShader->setModel(toRender->transform);
+            
+                // bind textures on corresponding texture units
+                arena.Bind(toRender->geometry);
+                arena.Draw(toRender->geometry);
+            }
 
-    // optional: de-allocate all resources once they've outlived their purpose:
-    // ------------------------------------------------------------------------
-    for(auto& toRender: phongTexObjects) {
-        glDeleteVertexArrays(1, &toRender->VAO);
-        glDeleteBuffers(1, &toRender->VBO);
-    }
-    for(auto& toRender: phongClrObjects) {
-        glDeleteVertexArrays(1, &toRender->VAO);
-        glDeleteBuffers(1, &toRender->VBO);
-    }
-    for(auto& toRender: coloredObjects) {
-        glDeleteVertexArrays(1, &toRender->VAO);
-        glDeleteBuffers(1, &toRender->VBO);
+            lightCubeShader.use();
+            for(auto& toRender: coloredObjects) {
+
+                lightCubeShader.setVec3("Color", (currentLighting==ELightType::Point)?toRender->color:glm::vec3(0.0f));
+                lightCubeShader.setMat4("model", toRender->transform);
+                lightCubeShader.setMat4("model", toRender->transform);        
+                arena.Bind(toRender->geometry);
+                arena.Draw(toRender->geometry);
+            }
+
+            if (currentDepthMap != EDepthMap::None) {
+                depthDebugShader.use();
+                GLState::Get().ActiveTexture(GL_TEXTURE0);
+                if (currentLighting==ELightType::Point) 
+                {
+                    GLState::Get().BindTexture(GL_TEXTURE_2D, pointLight->depthMap);
+                    depthDebugShader.setBool("orthographic", false);
+                    depthDebugShader.setFloat("nearPlane", pointLight->nearPlane);
+                    depthDebugShader.setFloat("farPlane", pointLight->farPlane);
+                }
+                else if (currentLighting==ELightType::Directional)
+                {
+                    GLState::Get().BindTexture(GL_TEXTURE_2D, dirLight->depthMap);
+                    depthDebugShader.setBool("orthographic", true);
+                    depthDebugShader.setFloat("nearPlane", dirLight->nearPlane);
+                    depthDebugShader.setFloat("farPlane", dirLight->farPlane);
+                }
+                else if (currentLighting==ELightType::Spot) 
+                {
+                    GLState::Get().BindTexture(GL_TEXTURE_2D, spotLight->depthMap);
+                    depthDebugShader.setBool("orthographic", false);
+                    depthDebugShader.setFloat("nearPlane", spotLight->nearPlane);
+                    depthDebugShader.setFloat("farPlane", spotLight->farPlane);
+                }
+                arena.Bind(depthQuad->geometry);
+                arena.Draw(depthQuad->geometry);
+            }
+
+            // glfw: swap buffers and poll IO events (keys pressed/released, mouse moved etc.)
+            // -------------------------------------------------------------------------------
+            glfwSwapBuffers(window);
+            glfwPollEvents();
+        }
+
+        // optional: de-allocate all resources once they've outlived their purpose:
+        // ------------------------------------------------------------------------
+        for(auto& toRender: phongTexObjects) {
+            arena.Free(toRender->geometry);
+        }
+        for(auto& toRender: phongClrObjects) {
+            arena.Free(toRender->geometry);
+        }
+        for(auto& toRender: coloredObjects) {
+            arena.Free(toRender->geometry);
+        }
+        arena.Free(depthQuad->geometry);
     }
 
     // glfw: terminate, clearing all previously allocated GLFW resources.
@@ -775,7 +778,6 @@ void scroll_callback(GLFWwindow* window, double xoffset, double yoffset)
 RenderObjectPtr createTexCube(string path, float texScale, glm::vec3 ka, glm::vec3 kd, glm::vec3 ks, float shnss)
 {
     RenderObjectPtr cubeObject = make_shared<RenderObject>();
-    unsigned int cubeEBO;
     float vertices[] = {
         -0.5f, -0.5f, -0.5f,  0.0f,  0.0f, -1.0f, 0.0f, texScale,
          0.5f, -0.5f, -0.5f,  0.0f,  0.0f, -1.0f, texScale, texScale,
@@ -815,51 +817,13 @@ RenderObjectPtr createTexCube(string path, float texScale, glm::vec3 ka, glm::ve
         16, 17, 18,  18, 19, 16,
         20, 22, 21,  22, 20, 23        
     };
-    glGenVertexArrays(1, &cubeObject->VAO);
-    glGenBuffers(1, &cubeObject->VBO);
-    glGenBuffers(1, &cubeEBO);
-    // bind the Vertex Array Object first, then bind and set vertex buffer(s), and then configure vertex attributes(s).
-    glBindVertexArray(cubeObject->VAO);
-    glBindBuffer(GL_ARRAY_BUFFER, cubeObject->VBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, cubeEBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-
-    // position attribute
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-    // normal attribute
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
-    // texture coord attribute
-    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(6 * sizeof(float)));
-    glEnableVertexAttribArray(2);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
-    // load and create a texture 
-    glGenTextures(1, &cubeObject->textureId);
-    glBindTexture(GL_TEXTURE_2D, cubeObject->textureId);
-    // set the texture wrapping parameters
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-    // set texture filtering parameters
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    // load image, create texture and generate mipmaps
-    int width, height, nrChannels;
-    unsigned char* data = stbi_load(getPath(path).string().c_str(), &width, &height, &nrChannels, 0);
-    if (data)
-    {
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
-        glGenerateMipmap(GL_TEXTURE_2D);
-    }
-    else
-    {
-        std::cout << "Failed to load texture" << std::endl;
-    }
-    stbi_image_free(data);
+    cubeObject->geometry = GeometryArena::Get().Allocate(VertexFormat::Floats({ 3, 3, 2 }), vertices, 24, indices, 36);
+    // load and create a texture, shared with every other cube using the same image
+    TextureSettings textureSettings;
+    textureSettings.minFilter = GL_LINEAR;
+    textureSettings.channels = 4;
+    cubeObject->textureId = TextureCache::Get().Load(getPath(path).string(), textureSettings);
     cubeObject->transform = glm::mat4(1.0f);
-    cubeObject->indexCount = 36;
     cubeObject->ka = ka;
     cubeObject->kd = kd;
     cubeObject->ks = ks;
@@ -870,7 +834,6 @@ RenderObjectPtr createTexCube(string path, float texScale, glm::vec3 ka, glm::ve
 RenderObjectPtr createClrCube(glm::vec3 color, glm::vec3 ka, glm::vec3 kd, glm::vec3 ks, float shnss)
 {
     RenderObjectPtr cubeObject = make_shared<RenderObject>();
-    unsigned int cubeEBO;
     float vertices[] = {
         -0.5f, -0.5f, -0.5f,  0.0f,  0.0f, -1.0f,
          0.5f, -0.5f, -0.5f,  0.0f,  0.0f, -1.0f,
@@ -910,26 +873,8 @@ RenderObjectPtr createClrCube(glm::vec3 color, glm::vec3 ka, glm::vec3 kd, glm::
         16, 17, 18,  18, 19, 16,
         20, 22, 21,  22, 20, 23            
     };
-    glGenVertexArrays(1, &cubeObject->VAO);
-    glGenBuffers(1, &cubeObject->VBO);
-    glGenBuffers(1, &cubeEBO);
-    // bind the Vertex Array Object first, then bind and set vertex buffer(s), and then configure vertex attributes(s).
-    glBindVertexArray(cubeObject->VAO);
-    glBindBuffer(GL_ARRAY_BUFFER, cubeObject->VBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, cubeEBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-
-    // position attribute
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-    // normal attribute
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
+    cubeObject->geometry = GeometryArena::Get().Allocate(VertexFormat::Floats({ 3, 3 }), vertices, 24, indices, 36);
     cubeObject->transform = glm::mat4(1.0f);
-    cubeObject->indexCount = 36;
     cubeObject->ka = ka;
     cubeObject->kd = kd;
     cubeObject->ks = ks;
@@ -984,16 +929,11 @@ RenderObjectPtr createLightCube(glm::vec3 pos)
         -0.5f,  0.5f, -0.5f,  0.0f,  1.0f,  0.0f,
         -0.5f,  0.5f,  0.5f,  0.0f,  1.0f,  0.0f
     };
-    // first, configure the cube's VAO (and VBO)
-    glGenVertexArrays(1, &lightObject->VAO);
-    glGenBuffers(1, &lightObject->VBO);
-    glBindBuffer(GL_ARRAY_BUFFER, lightObject->VBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
-    glBindVertexArray(lightObject->VAO);
-    // note that we update the lamp's position attribute's stride to reflect the updated buffer data
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-    lightObject->indexCount = 36;
+    // not indexed: every vertex is used once, in order
+    unsigned int indices[36];
+    for (unsigned int i = 0; i < 36; i++)
+        indices[i] = i;
+    lightObject->geometry = GeometryArena::Get().Allocate(VertexFormat::Floats({ 3, 3 }), vertices, 36, indices, 36);
     lightObject->transform = glm::translate(glm::mat4(1.0f), pos);
     lightObject->transform = glm::scale(lightObject->transform, glm::vec3(0.2f)); // a smaller cube;
     lightObject->color = glm::vec3(1.0f);
@@ -1003,7 +943,6 @@ RenderObjectPtr createLightCube(glm::vec3 pos)
 RenderObjectPtr createTexQuad()
 {
     RenderObjectPtr cubeObject = make_shared<RenderObject>();
-    unsigned int cubeEBO;
     float vertices[] = {
         -1.0f, -1.0f, 0.0f,  0.0f, 0.0f,
          1.0f, -1.0f, 0.0f,  1.0f, 0.0f,
@@ -1013,26 +952,8 @@ RenderObjectPtr createTexQuad()
     unsigned int indices[] = {
         0, 1, 2,     2, 3, 0  
     };
-    glGenVertexArrays(1, &cubeObject->VAO);
-    glGenBuffers(1, &cubeObject->VBO);
-    glGenBuffers(1, &cubeEBO);
-    // bind the Vertex Array Object first, then bind and set vertex buffer(s), and then configure vertex attributes(s).
-    glBindVertexArray(cubeObject->VAO);
-    glBindBuffer(GL_ARRAY_BUFFER, cubeObject->VBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, cubeEBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-
-    // position attribute
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-    // texture coord attribute
-    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
+    cubeObject->geometry = GeometryArena::Get().Allocate(VertexFormat::Floats({ 3, 2 }), vertices, 4, indices, 6);
     cubeObject->transform = glm::mat4(1.0f);
     //cubeObject->transform = glm::scale(glm::mat4(1.0f), glm::vec3(2.0f*(float)SCR_HEIGHT/(float)SCR_WIDTH, 2.0f, 1.0f));
-    cubeObject->indexCount = 6;
     return cubeObject;
 }
\ No newline at end of file
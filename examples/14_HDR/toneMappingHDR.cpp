@@ -10,6 +10,10 @@
 #include <glm/gtx/transform.hpp>
 
 #include "shaders/shader.hpp"
+#include "glState.hpp"
+#include "geometryArena.hpp"
+#include "uniformBlocks.hpp"
+#include "textureCache.hpp"
 #include "root_directory.h"
 #include "cameras/cameraFirstPerson.hpp"
 #include "performanceMonitor.hpp"
@@ -38,8 +42,8 @@ float deltaTime = 0.0f;
 float lastFrame = 0.0f;
 
 struct RenderObject {
-    unsigned int VAO, VBO;
-    unsigned indexCount;
+    // range of the object's vertices and indices in the geometry arena
+    GeometryHandle geometry;
     glm::mat4 transform;
     unsigned int textureId;
     glm::vec3 ka, kd, ks, color;
@@ -154,483 +158,440 @@ int main()
         return -1;
     }
 
-    // configure global opengl state
-    // -----------------------------
-    glEnable(GL_DEPTH_TEST);
-
-    // build and compile our shader zprogram
-    // ------------------------------------
-    Shader lightCubeShader(getPath("source/shaders/colorMVPShader.vs").string().c_str(), 
-                           getPath("source/shaders/colorMVPShader.fs").string().c_str() );
-    Shader* lightClrShader = new Shader();
-    Shader* lightTexShader = new Shader();
-    Shader hdrShader(getPath("source/shaders/HDRShader.vs").string().c_str(), 
-                           getPath("source/shaders/HDRShader.fs").string().c_str() );
+    // everything that owns GL objects lives in this scope and is destroyed before glfwTerminate()
+    {
+        // configure global opengl state
+        // -----------------------------
+        glEnable(GL_DEPTH_TEST);
+
+        // build and compile our shader zprogram
+        // ------------------------------------
+        Shader lightCubeShader(getPath("source/shaders/colorMVPShader.vs").string().c_str(), 
+                               getPath("source/shaders/colorMVPShader.fs").string().c_str() );
+        Shader hdrShader(getPath("source/shaders/HDRShader.vs").string().c_str(), 
+                               getPath("source/shaders/HDRShader.fs").string().c_str() );
      
     
-    // CONFIGURE FLOATING POINT FRAMEBUFFER
-    unsigned int hdrFBO;
-    glGenFramebuffers(1, &hdrFBO);
-    // create floating point color buffer
-    unsigned int colorBuffer;
-    glGenTextures(1, &colorBuffer);
-    glBindTexture(GL_TEXTURE_2D, colorBuffer);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, SCR_WIDTH, SCR_HEIGHT, 0, GL_RGBA, GL_FLOAT, NULL);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    // create depth buffer (renderbuffer)
-    unsigned int rboDepth;
-    glGenRenderbuffers(1, &rboDepth);
-    glBindRenderbuffer(GL_RENDERBUFFER, rboDepth);
-    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT, SCR_WIDTH, SCR_HEIGHT);
-    // attach buffers
-    glBindFramebuffer(GL_FRAMEBUFFER, hdrFBO);
-    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, colorBuffer, 0);
-    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, rboDepth);
-    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
-        std::cout << "Framebuffer not complete!" << std::endl;
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
-
-
-    // LIGHTS SETTING
-
-    PointLights pointLights;
-
-    shared_ptr<PointLight> pLight1 = make_shared<PointLight>();
-    pLight1->position = glm::vec3(1.2f, 1.5f, 3.0f);
-    pLight1->ambient = glm::vec3(0.0f);
-    pLight1->diffuse = glm::vec3(1.0f);
-    pLight1->specular = glm::vec3(1.0f);
-    pLight1->constant = 1.0f;
-    pLight1->linear = 0.09f;
-    pLight1->quadratic = 0.032f;
-    pointLights.push_back(pLight1);
-    shared_ptr<PointLight> pLight2 = make_shared<PointLight>();
-    pLight2->position = glm::vec3(2.2f, 0.7f, -3.0f);
-    pLight2->ambient = glm::vec3(0.0f);
-    pLight2->diffuse = glm::vec3(2.0f, 0.5f, 0.0f);
-    pLight2->specular = glm::vec3(1.0f, 0.5f, 0.0f);
-    pLight2->constant = 1.0f;
-    pLight2->linear = 0.09f;
-    pLight2->quadratic = 0.032f;
-    pointLights.push_back(pLight2);
-    shared_ptr<PointLight> pLight3 = make_shared<PointLight>();
-    pLight3->position = glm::vec3(-2.5f, 3.5f, 0.0f);
-    pLight3->ambient = glm::vec3(0.0f);
-    pLight3->diffuse = glm::vec3(0.2f, 1.0f, 0.0f);
-    pLight3->specular = glm::vec3(0.2f, 1.0f, 0.0f);
-    pLight3->constant = 1.0f;
-    pLight3->linear = 0.09f;
-    pLight3->quadratic = 0.032f;
-    pointLights.push_back(pLight3);
-
-
-    DirectionalLights dirLights;
-
-    shared_ptr<DirectionalLight> dLight1 = make_shared<DirectionalLight>();
-    dLight1->direction = glm::vec3(1.0f, -1.0f, 0.0f);
-    dLight1->ambient = glm::vec3(0.3f);
-    dLight1->diffuse = glm::vec3(1.0f);
-    dLight1->specular = glm::vec3(1.0f);
-    dirLights.push_back(dLight1);
-    shared_ptr<DirectionalLight> dLight2 = make_shared<DirectionalLight>();
-    dLight2->direction = glm::vec3(0.0f, -1.0f, 0.0f);
-    dLight2->ambient = glm::vec3(0.2f, 0.15f, 0.0f);
-    dLight2->diffuse = glm::vec3(0.8f, 0.6f, 0.0f);
-    dLight2->specular = glm::vec3(0.8f, 0.6f, 0.0f);
-    dirLights.push_back(dLight2);
-    shared_ptr<DirectionalLight> dLight3 = make_shared<DirectionalLight>();
-    dLight3->direction = glm::vec3(-0.2f, -0.6f, 0.5f);
-    dLight3->ambient = glm::vec3(0.07f, 0.07f, 0.1f);
-    dLight3->diffuse = glm::vec3(0.4f, 0.2f, 0.6f);
-    dLight3->specular = glm::vec3(0.1f, 0.1f, 0.15f);
-    dirLights.push_back(dLight3);
-
-
-    SpotLights spotLights;
-
-    shared_ptr<SpotLight> sLight1 = make_shared<SpotLight>();
-    sLight1->position = glm::vec3(4.0f, 3.0f, 0.0f);
-    sLight1->direction = glm::vec3(1.0f, -1.0f, 0.0f);
-    sLight1->cutOff = glm::cos(glm::radians(10.5f));
-    sLight1->outerCutOff = glm::cos(glm::radians(15.5f));
-    sLight1->ambient = glm::vec3(0.0f);
-    sLight1->diffuse = glm::vec3(1.0f, 0.7f, 0.7f);
-    sLight1->specular = glm::vec3(0.1f, 0.07f, 0.07f);
-    sLight1->constant = 1.0f;
-    sLight1->linear = 0.09f;
-    sLight1->quadratic = 0.032f;
-    spotLights.push_back(sLight1);
-    shared_ptr<SpotLight> sLight2 = make_shared<SpotLight>();
-    sLight2->position = glm::vec3(-3.5f, 3.5f, -3.5f);
-    sLight2->direction = glm::vec3(1.0f, -1.0f, 1.0f);
-    sLight2->cutOff = glm::cos(glm::radians(25.5f));
-    sLight2->outerCutOff = glm::cos(glm::radians(30.5f));
-    sLight2->ambient = glm::vec3(0.0f);
-    sLight2->diffuse = glm::vec3(1.0f, 1.0f, 0.0f);
-    sLight2->specular = glm::vec3(1.0f, 1.0f, 0.0f);
-    sLight2->constant = 0.5f;
-    sLight2->linear = 0.03f;
-    sLight2->quadratic = 0.005f;
-    spotLights.push_back(sLight2);
-    shared_ptr<SpotLight> sLight3 = make_shared<SpotLight>();
-    sLight3->position = glm::vec3(5.0f, 6.5f, -4.0f);
-    sLight3->direction = glm::vec3(0.0f, -1.0f, 0.0f);
-    sLight3->cutOff = glm::cos(glm::radians(16.0f));
-    sLight3->outerCutOff = glm::cos(glm::radians(20.0f));
-    sLight3->ambient = glm::vec3(0.0f);
-    sLight3->diffuse = glm::vec3(0.0f, 0.5f, 1.0f);
-    sLight3->specular = glm::vec3(0.0f, 1.0f, 1.0f);
-    sLight3->constant = 1.0f;
-    sLight3->linear = 0.09f;
-    sLight3->quadratic = 0.032f;
-    spotLights.push_back(sLight3);
-    shared_ptr<SpotLight> sLight4 = make_shared<SpotLight>();
-    sLight4->position = glm::vec3(1.0f);
-    sLight4->direction = glm::vec3(0.0f, -1.0f, 0.0f);
-    sLight4->cutOff = glm::cos(glm::radians(12.5f));
-    sLight4->outerCutOff = glm::cos(glm::radians(17.5f));
-    sLight4->ambient = glm::vec3(0.0f);
-    sLight4->diffuse = glm::vec3(1.0f);
-    sLight4->specular = glm::vec3(1.0f);
-    sLight4->constant = 0.5f;
-    sLight4->linear = 0.02f;
-    sLight4->quadratic = 0.002f;
-    spotLights.push_back(sLight4);
-
-    // Init the shaders with the exact number of lights
-    lightClrShader->StartUp(getPath("source/shaders/MultipleLightClrShader.vs").string().c_str(), 
-                               getPath("source/shaders/MultipleLightClrShader.fs").string().c_str(),
-                               dirLights.size(), pointLights.size(), spotLights.size());
-    lightTexShader->StartUp(getPath("source/shaders/MultipleLightTexShader.vs").string().c_str(), 
-                               getPath("source/shaders/MultipleLightTexShader.fs").string().c_str(),
-                               dirLights.size(), pointLights.size(), spotLights.size());    
-
-    // Render batches
-    RenderBatch phongTexObjects;
-    RenderBatch phongClrObjects;
-
-    hdrShader.use();
-    hdrShader.setInt("hdrBuffer", 0);
-
-    // Phong textured objects
-    RenderObjectPtr floor = createTexCube("assets/wood.png", 5.0f);
-    floor->transform = glm::translate(floor->transform, glm::vec3(0.0f, -8.0f, 0.0f));
-    floor->transform = glm::scale(floor->transform, glm::vec3(16.0f));
-    phongTexObjects.push_back(floor);
-    RenderObjectPtr box = createTexCube("assets/box.png", 1.0f);
-    box->transform = glm::translate(box->transform, glm::vec3(5.0f, 2.0f, 4.0f));
-    box->transform = glm::rotate(box->transform, glm::radians(45.0f), glm::vec3(0.0f, 1.0f, 0.0f));
-    box->transform = glm::scale(box->transform, glm::vec3(1.0f));
-    phongTexObjects.push_back(box);
-
-    // Phong colored objects
-    RenderObjectPtr wall = createClrCube(glm::vec3(1.0f, 0.5f, 0.0f));
-    wall->transform = glm::translate(wall->transform, glm::vec3(16.0f, 0.0f, 0.0f));
-    wall->transform = glm::scale(wall->transform, glm::vec3(16.0f));
-    phongClrObjects.push_back(wall);
-    RenderObjectPtr jumpingBox = createClrCube(glm::vec3(0.0f, 0.0f, 1.0f));
-    phongClrObjects.push_back(jumpingBox);
-    RenderObjectPtr rotBox = createClrCube(glm::vec3(0.2f, 1.0f, 0.0f));
-    phongClrObjects.push_back(rotBox);
-
-    // light Objects
-    RenderObjectPtr lightCube = createLightCube();
-    RenderObjectPtr LightPrism = createLightPrism();
-    RenderObjectPtr lightCylinder = createLightCylinder();
-
-    PerformanceMonitor pMonitor(glfwGetTime(), 0.5f);
-
-    // Setup Dear ImGui context
-    IMGUI_CHECKVERSION();
-    ImGui::CreateContext();
-    ImGuiIO& io = ImGui::GetIO(); (void)io;
-    // Setup Dear ImGui style
-    ImGui::StyleColorsDark();
-    // GL 3.0 + GLSL 130
-    const char* glsl_version = "#version 130";
-    // Setup Platform/Renderer backends
-    ImGui_ImplGlfw_InitForOpenGL(window, true);
-    ImGui_ImplOpenGL3_Init(glsl_version);
-
-    bool hdr = true;
-    float gamma = 2.2;
-    float exposure = 1.0f;
-
-    // render loop
-    // -----------
-    while (!glfwWindowShouldClose(window))
-    {
-        // per-frame time logic
-        // --------------------
-        float currentFrame = glfwGetTime();
-        deltaTime = currentFrame - lastFrame;
-        lastFrame = currentFrame;
-
-        pMonitor.update(glfwGetTime());
-        stringstream ss;
-        ss << title << " " << pMonitor;
-        glfwSetWindowTitle(window, ss.str().c_str());
-
-        // input
-        // -----
-        processInput(window);
-
-        
-
-        // refreshing the transforms
-        jumpingBox->transform = glm::translate(glm::mat4(1.0f), 
-                                    glm::vec3(0.0f, 
-                                            glm::abs(glm::sin(glfwGetTime()*1.2f)*4.0f), 
-                                            0.0f));
-        jumpingBox->transform = glm::translate(jumpingBox->transform, glm::vec3(5.0f, 0.6f, -4.0f));
-        jumpingBox->transform = glm::scale(jumpingBox->transform, glm::vec3(1.2f));
-        rotBox->transform = glm::translate(glm::mat4(1.0f), glm::vec3(-4.0f, 2.5f, 0.0f));
-        rotBox->transform = glm::rotate(rotBox->transform, (float)glfwGetTime()*1.0f, 
-                                        glm::vec3(1.0f, 0.0f, 0.0f));
-        rotBox->transform = glm::rotate(rotBox->transform, (float)glfwGetTime()*1.0f, 
-                                        glm::vec3(0.0f, 1.0f, 0.0f));
-        rotBox->transform = glm::rotate(rotBox->transform, (float)glfwGetTime()*1.0f, 
-                                        glm::vec3(0.0f, 0.0f, 1.0f));
-        rotBox->transform = glm::scale(rotBox->transform, glm::vec3(1.2f, 1.2f, 4.0f));
-        
-        spotLights[3]->position = camera.Position +
-                                    camera.Right * 0.5f +
-                                    camera.Front * 1.5f + 
-                                    camera.Up * -0.5f;
-        spotLights[3]->direction = camera.Front;
-
-        // render
-        // ------
-        glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-
-        // ------- 1. RENDER SCENE INTO FLOATING POINT FRAMEBUFFER  ----------
+        // CONFIGURE FLOATING POINT FRAMEBUFFER
+        unsigned int hdrFBO;
+        glGenFramebuffers(1, &hdrFBO);
+        // create floating point color buffer
+        unsigned int colorBuffer;
+        glGenTextures(1, &colorBuffer);
+        GLState::Get().BindTexture(GL_TEXTURE_2D, colorBuffer);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, SCR_WIDTH, SCR_HEIGHT, 0, GL_RGBA, GL_FLOAT, NULL);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        // create depth buffer (renderbuffer)
+        unsigned int rboDepth;
+        glGenRenderbuffers(1, &rboDepth);
+        glBindRenderbuffer(GL_RENDERBUFFER, rboDepth);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT, SCR_WIDTH, SCR_HEIGHT);
+        // attach buffers
         glBindFramebuffer(GL_FRAMEBUFFER, hdrFBO);
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-
-        // be sure to activate shader when setting uniforms/drawing objects
-        lightTexShader->use();
-        
-        // view/projection transformations
-        lightTexShader->setVec3("viewPos", camera.Position);
-        glm::mat4 projection = glm::perspective(glm::radians(camera.Zoom), (float)SCR_WIDTH / (float)SCR_HEIGHT, 0.1f, 100.0f);
-        lightTexShader->setMat4("projection", projection);
-        lightTexShader->setMat4("view", camera.GetViewMatrix());
-
-        // Directional Lights
-        for (int i = 0; i < dirLights.size(); i++) {
-            string number = to_string(i);
-            lightTexShader->setVec3("dirLights["+ number + "].direction", dirLights[i]->direction);
-            lightTexShader->setVec3("dirLights["+ number + "].ambient", dirLights[i]->ambient);
-            lightTexShader->setVec3("dirLights["+ number + "].diffuse", dirLights[i]->diffuse);
-            lightTexShader->setVec3("dirLights["+ number + "].specular", dirLights[i]->specular);
-            lightTexShader->setBool("dirLights["+ number + "].on", lightsState[i]);
-        }
-        // Point Lights
-        for (int i = 0; i < pointLights.size(); i++) {
-            string number = to_string(i);
-            lightTexShader->setVec3("pointLights["+ number + "].position", pointLights[i]->position);
-            lightTexShader->setVec3("pointLights["+ number + "].ambient", pointLights[i]->ambient);
-            lightTexShader->setVec3("pointLights["+ number + "].diffuse", pointLights[i]->diffuse);
-            lightTexShader->setVec3("pointLights["+ number + "].specular", pointLights[i]->specular);
-            lightTexShader->setFloat("pointLights["+ number + "].constant", pointLights[i]->constant);
-            lightTexShader->setFloat("pointLights["+ number + "].linear", pointLights[i]->linear);
-            lightTexShader->setFloat("pointLights["+ number + "].quadratic", pointLights[i]->quadratic);
-            lightTexShader->setBool("pointLights["+ number + "].on", lightsState[i+3]);
-        }
-        // Spot Lights
-        for (int i = 0; i < spotLights.size(); i++) {
-            string number = to_string(i);
-            lightTexShader->setVec3("spotLights["+ number + "].position", spotLights[i]->position);
-            lightTexShader->setVec3("spotLights["+ number + "].direction", spotLights[i]->direction);
-            lightTexShader->setVec3("spotLights["+ number + "].ambient", spotLights[i]->ambient);
-            lightTexShader->setVec3("spotLights["+ number + "].diffuse", spotLights[i]->diffuse);
-            lightTexShader->setVec3("spotLights["+ number + "].specular", spotLights[i]->specular);
-            lightTexShader->setFloat("spotLights["+ number + "].cutOff", spotLights[i]->cutOff);
-            lightTexShader->setFloat("spotLights["+ number + "].outerCutOff", spotLights[i]->outerCutOff);
-            lightTexShader->setFloat("spotLights["+ number + "].constant", spotLights[i]->constant);
-            lightTexShader->setFloat("spotLights["+ number + "].linear", spotLights[i]->linear);
-            lightTexShader->setFloat("spotLights["+ number + "].quadratic", spotLights[i]->quadratic);
-            lightTexShader->setBool("spotLights["+ number + "].on", lightsState[i+6]);	
-        }
-        // Render Textured Objects
-        for(auto& toRender: phongTexObjects) {
-            // material properties
-            lightTexShader->setVec3("material.ambient", toRender->ka);
-            lightTexShader->setVec3("material.diffuse", toRender->kd);
-            lightTexShader->setVec3("material.specular", toRender->ks);
-            lightTexShader->setFloat("material.shininess", toRender->shininess);
-            lightTexShader->setMat4("model", toRender->transform);
-            // bind textures on corresponding texture units
-            glBindTexture(GL_TEXTURE_2D, toRender->textureId);
-            glBindVertexArray(toRender->VAO);
-            glDrawElements(GL_TRIANGLES, toRender->indexCount, GL_UNSIGNED_INT, 0);
-        }
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, colorBuffer, 0);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, rboDepth);
+        if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+            std::cout << "Framebuffer not complete!" << std::endl;
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
 
-        // be sure to activate shader when setting uniforms/drawing objects
-        lightClrShader->use();
-
-        // view/projection transformations
-        lightClrShader->setVec3("viewPos", camera.Position);
-        lightClrShader->setMat4("projection", projection);
-        lightClrShader->setMat4("view", camera.GetViewMatrix());
-
-        // Directional Lights
-        for (int i = 0; i < dirLights.size(); i++) {
-            string number = to_string(i);
-            lightClrShader->setVec3("dirLights["+ number + "].direction", dirLights[i]->direction);
-            lightClrShader->setVec3("dirLights["+ number + "].ambient", dirLights[i]->ambient);
-            lightClrShader->setVec3("dirLights["+ number + "].diffuse", dirLights[i]->diffuse);
-            lightClrShader->setVec3("dirLights["+ number + "].specular", dirLights[i]->specular);
-            lightClrShader->setBool("dirLights["+ number + "].on", lightsState[i]);
-        }
-        // Point Lights
-        for (int i = 0; i < pointLights.size(); i++) {
-            string number = to_string(i);
-            lightClrShader->setVec3("pointLights["+ number + "].position", pointLights[i]->position);
-            lightClrShader->setVec3("pointLights["+ number + "].ambient", pointLights[i]->ambient);
-            lightClrShader->setVec3("pointLights["+ number + "].diffuse", pointLights[i]->diffuse);
-            lightClrShader->setVec3("pointLights["+ number + "].specular", pointLights[i]->specular);
-            lightClrShader->setFloat("pointLights["+ number + "].constant", pointLights[i]->constant);
-            lightClrShader->setFloat("pointLights["+ number + "].linear", pointLights[i]->linear);
-            lightClrShader->setFloat("pointLights["+ number + "].quadratic", pointLights[i]->quadratic);
-            lightClrShader->setBool("pointLights["+ number + "].on", lightsState[i+3]);
-        }
-        // Spot Lights
-        for (int i = 0; i < spotLights.size(); i++) {
-            string number = to_string(i);
-            lightClrShader->setVec3("spotLights["+ number + "].position", spotLights[i]->position);
-            lightClrShader->setVec3("spotLights["+ number + "].direction", spotLights[i]->direction);
-            lightClrShader->setVec3("spotLights["+ number + "].ambient", spotLights[i]->ambient);
-            lightClrShader->setVec3("spotLights["+ number + "].diffuse", spotLights[i]->diffuse);
-            lightClrShader->setVec3("spotLights["+ number + "].specular", spotLights[i]->specular);
-            lightClrShader->setFloat("spotLights["+ number + "].cutOff", spotLights[i]->cutOff);
-            lightClrShader->setFloat("spotLights["+ number + "].outerCutOff", spotLights[i]->outerCutOff);
-            lightClrShader->setFloat("spotLights["+ number + "].constant", spotLights[i]->constant);
-            lightClrShader->setFloat("spotLights["+ number + "].linear", spotLights[i]->linear);
-            lightClrShader->setFloat("spotLights["+ number + "].quadratic", spotLights[i]->quadratic);
-            lightClrShader->setBool("spotLights["+ number + "].on", lightsState[i+6]);	
-        }
-        // Render Colored Objects
-        for(auto& toRender: phongClrObjects) {
-            // material properties
-            lightClrShader->setVec3("material.ambient", toRender->ka);
-            lightClrShader->setVec3("material.diffuse", toRender->kd);
-            lightClrShader->setVec3("material.specular", toRender->ks); 
-            lightClrShader->setFloat("material.shininess", toRender->shininess);
-            lightClrShader->setVec3("color", toRender->color);
-            lightClrShader->setMat4("model", toRender->transform);
-            // bind textures on corresponding texture units
-            glBindVertexArray(toRender->VAO);
-            glDrawElements(GL_TRIANGLES, toRender->indexCount, GL_UNSIGNED_INT, 0);
-        }
 
-        lightCubeShader.use();
-        lightCubeShader.setMat4("projection", projection);
-        lightCubeShader.setMat4("view", camera.GetViewMatrix());
-        int c = 0;
-        for(auto& light: dirLights) {
-
-            lightCubeShader.setVec3("Color", (lightsState[c])?light->diffuse:glm::vec3(0.0f));
-            glm::mat4 lightTr = glm::translate(glm::mat4(1.0f), light->direction * -5.0f);
-            lightTr = lightTr * rotateFromTo(light->direction, glm::vec3(0.0f, -1.0f, 0.0f));
-            lightTr = glm::scale(lightTr, glm::vec3(0.3f, 0.6f, 0.3f));
-            lightCubeShader.setMat4("model", lightTr);      
-            glBindVertexArray(lightCylinder->VAO);
-            glDrawElements(GL_TRIANGLES, lightCylinder->indexCount, GL_UNSIGNED_INT, 0);
-            c++;
-        }
-        c = 3;
-        for(auto& light: pointLights) {
-
-            lightCubeShader.setVec3("Color", (lightsState[c])?light->diffuse:glm::vec3(0.0f));
-            glm::mat4 lightTr = glm::translate(glm::mat4(1.0f), light->position);
-            lightTr = glm::scale(lightTr, glm::vec3(0.3f));
-            lightCubeShader.setMat4("model", lightTr);      
-            glBindVertexArray(lightCube->VAO);
-            glDrawElements(GL_TRIANGLES, lightCube->indexCount, GL_UNSIGNED_INT, 0);
-            c++;
-        }
-        c = 6;
-        for(auto& light: spotLights) {
-
-            lightCubeShader.setVec3("Color", (lightsState[c])?light->diffuse:glm::vec3(0.0f));
-            glm::mat4 lightTr = glm::translate(glm::mat4(1.0f), light->position);
-            lightTr = lightTr * rotateFromTo(light->direction, glm::vec3(0.0f, -1.0f, 0.0f));
-            lightTr = glm::scale(lightTr, glm::vec3(0.3f, 0.6f, 0.3f));
-            lightCubeShader.setMat4("model", lightTr);      
-            glBindVertexArray(LightPrism->VAO);
-            glDrawElements(GL_TRIANGLES, LightPrism->indexCount, GL_UNSIGNED_INT, 0);
-            c++;
-        }
+        // LIGHTS SETTING
+
+        PointLights pointLights;
+
+        shared_ptr<PointLight> pLight1 = make_shared<PointLight>();
+        pLight1->position = glm::vec3(1.2f, 1.5f, 3.0f);
+        pLight1->ambient = glm::vec3(0.0f);
+        pLight1->diffuse = glm::vec3(1.0f);
+        pLight1->specular = glm::vec3(1.0f);
+        pLight1->constant = 1.0f;
+        pLight1->linear = 0.09f;
+        pLight1->quadratic = 0.032f;
+        pointLights.push_back(pLight1);
+        shared_ptr<PointLight> pLight2 = make_shared<PointLight>();
+        pLight2->position = glm::vec3(2.2f, 0.7f, -3.0f);
+        pLight2->ambient = glm::vec3(0.0f);
+        pLight2->diffuse = glm::vec3(2.0f, 0.5f, 0.0f);
+        pLight2->specular = glm::vec3(1.0f, 0.5f, 0.0f);
+        pLight2->constant = 1.0f;
+        pLight2->linear = 0.09f;
+        pLight2->quadratic = 0.032f;
+        pointLights.push_back(pLight2);
+        shared_ptr<PointLight> pLight3 = make_shared<PointLight>();
+        pLight3->position = glm::vec3(-2.5f, 3.5f, 0.0f);
+        pLight3->ambient = glm::vec3(0.0f);
+        pLight3->diffuse = glm::vec3(0.2f, 1.0f, 0.0f);
+        pLight3->specular = glm::vec3(0.2f, 1.0f, 0.0f);
+        pLight3->constant = 1.0f;
+        pLight3->linear = 0.09f;
+        pLight3->quadratic = 0.032f;
+        pointLights.push_back(pLight3);
+
+
+        DirectionalLights dirLights;
+
+        shared_ptr<DirectionalLight> dLight1 = make_shared<DirectionalLight>();
+        dLight1->direction = glm::vec3(1.0f, -1.0f, 0.0f);
+        dLight1->ambient = glm::vec3(0.3f);
+        dLight1->diffuse = glm::vec3(1.0f);
+        dLight1->specular = glm::vec3(1.0f);
+        dirLights.push_back(dLight1);
+        shared_ptr<DirectionalLight> dLight2 = make_shared<DirectionalLight>();
+        dLight2->direction = glm::vec3(0.0f, -1.0f, 0.0f);
+        dLight2->ambient = glm::vec3(0.2f, 0.15f, 0.0f);
+        dLight2->diffuse = glm::vec3(0.8f, 0.6f, 0.0f);
+        dLight2->specular = glm::vec3(0.8f, 0.6f, 0.0f);
+        dirLights.push_back(dLight2);
+        shared_ptr<DirectionalLight> dLight3 = make_shared<DirectionalLight>();
+        dLight3->direction = glm::vec3(-0.2f, -0.6f, 0.5f);
+        dLight3->ambient = glm::vec3(0.07f, 0.07f, 0.1f);
+        dLight3->diffuse = glm::vec3(0.4f, 0.2f, 0.6f);
+        dLight3->specular = glm::vec3(0.1f, 0.1f, 0.15f);
+        dirLights.push_back(dLight3);
+
+
+        SpotLights spotLights;
+
+        shared_ptr<SpotLight> sLight1 = make_shared<SpotLight>();
+        sLight1->position = glm::vec3(4.0f, 3.0f, 0.0f);
+        sLight1->direction = glm::vec3(1.0f, -1.0f, 0.0f);
+        sLight1->cutOff = glm::cos(glm::radians(10.5f));
+        sLight1->outerCutOff = glm::cos(glm::radians(15.5f));
+        sLight1->ambient = glm::vec3(0.0f);
+        sLight1->diffuse = glm::vec3(1.0f, 0.7f, 0.7f);
+        sLight1->specular = glm::vec3(0.1f, 0.07f, 0.07f);
+        sLight1->constant = 1.0f;
+        sLight1->linear = 0.09f;
+        sLight1->quadratic = 0.032f;
+        spotLights.push_back(sLight1);
+        shared_ptr<SpotLight> sLight2 = make_shared<SpotLight>();
+        sLight2->position = glm::vec3(-3.5f, 3.5f, -3.5f);
+        sLight2->direction = glm::vec3(1.0f, -1.0f, 1.0f);
+        sLight2->cutOff = glm::cos(glm::radians(25.5f));
+        sLight2->outerCutOff = glm::cos(glm::radians(30.5f));
+        sLight2->ambient = glm::vec3(0.0f);
+        sLight2->diffuse = glm::vec3(1.0f, 1.0f, 0.0f);
+        sLight2->specular = glm::vec3(1.0f, 1.0f, 0.0f);
+        sLight2->constant = 0.5f;
+        sLight2->linear = 0.03f;
+        sLight2->quadratic = 0.005f;
+        spotLights.push_back(sLight2);
+        shared_ptr<SpotLight> sLight3 = make_shared<SpotLight>();
+        sLight3->position = glm::vec3(5.0f, 6.5f, -4.0f);
+        sLight3->direction = glm::vec3(0.0f, -1.0f, 0.0f);
+        sLight3->cutOff = glm::cos(glm::radians(16.0f));
+        sLight3->outerCutOff = glm::cos(glm::radians(20.0f));
+        sLight3->ambient = glm::vec3(0.0f);
+        sLight3->diffuse = glm::vec3(0.0f, 0.5f, 1.0f);
+        sLight3->specular = glm::vec3(0.0f, 1.0f, 1.0f);
+        sLight3->constant = 1.0f;
+        sLight3->linear = 0.09f;
+        sLight3->quadratic = 0.032f;
+        spotLights.push_back(sLight3);
+        shared_ptr<SpotLight> sLight4 = make_shared<SpotLight>();
+        sLight4->position = glm::vec3(1.0f);
+        sLight4->direction = glm::vec3(0.0f, -1.0f, 0.0f);
+        sLight4->cutOff = glm::cos(glm::radians(12.5f));
+        sLight4->outerCutOff = glm::cos(glm::radians(17.5f));
+        sLight4->ambient = glm::vec3(0.0f);
+        sLight4->diffuse = glm::vec3(1.0f);
+        sLight4->specular = glm::vec3(1.0f);
+        sLight4->constant = 0.5f;
+        sLight4->linear = 0.02f;
+        sLight4->quadratic = 0.002f;
+        spotLights.push_back(sLight4);
+
+        // Init the shaders with the exact number of lights
+        ShaderVariant lightsVariant = ShaderVariant().Lights(dirLights.size(), pointLights.size(), spotLights.size());
+        // colored and textured variants of the same source
+        Shader* lightClrShader = &ShaderCache::Get().Load(getPath("source/shaders/MultipleLightShader.vs").string(),
+                                                          getPath("source/shaders/MultipleLightShader.fs").string(), lightsVariant);
+        Shader* lightTexShader = &ShaderCache::Get().Load(getPath("source/shaders/MultipleLightShader.vs").string(),
+                                                          getPath("source/shaders/MultipleLightShader.fs").string(),
+                                                          ShaderVariant(lightsVariant).Define("TEXTURED"));
+
+        // Render batches
+        RenderBatch phongTexObjects;
+        RenderBatch phongClrObjects;
 
-        glBindFramebuffer(GL_FRAMEBUFFER, 0);
-        // ------- 2. NOW RENDER FLOATING POINT COLOR BUFFER TO 2D QUAD AND TONEMAP HDR COLORS TO DEFAULT'S FRAMEBUFFERS'S (CLAMPED) COLOR RANGE  ----------
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
         hdrShader.use();
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, colorBuffer);
-        hdrShader.setInt("hdr", hdr);
-        hdrShader.setFloat("exposure", exposure);
-        hdrShader.setFloat("gamma", gamma);
-        renderQuad();
-
-        static float f = 0.0f;
-        if (showMenu)
+        hdrShader.setInt("hdrBuffer", 0);
+
+        // Phong textured objects
+        RenderObjectPtr floor = createTexCube("assets/wood.png", 5.0f);
+        floor->transform = glm::translate(floor->transform, glm::vec3(0.0f, -8.0f, 0.0f));
+        floor->transform = glm::scale(floor->transform, glm::vec3(16.0f));
+        phongTexObjects.push_back(floor);
+        RenderObjectPtr box = createTexCube("assets/box.png", 1.0f);
+        box->transform = glm::translate(box->transform, glm::vec3(5.0f, 2.0f, 4.0f));
+        box->transform = glm::rotate(box->transform, glm::radians(45.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+        box->transform = glm::scale(box->transform, glm::vec3(1.0f));
+        phongTexObjects.push_back(box);
+
+        // Phong colored objects
+        RenderObjectPtr wall = createClrCube(glm::vec3(1.0f, 0.5f, 0.0f));
+        wall->transform = glm::translate(wall->transform, glm::vec3(16.0f, 0.0f, 0.0f));
+        wall->transform = glm::scale(wall->transform, glm::vec3(16.0f));
+        phongClrObjects.push_back(wall);
+        RenderObjectPtr jumpingBox = createClrCube(glm::vec3(0.0f, 0.0f, 1.0f));
+        phongClrObjects.push_back(jumpingBox);
+        RenderObjectPtr rotBox = createClrCube(glm::vec3(0.2f, 1.0f, 0.0f));
+        phongClrObjects.push_back(rotBox);
+
+        // light Objects
+        RenderObjectPtr lightCube = createLightCube();
+        RenderObjectPtr LightPrism = createLightPrism();
+        RenderObjectPtr lightCylinder = createLightCylinder();
+
+        PerformanceMonitor pMonitor(glfwGetTime(), 0.5f);
+
+        // Setup Dear ImGui context
+        IMGUI_CHECKVERSION();
+        ImGui::CreateContext();
+        ImGuiIO& io = ImGui::GetIO(); (void)io;
+        // Setup Dear ImGui style
+        ImGui::StyleColorsDark();
+        // GL 3.0 + GLSL 130
+        const char* glsl_version = "#version 130";
+        // Setup Platform/Renderer backends
+        ImGui_ImplGlfw_InitForOpenGL(window, true);
+        ImGui_ImplOpenGL3_Init(glsl_version);
+
+        bool hdr = true;
+        float gamma = 2.2;
+        float exposure = 1.0f;
+
+        // camera and light data shared by every shader through the Camera and Lights blocks
+        UniformBuffer cameraBlock(CAMERA_BLOCK_BINDING);
+        LightsBuffer lightsBlock(dirLights.size(), pointLights.size(), spotLights.size());
+
+        // every RenderObject lives in the shared geometry arena, one VAO per vertex format
+        GeometryArena& arena = GeometryArena::Get();
+
+        // render loop
+        // -----------
+        while (!glfwWindowShouldClose(window))
         {
-            // Start the Dear ImGui frame
-            ImGui_ImplOpenGL3_NewFrame();
-            ImGui_ImplGlfw_NewFrame();
-            ImGui::NewFrame();
-            static int counter = 0;
-
-            ImGui::Begin("HDR Menu");                      
+            // per-frame time logic
+            // --------------------
+            float currentFrame = glfwGetTime();
+            deltaTime = currentFrame - lastFrame;
+            lastFrame = currentFrame;
 
-            ImGui::SliderFloat("Gamma", &gamma, 0.01f, 5.0f);   
-            //ImGui::Text("This is some useful text.");               // Display some text (you can use a format strings too)
-            ImGui::Checkbox("HDR Enabled", &hdr); 
+            pMonitor.update(glfwGetTime());
+            stringstream ss;
+            ss << title << " " << pMonitor;
+            glfwSetWindowTitle(window, ss.str().c_str());
 
-            ImGui::SliderFloat("Exposure", &exposure, 0.0f, 5.0f);          
-            //ImGui::ColorEdit3("clear color", (float*)&clear_color); // Edit 3 floats representing a color
+            // input
+            // -----
+            processInput(window);
 
-            //if (ImGui::Button("Button"))                            // Buttons return true when clicked (most widgets return true when                       edited/activated)
-            //    counter++;
-            //ImGui::SameLine();
-            //ImGui::Text("counter = %d", counter);
-
-            ImGui::Text("Application average %.3f ms/frame (%.1f FPS)", 1000.0f / ImGui::GetIO().Framerate, ImGui::GetIO().Framerate);
-            ImGui::End();
+        
 
-            ImGui::Render();
-            ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+            // refreshing the transforms
+            jumpingBox->transform = glm::translate(glm::mat4(1.0f), 
+                                        glm::vec3(0.0f, 
+                                                glm::abs(glm::sin(glfwGetTime()*1.2f)*4.0f), 
+                                                0.0f));
+            jumpingBox->transform = glm::translate(jumpingBox->transform, glm::vec3(5.0f, 0.6f, -4.0f));
+            jumpingBox->transform = glm::scale(jumpingBox->transform, glm::vec3(1.2f));
+            rotBox->transform = glm::translate(glm::mat4(1.0f), glm::vec3(-4.0f, 2.5f, 0.0f));
+            rotBox->transform = glm::rotate(rotBox->transform, (float)glfwGetTime()*1.0f, 
+                                            glm::vec3(1.0f, 0.0f, 0.0f));
+            rotBox->transform = glm::rotate(rotBox->transform, (float)glfwGetTime()*1.0f, 
+                                            glm::vec3(0.0f, 1.0f, 0.0f));
+            rotBox->transform = glm::rotate(rotBox->transform, (float)glfwGetTime()*1.0f, 
+                                            glm::vec3(0.0f, 0.0f, 1.0f));
+            rotBox->transform = glm::scale(rotBox->transform, glm::vec3(1.2f, 1.2f, 4.0f));
+        
+            spotLights[3]->position = camera.Position +
+                                        camera.Right * 0.5f +
+                                        camera.Front * 1.5f + 
+                                        camera.Up * -0.5f;
+            spotLights[3]->direction = camera.Front;
+
+            // render
+            // ------
+            glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+            // ------- 1. RENDER SCENE INTO FLOATING POINT FRAMEBUFFER  ----------
+            glBindFramebuffer(GL_FRAMEBUFFER, hdrFBO);
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+            // per-frame camera and light data, read by every lighting shader from the shared blocks
+            glm::mat4 projection = glm::perspective(glm::radians(camera.Zoom), (float)SCR_WIDTH / (float)SCR_HEIGHT, 0.1f, 100.0f);
+            cameraBlock.Upload(CameraBlock{ projection, camera.GetViewMatrix(), camera.Position });
+            for (int i = 0; i < dirLights.size(); i++) {
+                DirectionalLightBlock& light = lightsBlock.dirLights[i];
+                light.on = lightsState[i];
+                light.direction = dirLights[i]->direction;
+                light.ambient = dirLights[i]->ambient;
+                light.diffuse = dirLights[i]->diffuse;
+                light.specular = dirLights[i]->specular;
+            }
+            for (int i = 0; i < pointLights.size(); i++) {
+                PointLightBlock& light = lightsBlock.pointLights[i];
+                light.on = lightsState[i+3];
+                light.position = pointLights[i]->position;
+                light.ambient = pointLights[i]->ambient;
+                light.diffuse = pointLights[i]->diffuse;
+                light.specular = pointLights[i]->specular;
+                light.constant = pointLights[i]->constant;
+                light.linear = pointLights[i]->linear;
+                light.quadratic = pointLights[i]->quadratic;
+            }
+            for (int i = 0; i < spotLights.size(); i++) {
+                SpotLightBlock& light = lightsBlock.spotLights[i];
+                light.on = lightsState[i+6];
+                light.position = spotLights[i]->position;
+                light.direction = spotLights[i]->direction;
+                light.ambient = spotLights[i]->ambient;
+                light.diffuse = spotLights[i]->diffuse;
+                light.specular = spotLights[i]->specular;
+                light.cutOff = spotLights[i]->cutOff;
+                light.outerCutOff = spotLights[i]->outerCutOff;
+                light.constant = spotLights[i]->constant;
+                light.linear = spotLights[i]->linear;
+                light.quadratic = spotLights[i]->quadratic;
+            }
+            lightsBlock.Upload();
+
+            // be sure to activate shader when setting uniforms/drawing objects
+            lightTexShader->use();
+
+            // Render Textured Objects
+            for(auto& toRender: phongTexObjects) {
+                // material properties
+                lightTexShader->setVec3("material.ambient", toRender->ka);
+                lightTexShader->setVec3("material.diffuse", toRender->kd);
+                lightTexShader->setVec3("material.specular", toRender->ks);
+                lightTexShader->setFloat("material.shininess", toRender->shininess);
+                lightTexShader->setModel(toRender->transform);
+                // bind textures on corresponding texture units
+                GLState::Get().BindTexture(GL_TEXTURE_2D, toRender->textureId);
+                arena.Bind(toRender->geometry);
+                arena.Draw(toRender->geometry);
+            }
+
+            // be sure to activate shader when setting uniforms/drawing objects
+            lightClrShader->use();
+
+            // Render Colored Objects
+            for(auto& toRender: phongClrObjects) {
+                // material properties
+                lightClrShader->setVec3("material.ambient", toRender->ka);
+                lightClrShader->setVec3("material.diffuse", toRender->kd);
+                lightClrShader->setVec3("material.specular", toRender->ks); 
+                lightClrShader->setFloat("material.shininess", toRender->shininess);
+                lightClrShader->setVec3("color", toRender->color);
+                lightClrShader->setModel(toRender->transform);
+                // bind textures on corresponding texture units
+                arena.Bind(toRender->geometry);
+                arena.Draw(toRender->geometry);
+            }
+
+            lightCubeShader.use();
+            int c = 0;
+            for(auto& light: dirLights) {
+
+                lightCubeShader.setVec3("Color", (lightsState[c])?light->diffuse:glm::vec3(0.0f));
+                glm::mat4 lightTr = glm::translate(glm::mat4(1.0f), light->direction * -5.0f);
+                lightTr = lightTr * rotateFromTo(light->direction, glm::vec3(0.0f, -1.0f, 0.0f));
+                lightTr = glm::scale(lightTr, glm::vec3(0.3f, 0.6f, 0.3f));
+                lightCubeShader.setMat4("model", lightTr);      
+                arena.Bind(lightCylinder->geometry);
+                arena.Draw(lightCylinder->geometry);
+                c++;
+            }
+            c = 3;
+            for(auto& light: pointLights) {
+
+                lightCubeShader.setVec3("Color", (lightsState[c])?light->diffuse:glm::vec3(0.0f));
+                glm::mat4 lightTr = glm::translate(glm::mat4(1.0f), light->position);
+                lightTr = glm::scale(lightTr, glm::vec3(0.3f));
+                lightCubeShader.setMat4("model", lightTr);      
+                arena.Bind(lightCube->geometry);
+                arena.Draw(lightCube->geometry);
+                c++;
+            }
+            c = 6;
+            for(auto& light: spotLights) {
+
+                lightCubeShader.setVec3("Color", (lightsState[c])?light->diffuse:glm::vec3(0.0f));
+                glm::mat4 lightTr = glm::translate(glm::mat4(1.0f), light->position);
+                lightTr = lightTr * rotateFromTo(light->direction, glm::vec3(0.0f, -1.0f, 0.0f));
+                lightTr = glm::scale(lightTr, glm::vec3(0.3f, 0.6f, 0.3f));
+                lightCubeShader.setMat4("model", lightTr);      
+                arena.Bind(LightPrism->geometry);
+                arena.Draw(LightPrism->geometry);
+                c++;
+            }
+
+            glBindFramebuffer(GL_FRAMEBUFFER, 0);
+            // ------- 2. NOW RENDER FLOATING POINT COLOR BUFFER TO 2D QUAD AND TONEMAP HDR COLORS TO DEFAULT'S FRAMEBUFFERS'S (CLAMPED) COLOR RANGE  ----------
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+            hdrShader.use();
+            GLState::Get().ActiveTexture(GL_TEXTURE0);
+            GLState::Get().BindTexture(GL_TEXTURE_2D, colorBuffer);
+            hdrShader.setInt("hdr", hdr);
+            hdrShader.setFloat("exposure", exposure);
+            hdrShader.setFloat("gamma", gamma);
+            renderQuad();
+
+            static float f = 0.0f;
+            if (showMenu)
+            {
+                // Start the Dear ImGui frame
+                ImGui_ImplOpenGL3_NewFrame();
+                ImGui_ImplGlfw_NewFrame();
+                ImGui::NewFrame();
+                static int counter = 0;
+
+                ImGui::Begin("HDR Menu");                      
+
+                ImGui::SliderFloat("Gamma", &gamma, 0.01f, 5.0f);   
+                //ImGui::Text("This is some useful text.");               // Display some text (you can use a format strings too)
+                ImGui::Checkbox("HDR Enabled", &hdr); 
+
+                ImGui::SliderFloat("Exposure", &exposure, 0.0f, 5.0f);          
+                //ImGui::ColorEdit3("clear color", (float*)&clear_color); // Edit 3 floats representing a color
+
+                //if (ImGui::Button("Button"))                            // Buttons return true when clicked (most widgets return true when                       edited/activated)
+                //    counter++;
+                //ImGui::SameLine();
+                //ImGui::Text("counter = %d", counter);
+
+                ImGui::Text("Application average %.3f ms/frame (%.1f FPS)", 1000.0f / ImGui::GetIO().Framerate, ImGui::GetIO().Framerate);
+                ImGui::End();
+
+                ImGui::Render();
+                ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+            }
+
+
+            // glfw: swap buffers and poll IO events (keys pressed/released, mouse moved etc.)
+            // -------------------------------------------------------------------------------
+            glfwSwapBuffers(window);
+            glfwPollEvents();
         }
 
+        // optional: de-allocate all resources once they've outlived their purpose:
+        // ------------------------------------------------------------------------
+        for(auto& toRender: phongTexObjects) {
+            arena.Free(toRender->geometry);
+        }
+        for(auto& toRender: phongClrObjects) {
+            arena.Free(toRender->geometry);
+        }
+        arena.Free(lightCube->geometry);
 
-        // glfw: swap buffers and poll IO events (keys pressed/released, mouse moved etc.)
-        // -------------------------------------------------------------------------------
-        glfwSwapBuffers(window);
-        glfwPollEvents();
-    }
+        arena.Free(LightPrism->geometry);
 
-    // optional: de-allocate all resources once they've outlived their purpose:
-    // ------------------------------------------------------------------------
-    for(auto& toRender: phongTexObjects) {
-        glDeleteVertexArrays(1, &toRender->VAO);
-        glDeleteBuffers(1, &toRender->VBO);
-    }
-    for(auto& toRender: phongClrObjects) {
-        glDeleteVertexArrays(1, &toRender->VAO);
-        glDeleteBuffers(1, &toRender->VBO);
+        arena.Free(lightCylinder->geometry);
     }
-    glDeleteVertexArrays(1, &lightCube->VAO);
-    glDeleteBuffers(1, &lightCube->VBO);
-
-    glDeleteVertexArrays(1, &LightPrism->VAO);
-    glDeleteBuffers(1, &LightPrism->VBO);
-
-    glDeleteVertexArrays(1, &lightCylinder->VAO);
-    glDeleteBuffers(1, &lightCylinder->VBO);
 
     // glfw: terminate, clearing all previously allocated GLFW resources.
     // ------------------------------------------------------------------
@@ -730,7 +691,6 @@ void scroll_callback(GLFWwindow* window, double xoffset, double yoffset)
 RenderObjectPtr createTexCube(string path, float texScale, glm::vec3 ka, glm::vec3 kd, glm::vec3 ks, float shnss)
 {
     RenderObjectPtr cubeObject = make_shared<RenderObject>();
-    unsigned int cubeEBO;
     float vertices[] = {
         -0.5f, -0.5f, -0.5f,  0.0f,  0.0f, -1.0f, 0.0f, texScale,
          0.5f, -0.5f, -0.5f,  0.0f,  0.0f, -1.0f, texScale, texScale,
@@ -770,31 +730,10 @@ RenderObjectPtr createTexCube(string path, float texScale, glm::vec3 ka, glm::ve
         16, 17, 18,  18, 19, 16,
         20, 21, 22,  22, 23, 20        
     };
-    glGenVertexArrays(1, &cubeObject->VAO);
-    glGenBuffers(1, &cubeObject->VBO);
-    glGenBuffers(1, &cubeEBO);
-    // bind the Vertex Array Object first, then bind and set vertex buffer(s), and then configure vertex attributes(s).
-    glBindVertexArray(cubeObject->VAO);
-    glBindBuffer(GL_ARRAY_BUFFER, cubeObject->VBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, cubeEBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-
-    // position attribute
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-    // normal attribute
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
-    // texture coord attribute
-    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(6 * sizeof(float)));
-    glEnableVertexAttribArray(2);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
+    cubeObject->geometry = GeometryArena::Get().Allocate(VertexFormat::Floats({ 3, 3, 2 }), vertices, 24, indices, 36);
     // load and create a texture 
     cubeObject->textureId = loadTexture(getPath(path).string().c_str(), true);
     cubeObject->transform = glm::mat4(1.0f);
-    cubeObject->indexCount = 36;
     cubeObject->ka = ka;
     cubeObject->kd = kd;
     cubeObject->ks = ks;
@@ -805,7 +744,6 @@ RenderObjectPtr createTexCube(string path, float texScale, glm::vec3 ka, glm::ve
 RenderObjectPtr createClrCube(glm::vec3 color, glm::vec3 ka, glm::vec3 kd, glm::vec3 ks, float shnss)
 {
     RenderObjectPtr cubeObject = make_shared<RenderObject>();
-    unsigned int cubeEBO;
     float vertices[] = {
         -0.5f, -0.5f, -0.5f,  0.0f,  0.0f, -1.0f,
          0.5f, -0.5f, -0.5f,  0.0f,  0.0f, -1.0f,
@@ -845,26 +783,8 @@ RenderObjectPtr createClrCube(glm::vec3 color, glm::vec3 ka, glm::vec3 kd, glm::
         16, 17, 18,  18, 19, 16,
         20, 21, 22,  22, 23, 20        
     };
-    glGenVertexArrays(1, &cubeObject->VAO);
-    glGenBuffers(1, &cubeObject->VBO);
-    glGenBuffers(1, &cubeEBO);
-    // bind the Vertex Array Object first, then bind and set vertex buffer(s), and then configure vertex attributes(s).
-    glBindVertexArray(cubeObject->VAO);
-    glBindBuffer(GL_ARRAY_BUFFER, cubeObject->VBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, cubeEBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-
-    // position attribute
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-    // normal attribute
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
+    cubeObject->geometry = GeometryArena::Get().Allocate(VertexFormat::Floats({ 3, 3 }), vertices, 24, indices, 36);
     cubeObject->transform = glm::mat4(1.0f);
-    cubeObject->indexCount = 36;
     cubeObject->ka = ka;
     cubeObject->kd = kd;
     cubeObject->ks = ks;
@@ -876,7 +796,6 @@ RenderObjectPtr createClrCube(glm::vec3 color, glm::vec3 ka, glm::vec3 kd, glm::
 RenderObjectPtr createLightCube()
 {
     RenderObjectPtr lightObject = make_shared<RenderObject>();
-    unsigned int cubeEBO;
     float vertices[] = {
         -0.5f, -0.5f, -0.5f,  0.0f,  0.0f, -1.0f,
          0.5f, -0.5f, -0.5f,  0.0f,  0.0f, -1.0f,
@@ -917,24 +836,7 @@ RenderObjectPtr createLightCube()
         20, 21, 22,  22, 23, 20        
     };
 
-    glGenVertexArrays(1, &lightObject->VAO);
-    glGenBuffers(1, &lightObject->VBO);
-    glGenBuffers(1, &cubeEBO);
-    // bind the Vertex Array Object first, then bind and set vertex buffer(s), and then configure vertex attributes(s).
-    glBindVertexArray(lightObject->VAO);
-    glBindBuffer(GL_ARRAY_BUFFER, lightObject->VBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, cubeEBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-
-    // position attribute
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-
-    // note that we update the lamp's position attribute's stride to reflect the updated buffer data
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-    lightObject->indexCount = 36;
+    lightObject->geometry = GeometryArena::Get().Allocate(VertexFormat::Floats({ 3, 3 }), vertices, 24, indices, 36);
     lightObject->color = glm::vec3(1.0f);
     return lightObject;
 }
@@ -942,7 +844,6 @@ RenderObjectPtr createLightCube()
 RenderObjectPtr createLightPrism()
 {
     RenderObjectPtr lightObject = make_shared<RenderObject>();
-    unsigned int cubeEBO;
     float vertices[] = {
          0.0f,  0.5f,  0.0f,  0.0f,  0.0f, -1.0f,
         -0.5f, -0.5f,  0.5f,  0.0f,  0.0f, -1.0f,
@@ -958,24 +859,7 @@ RenderObjectPtr createLightPrism()
         1, 3, 4,   2, 1, 4
     };
 
-    glGenVertexArrays(1, &lightObject->VAO);
-    glGenBuffers(1, &lightObject->VBO);
-    glGenBuffers(1, &cubeEBO);
-    // bind the Vertex Array Object first, then bind and set vertex buffer(s), and then configure vertex attributes(s).
-    glBindVertexArray(lightObject->VAO);
-    glBindBuffer(GL_ARRAY_BUFFER, lightObject->VBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, cubeEBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-
-    // position attribute
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-
-    // note that we update the lamp's position attribute's stride to reflect the updated buffer data
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-    lightObject->indexCount = 18;
+    lightObject->geometry = GeometryArena::Get().Allocate(VertexFormat::Floats({ 3, 3 }), vertices, 5, indices, 18);
     lightObject->color = glm::vec3(1.0f);
     return lightObject;
 }
@@ -983,7 +867,6 @@ RenderObjectPtr createLightPrism()
 RenderObjectPtr createLightCylinder()
 {
     RenderObjectPtr lightObject = make_shared<RenderObject>();
-    unsigned int cubeEBO;
     int segments = 32;
     std::vector<float> vertices;
     std::vector<unsigned int> indices;
@@ -1021,24 +904,7 @@ RenderObjectPtr createLightCylinder()
     float* vert = &vertices[0];
     unsigned int* indi = &indices[0];
 
-    glGenVertexArrays(1, &lightObject->VAO);
-    glGenBuffers(1, &lightObject->VBO);
-    glGenBuffers(1, &cubeEBO);
-    // bind the Vertex Array Object first, then bind and set vertex buffer(s), and then configure vertex attributes(s).
-    glBindVertexArray(lightObject->VAO);
-    glBindBuffer(GL_ARRAY_BUFFER, lightObject->VBO);
-    glBufferData(GL_ARRAY_BUFFER, vertices.size()*sizeof(float), vert, GL_STATIC_DRAW);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, cubeEBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size()*sizeof(unsigned int), indi, GL_STATIC_DRAW);
-
-    // position attribute
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-
-    // note that we update the lamp's position attribute's stride to reflect the updated buffer data
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-    lightObject->indexCount = indices.size();
+    lightObject->geometry = GeometryArena::Get().Allocate(VertexFormat::Floats({ 3, 3 }), vert, static_cast<unsigned int>(vertices.size() / 6), indi, static_cast<unsigned int>(indices.size()));
     lightObject->color = glm::vec3(1.0f);
     return lightObject;
 }
@@ -1071,48 +937,10 @@ glm::mat4 rotateFromTo(glm::vec3 a, glm::vec3 b)
 // ---------------------------------------------------
 unsigned int loadTexture(char const * path, bool gammaCorrection)
 {
-    unsigned int textureID;
-    glGenTextures(1, &textureID);
-
-    int width, height, nrComponents;
-    unsigned char *data = stbi_load(path, &width, &height, &nrComponents, 0);
-    if (data)
-    {
-        GLenum internalFormat;
-        GLenum dataFormat;
-        if (nrComponents == 1)
-        {
-            internalFormat = dataFormat = GL_RED;
-        }
-        else if (nrComponents == 3)
-        {
-            internalFormat = gammaCorrection ? GL_SRGB : GL_RGB;
-            dataFormat = GL_RGB;
-        }
-        else if (nrComponents == 4)
-        {
-            internalFormat = gammaCorrection ? GL_SRGB_ALPHA : GL_RGBA;
-            dataFormat = GL_RGBA;
-        }
-
-        glBindTexture(GL_TEXTURE_2D, textureID);
-        glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, width, height, 0, dataFormat, GL_UNSIGNED_BYTE, data);
-        glGenerateMipmap(GL_TEXTURE_2D);
-
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-        stbi_image_free(data);
-    }
-    else
-    {
-        std::cout << "Texture failed to load at path: " << path << std::endl;
-        stbi_image_free(data);
-    }
-
-    return textureID;
+    // the cache decodes each image once, however many objects use it
+    TextureSettings settings;
+    settings.gammaCorrection = gammaCorrection;
+    return TextureCache::Get().Load(path, settings);
 }
 
 // renderQuad() renders a 1x1 XY quad in NDC
@@ -1133,15 +961,15 @@ void renderQuad()
         // setup plane VAO
         glGenVertexArrays(1, &quadVAO);
         glGenBuffers(1, &quadVBO);
-        glBindVertexArray(quadVAO);
-        glBindBuffer(GL_ARRAY_BUFFER, quadVBO);
+        GLState::Get().BindVertexArray(quadVAO);
+        GLState::Get().BindBuffer(GL_ARRAY_BUFFER, quadVBO);
         glBufferData(GL_ARRAY_BUFFER, sizeof(quadVertices), &quadVertices, GL_STATIC_DRAW);
         glEnableVertexAttribArray(0);
         glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
         glEnableVertexAttribArray(1);
         glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
     }
-    glBindVertexArray(quadVAO);
+    GLState::Get().BindVertexArray(quadVAO);
     glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
-    glBindVertexArray(0);
+    GLState::Get().BindVertexArray(0);
 }
\ No newline at end of file
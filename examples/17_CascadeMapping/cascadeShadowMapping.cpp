@@ -9,6 +9,12 @@
 #include <glm/gtc/type_ptr.hpp>
 
 #include "shaders/shader.hpp"
+#include "glState.hpp"
+#include "uniformBlocks.hpp"
+#include "textureCache.hpp"
+#include "geometryArena.hpp"
+#include "drawBatch.hpp"
+#include "objectBuffer.hpp"
 #include "root_directory.h"
 #include "cameras/cameraFirstPerson.hpp"
 #include "performanceMonitor.hpp"
@@ -39,8 +45,8 @@ float deltaTime = 0.0f;
 float lastFrame = 0.0f;
 
 struct RenderObject {
-    unsigned int VAO, VBO;
-    unsigned indexCount;
+    // range of the object's vertices and indices in the geometry arena
+    GeometryHandle geometry;
     glm::mat4 transform;
     unsigned int textureId;
     glm::vec3 ka, kd, ks, color;
@@ -106,7 +112,8 @@ unsigned int loadTexture(const char *path, bool gammaCorrection);
 void CalcOrthoProjs();
 glm::mat4 getOrthoProj(OrthoProjInfo& info);
 
-#define NUM_CASCADES 3
+// the Cascades block and the shaders are built for the same count
+#define NUM_CASCADES CASCADES_BLOCK_COUNT
 
 bool showCascade = false;
 int depthMapRendered = 0;
@@ -158,435 +165,381 @@ int main()
         return -1;
     }
 
-    // configure global opengl state
-    // -----------------------------
-    glEnable(GL_DEPTH_TEST);
-
-    // build and compile our shader zprogram
-    Shader dirLightTexShader(getPath("source/shaders/DirLightCSMTexShader.vs").string().c_str(), 
-                               getPath("source/shaders/DirLightCSMTexShader.fs").string().c_str() );
-    Shader dirLightClrShader(getPath("source/shaders/DirLightCSMClrShader.vs").string().c_str(), 
-                               getPath("source/shaders/DirLightCSMClrShader.fs").string().c_str() );
-    Shader depthMappingShader(getPath("source/shaders/ShadowMapDepthShader.vs").string().c_str(), 
-                           getPath("source/shaders/ShadowMapDepthShader.fs").string().c_str() );
-    Shader depthDebugShader(getPath("source/shaders/depthMapping.vs").string().c_str(), 
-                           getPath("source/shaders/depthMapping.fs").string().c_str() );
-    Shader cascadeDebugTexShader(getPath("source/shaders/CascadeMappingTexShader.vs").string().c_str(), 
-                               getPath("source/shaders/CascadeMappingTexShader.fs").string().c_str() );
-    Shader cascadeDebugClrShader(getPath("source/shaders/CascadeMappingClrShader.vs").string().c_str(), 
-                               getPath("source/shaders/CascadeMappingClrShader.fs").string().c_str() );
-
-    // shader configuration
-    // --------------------
-    depthDebugShader.use();
-    depthDebugShader.setInt("depthMap", 0);
-
-    dirLightTexShader.use();
-    dirLightTexShader.setInt("texture_diffuse0", 0);
-    dirLightTexShader.setInt("shadowMap[0]", 1);
-    dirLightTexShader.setInt("shadowMap[1]", 2);
-    dirLightTexShader.setInt("shadowMap[2]", 3);
-
-    dirLightClrShader.use();
-    dirLightClrShader.setInt("shadowMap[0]", 0);
-    dirLightClrShader.setInt("shadowMap[1]", 1);
-    dirLightClrShader.setInt("shadowMap[2]", 2);
-
-    cascadeDebugTexShader.use();
-    cascadeDebugTexShader.setInt("texture_diffuse0", 0);
-    cascadeDebugTexShader.setInt("shadowMap[0]", 1);
-    cascadeDebugTexShader.setInt("shadowMap[1]", 2);
-    cascadeDebugTexShader.setInt("shadowMap[2]", 3);
-
-    cascadeDebugClrShader.use();
-    cascadeDebugClrShader.setInt("shadowMap[0]", 0);
-    cascadeDebugClrShader.setInt("shadowMap[1]", 1);
-    cascadeDebugClrShader.setInt("shadowMap[2]", 2);
-
-    // ---------------------
-
-    dirLight = new DirectionalLight;
-    dirLight->direction = glm::normalize(glm::vec3(1.0f, -1.0f, 0.5f));
-    dirLight->ambient = glm::vec3(0.7f);
-    dirLight->diffuse = glm::vec3(1.0f);
-    dirLight->specular = glm::vec3(1.0f);
-    dirLight->nearPlane = 0.01f;
-    dirLight->farPlane = 17.5f;
-    dirLight->orthoDim = 10.0f;
-    dirLight->projection = glm::ortho(-dirLight->orthoDim, dirLight->orthoDim, -dirLight->orthoDim, dirLight->orthoDim, dirLight->nearPlane, dirLight->farPlane);
-    
-    cout << "[2][3]" << dirLight->projection[2][3] << endl; // 0
-    cout << "[3][2]" << dirLight->projection[3][2] << endl; // -1
-    // Render batches
-    RenderBatch phongTexObjects;
-    RenderBatch phongClrObjects;
-    RenderBatch coloredObjects;
-
-    camera.MovementSpeed = 10.0f;
-
-    cameraProjInfo.fov = camera.Zoom;
-    cameraProjInfo.height = (float)SCR_HEIGHT;
-    cameraProjInfo.width = (float)SCR_WIDTH;
-    cameraProjInfo.zNear = 0.1f;
-    cameraProjInfo.zFar = 100.0f;
-
-    // ------- CASCADE SETUP ----------
-    mCascadeEnd[0] = cameraProjInfo.zNear;
-    mCascadeEnd[1] = cameraProjInfo.zNear + (cameraProjInfo.zFar - cameraProjInfo.zNear) * 0.15;
-    mCascadeEnd[2] = cameraProjInfo.zNear + (cameraProjInfo.zFar - cameraProjInfo.zNear) * 0.45;
-    mCascadeEnd[3] = cameraProjInfo.zFar;
-
-    GLuint mFbo;
-    GLuint mShadowMap[NUM_CASCADES];
-
-    const unsigned int SHADOW_WIDTH = 1024, SHADOW_HEIGHT = 1024;
-
-    // Create the FBO
-    glGenFramebuffers(1, &mFbo);
-    // Create the depth buffer
-    glGenTextures(NUM_CASCADES, mShadowMap);
-    for (unsigned int i = 0 ; i < NUM_CASCADES ; i++) {
-        glBindTexture(GL_TEXTURE_2D, mShadowMap[i]);
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT32, SHADOW_WIDTH, SHADOW_HEIGHT, 0, GL_DEPTH_COMPONENT, GL_FLOAT, NULL);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_COMPARE_MODE, GL_NONE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-    }
-    glBindFramebuffer(GL_FRAMEBUFFER, mFbo);
-    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, mShadowMap[0], 0);
-    // Disable writes to the color buffer
-    glDrawBuffer(GL_NONE);
-    glReadBuffer(GL_NONE);
-    GLenum Status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
-    if (Status != GL_FRAMEBUFFER_COMPLETE) {
-        printf("FB error, status: 0x%x\n", Status);
-        return false;
-    }
-
-    float mCascadeEndClipSpace[NUM_CASCADES];
-
-
-    // --------------------------------
-
-    srand(time(NULL));
-    glm::vec3 center(16.0f, 5.0f, 0.0f);
-    float width = 32.0f;
-    float height = 2.0f;
-    float deep = 20.0f;
-    int boxes = 42;
-    for (int i = 0; i < boxes; i++) {
-        RenderObjectPtr box = createTexCube("assets/box.png", 1.0f);
-        box->transform = glm::translate(box->transform, center + glm::vec3( (genRand()-0.5f)*2.0f*width, (genRand()-0.5f)*2.0f*height, (genRand()-0.5f)*2.0f*deep ));
-        box->transform = glm::rotate(box->transform, glm::radians(genRand()*360.0f), glm::vec3(1.0f, 0.0f, 0.0f));
-        box->transform = glm::rotate(box->transform, glm::radians(genRand()*360.0f), glm::vec3(0.0f, 1.0f, 0.0f));
-        box->transform = glm::rotate(box->transform, glm::radians(genRand()*360.0f), glm::vec3(0.0f, 0.0f, 1.0f));
-        box->transform = glm::scale(box->transform, glm::vec3(1.0f + (genRand()*2.0f)));
-        phongTexObjects.push_back(box);
-    }
-
-    // Phong textured objects
-    RenderObjectPtr floor = createTexCube("assets/grass.png", 5.0f);
-    floor->transform = glm::translate(floor->transform, glm::vec3(0.0f, -8.0f, 0.0f));
-    floor->transform = glm::scale(floor->transform, glm::vec3(128.0f, 16.0f, 64.0f));
-    phongTexObjects.push_back(floor);
-
-    // Phong colored objects
-    RenderObjectPtr house1 = createClrCube(glm::vec3(0.6f, 0.6f, 0.6f));
-    house1->transform = glm::translate(house1->transform, glm::vec3(-48.0f, 4.0f, -20.0f));
-    house1->transform = glm::scale(house1->transform, glm::vec3(26.0f, 8.0f, 8.0f));
-    phongClrObjects.push_back(house1);
-    // Phong colored objects
-    RenderObjectPtr house2 = createClrCube(glm::vec3(0.6f, 0.6f, 0.6f));
-    house2->transform = glm::translate(house2->transform, glm::vec3(-48.0f, 16.0f, -20.0f));
-    house2->transform = glm::scale(house2->transform, glm::vec3(8.0f, 32.0f, 8.0f));
-    phongClrObjects.push_back(house2);
-
-    // Depth map quad object
-    RenderObjectPtr depthQuad = createTexQuad();
-
-    PerformanceMonitor pMonitor(glfwGetTime(), 0.5f);
-
-    // Use fcae culling to fix peter panning problwms with shadows
-    //glEnable(GL_CULL_FACE);
-
-    // render loop
-    // -----------
-    while (!glfwWindowShouldClose(window))
+    // everything that owns GL objects lives in this scope and is destroyed before glfwTerminate()
     {
-        // per-frame time logic
+        // configure global opengl state
+        // -----------------------------
+        glEnable(GL_DEPTH_TEST);
+
+        // build and compile our shader zprogram
+        // the scene shaders read model, normal matrix and material of each object from the object buffer
+        ShaderCache& shaders = ShaderCache::Get();
+        ShaderVariant cascadesVariant = ObjectBuffer::Variant().Define("NUM_CASCADES", NUM_CASCADES);
+        Shader& dirLightTexShader = shaders.Load(getPath("source/shaders/DirLightCSMTexShader.vs").string(), 
+                                                 getPath("source/shaders/DirLightCSMTexShader.fs").string(), cascadesVariant);
+        Shader& dirLightClrShader = shaders.Load(getPath("source/shaders/DirLightCSMClrShader.vs").string(), 
+                                                 getPath("source/shaders/DirLightCSMClrShader.fs").string(), cascadesVariant);
+        Shader& depthMappingShader = shaders.Load(getPath("source/shaders/ShadowMapDepthShader.vs").string(),
+                                                  getPath("source/shaders/ShadowMapDepthShader.fs").string(), ObjectBuffer::Variant());
+        Shader depthDebugShader(getPath("source/shaders/depthMapping.vs").string().c_str(), 
+                               getPath("source/shaders/depthMapping.fs").string().c_str() );
+        Shader& cascadeDebugTexShader = shaders.Load(getPath("source/shaders/CascadeMappingTexShader.vs").string(), 
+                                                     getPath("source/shaders/CascadeMappingTexShader.fs").string(), cascadesVariant);
+        Shader& cascadeDebugClrShader = shaders.Load(getPath("source/shaders/CascadeMappingClrShader.vs").string(), 
+                                                     getPath("source/shaders/CascadeMappingClrShader.fs").string(), cascadesVariant);
+
+        // shader configuration
         // --------------------
-        float currentFrame = glfwGetTime();
-        deltaTime = currentFrame - lastFrame;
-        lastFrame = currentFrame;
-
-        pMonitor.update(glfwGetTime());
-        stringstream ss;
-        ss << title << " " << pMonitor;
-        glfwSetWindowTitle(window, ss.str().c_str());
-
-        // input
-        // -----
-        processInput(window);
-        
-        // render
-        // ------
-        glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-
-        cameraProjInfo.fov = camera.Zoom;
-        glm::mat4 projection = glm::perspective(glm::radians(cameraProjInfo.fov), cameraProjInfo.width / cameraProjInfo.height, cameraProjInfo.zNear, cameraProjInfo.zFar);
+        depthDebugShader.use();
+        depthDebugShader.setInt("depthMap", 0);
+
+        dirLightTexShader.use();
+        dirLightTexShader.setInt("texture_diffuse0", 0);
+        dirLightTexShader.setInt("shadowMap[0]", 1);
+        dirLightTexShader.setInt("shadowMap[1]", 2);
+        dirLightTexShader.setInt("shadowMap[2]", 3);
+
+        dirLightClrShader.use();
+        dirLightClrShader.setInt("shadowMap[0]", 0);
+        dirLightClrShader.setInt("shadowMap[1]", 1);
+        dirLightClrShader.setInt("shadowMap[2]", 2);
+
+        cascadeDebugTexShader.use();
+        cascadeDebugTexShader.setInt("texture_diffuse0", 0);
+        cascadeDebugTexShader.setInt("shadowMap[0]", 1);
+        cascadeDebugTexShader.setInt("shadowMap[1]", 2);
+        cascadeDebugTexShader.setInt("shadowMap[2]", 3);
+
+        cascadeDebugClrShader.use();
+        cascadeDebugClrShader.setInt("shadowMap[0]", 0);
+        cascadeDebugClrShader.setInt("shadowMap[1]", 1);
+        cascadeDebugClrShader.setInt("shadowMap[2]", 2);
+
+        // ---------------------
+
+        dirLight = new DirectionalLight;
+        dirLight->direction = glm::normalize(glm::vec3(1.0f, -1.0f, 0.5f));
+        dirLight->ambient = glm::vec3(0.7f);
+        dirLight->diffuse = glm::vec3(1.0f);
+        dirLight->specular = glm::vec3(1.0f);
+        dirLight->nearPlane = 0.01f;
+        dirLight->farPlane = 17.5f;
+        dirLight->orthoDim = 10.0f;
+        dirLight->projection = glm::ortho(-dirLight->orthoDim, dirLight->orthoDim, -dirLight->orthoDim, dirLight->orthoDim, dirLight->nearPlane, dirLight->farPlane);
+    
+        cout << "[2][3]" << dirLight->projection[2][3] << endl; // 0
+        cout << "[3][2]" << dirLight->projection[3][2] << endl; // -1
+        // Render batches
+        RenderBatch phongTexObjects;
+        RenderBatch phongClrObjects;
+        RenderBatch coloredObjects;
 
-        dirLight->position = camera.Position + camera.Front * 3.0f + camera.Up *6.0f;
-        dirLight->view = glm::lookAt(dirLight->position, dirLight->position + glm::normalize(dirLight->direction), glm::vec3(0.0, 1.0, 0.0));
-        dirLight->spaceMatrix = dirLight->projection * dirLight->view;
+        camera.MovementSpeed = 10.0f;
 
+        cameraProjInfo.fov = camera.Zoom;
+        cameraProjInfo.height = (float)SCR_HEIGHT;
+        cameraProjInfo.width = (float)SCR_WIDTH;
+        cameraProjInfo.zNear = 0.1f;
+        cameraProjInfo.zFar = 100.0f;
+
+        // ------- CASCADE SETUP ----------
+        mCascadeEnd[0] = cameraProjInfo.zNear;
+        mCascadeEnd[1] = cameraProjInfo.zNear + (cameraProjInfo.zFar - cameraProjInfo.zNear) * 0.15;
+        mCascadeEnd[2] = cameraProjInfo.zNear + (cameraProjInfo.zFar - cameraProjInfo.zNear) * 0.45;
+        mCascadeEnd[3] = cameraProjInfo.zFar;
+
+        GLuint mFbo;
+        GLuint mShadowMap[NUM_CASCADES];
+
+        const unsigned int SHADOW_WIDTH = 1024, SHADOW_HEIGHT = 1024;
+
+        // Create the FBO
+        glGenFramebuffers(1, &mFbo);
+        // Create the depth buffer
+        glGenTextures(NUM_CASCADES, mShadowMap);
+        for (unsigned int i = 0 ; i < NUM_CASCADES ; i++) {
+            GLState::Get().BindTexture(GL_TEXTURE_2D, mShadowMap[i]);
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT32, SHADOW_WIDTH, SHADOW_HEIGHT, 0, GL_DEPTH_COMPONENT, GL_FLOAT, NULL);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_COMPARE_MODE, GL_NONE);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        }
+        glBindFramebuffer(GL_FRAMEBUFFER, mFbo);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, mShadowMap[0], 0);
+        // Disable writes to the color buffer
+        glDrawBuffer(GL_NONE);
+        glReadBuffer(GL_NONE);
+        GLenum Status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+        if (Status != GL_FRAMEBUFFER_COMPLETE) {
+            printf("FB error, status: 0x%x\n", Status);
+            return false;
+        }
 
-        // 1. CALCULATE THE PROJECTION MATRIX FOR EACH CASCADE
-        for (unsigned int i = 0; i < NUM_CASCADES; i++) {
-            mCascadeEndClipSpace[i] = mCascadeEnd[i+1];
+        float mCascadeEndClipSpace[NUM_CASCADES];
+
+
+        // --------------------------------
+
+        srand(time(NULL));
+        glm::vec3 center(16.0f, 5.0f, 0.0f);
+        float width = 32.0f;
+        float height = 2.0f;
+        float deep = 20.0f;
+        int boxes = 42;
+        for (int i = 0; i < boxes; i++) {
+            RenderObjectPtr box = createTexCube("assets/box.png", 1.0f);
+            box->transform = glm::translate(box->transform, center + glm::vec3( (genRand()-0.5f)*2.0f*width, (genRand()-0.5f)*2.0f*height, (genRand()-0.5f)*2.0f*deep ));
+            box->transform = glm::rotate(box->transform, glm::radians(genRand()*360.0f), glm::vec3(1.0f, 0.0f, 0.0f));
+            box->transform = glm::rotate(box->transform, glm::radians(genRand()*360.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+            box->transform = glm::rotate(box->transform, glm::radians(genRand()*360.0f), glm::vec3(0.0f, 0.0f, 1.0f));
+            box->transform = glm::scale(box->transform, glm::vec3(1.0f + (genRand()*2.0f)));
+            phongTexObjects.push_back(box);
         }
-        CalcOrthoProjs();
 
-        // 2. RENDER DEPTH OF SCENE TO TEXTURE FOR EACH CASCADE
-        glm::mat4 lightView = glm::lookAt(dirLight->position, dirLight->position + glm::normalize(dirLight->direction), glm::vec3(0.0, 1.0, 0.0));
-        for (unsigned int i = 0 ; i < NUM_CASCADES ; i++) {
-            // Gen the proj and view matrix
-            // render the scene to the buffer
-            glViewport(0, 0, SHADOW_WIDTH, SHADOW_HEIGHT);
-            glBindFramebuffer(GL_DRAW_FRAMEBUFFER, mFbo);
-            glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, mShadowMap[i], 0);
-            glClear(GL_DEPTH_BUFFER_BIT);
-            depthMappingShader.use();
-            depthMappingShader.setMat4("lightSpaceMat", mShadowMapProjs[i]);
-            // Render the textured objects
-            for(auto& toRender: phongTexObjects) {
-                depthMappingShader.setMat4("model", toRender->transform);
-                // bind textures on corresponding texture units
-                glBindVertexArray(toRender->VAO);
-                glDrawElements(GL_TRIANGLES, toRender->indexCount, GL_UNSIGNED_INT, 0);
+        // Phong textured objects
+        RenderObjectPtr floor = createTexCube("assets/grass.png", 5.0f);
+        floor->transform = glm::translate(floor->transform, glm::vec3(0.0f, -8.0f, 0.0f));
+        floor->transform = glm::scale(floor->transform, glm::vec3(128.0f, 16.0f, 64.0f));
+        phongTexObjects.push_back(floor);
+
+        // Phong colored objects
+        RenderObjectPtr house1 = createClrCube(glm::vec3(0.6f, 0.6f, 0.6f));
+        house1->transform = glm::translate(house1->transform, glm::vec3(-48.0f, 4.0f, -20.0f));
+        house1->transform = glm::scale(house1->transform, glm::vec3(26.0f, 8.0f, 8.0f));
+        phongClrObjects.push_back(house1);
+        // Phong colored objects
+        RenderObjectPtr house2 = createClrCube(glm::vec3(0.6f, 0.6f, 0.6f));
+        house2->transform = glm::translate(house2->transform, glm::vec3(-48.0f, 16.0f, -20.0f));
+        house2->transform = glm::scale(house2->transform, glm::vec3(8.0f, 32.0f, 8.0f));
+        phongClrObjects.push_back(house2);
+
+        // Depth map quad object
+        RenderObjectPtr depthQuad = createTexQuad();
+
+        PerformanceMonitor pMonitor(glfwGetTime(), 0.5f);
+
+        // Use fcae culling to fix peter panning problwms with shadows
+        //glEnable(GL_CULL_FACE);
+
+        // camera and cascade data shared by every shader through the Camera and Cascades blocks
+        static_assert(NUM_CASCADES == CASCADES_BLOCK_COUNT);
+        UniformBuffer cameraBlock(CAMERA_BLOCK_BINDING);
+        UniformBuffer cascadesBlock(CASCADES_BLOCK_BINDING);
+
+        // every cube and the quad live in the shared geometry arena, one VAO per vertex format
+        GeometryArena& arena = GeometryArena::Get();
+
+        // the objects don't move, so their data and the batches drawing them are built once;
+        // the textured objects get one batch per texture
+        ObjectBuffer objectBuffer;
+        map<unsigned int, DrawBatch> texBatches;
+        DrawBatch clrBatch;
+        vector<ObjectData> objects;
+        vector<MaterialBlock> materials;
+        // index of the object's material in the table, added when no equal one is there yet
+        auto materialIndex = [&materials](const RenderObject& object) {
+            for (size_t i = 0; i < materials.size(); i++) {
+                const MaterialBlock& material = materials[i];
+                if (material.ambient == object.ka && material.diffuse == object.kd && material.specular == object.ks
+                    && material.shininess == object.shininess && material.color == object.color)
+                    return static_cast<unsigned int>(i);
             }
-            // Render the colored objects
-            for(auto& toRender: phongClrObjects) {
-                // material properties
-                depthMappingShader.setMat4("model", toRender->transform);
-                // bind textures on corresponding texture units
-                glBindVertexArray(toRender->VAO);
-                glDrawElements(GL_TRIANGLES, toRender->indexCount, GL_UNSIGNED_INT, 0);
-            }
-            glBindFramebuffer(GL_FRAMEBUFFER, 0);
+            MaterialBlock material = {};
+            material.ambient = object.ka;
+            material.diffuse = object.kd;
+            material.specular = object.ks;
+            material.shininess = object.shininess;
+            material.color = object.color;
+            materials.push_back(material);
+            return static_cast<unsigned int>(materials.size() - 1);
+        };
+        for(auto& toRender: phongTexObjects) {
+            texBatches[toRender->textureId].Add(toRender->geometry, static_cast<unsigned int>(objects.size()));
+            objects.push_back(ObjectData(toRender->transform, materialIndex(*toRender)));
+        }
+        for(auto& toRender: phongClrObjects) {
+            clrBatch.Add(toRender->geometry, static_cast<unsigned int>(objects.size()));
+            objects.push_back(ObjectData(toRender->transform, materialIndex(*toRender)));
         }
+        objectBuffer.Upload(objects);
+        objectBuffer.UploadMaterials(materials);
 
-        // reset viewport
-        glViewport(0, 0, SCR_WIDTH, SCR_HEIGHT);
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-        //glCullFace(GL_BACK);
-
-        // 2. render scene as normal using the generated depth/shadow map  
-        // --------------------------------------------------------------
-        if (!showCascade){
-            dirLightTexShader.use();
-            // light properties
-            dirLightTexShader.setVec3("light.direction", dirLight->direction);
-            dirLightTexShader.setVec3("light.position",  dirLight->position);
-            dirLightTexShader.setVec3("light.ambient", dirLight->ambient);
-            dirLightTexShader.setVec3("light.diffuse", dirLight->diffuse);
-            dirLightTexShader.setVec3("light.specular", dirLight->specular);
-            glActiveTexture(GL_TEXTURE1);
-            glBindTexture(GL_TEXTURE_2D, mShadowMap[0]);
-            glActiveTexture(GL_TEXTURE2);
-            glBindTexture(GL_TEXTURE_2D, mShadowMap[1]);
-            glActiveTexture(GL_TEXTURE3);
-            glBindTexture(GL_TEXTURE_2D, mShadowMap[2]);
-            dirLightTexShader.setFloat("cascadeEndClipSpace[0]", mCascadeEndClipSpace[0]);
-            dirLightTexShader.setFloat("cascadeEndClipSpace[1]", mCascadeEndClipSpace[1]);
-            dirLightTexShader.setFloat("cascadeEndClipSpace[2]", mCascadeEndClipSpace[2]);
-            // view/projection transformations
-            dirLightTexShader.setVec3("viewPos", camera.Position);
-            dirLightTexShader.setMat4("projection", projection);
-            dirLightTexShader.setMat4("view", camera.GetViewMatrix());
-            dirLightTexShader.setMat4("FragPosLP[0]", mShadowMapProjs[0]);
-            dirLightTexShader.setMat4("FragPosLP[1]", mShadowMapProjs[1]);
-            dirLightTexShader.setMat4("FragPosLP[2]", mShadowMapProjs[2]);
-            for(auto& toRender: phongTexObjects) {
-                // material properties
-                dirLightTexShader.setVec3("material.ambient", toRender->ka);
-                dirLightTexShader.setVec3("material.diffuse", toRender->kd);
-                dirLightTexShader.setVec3("material.specular", toRender->ks); // specular lighting doesn't have full effect on this object's material
-                dirLightTexShader.setFloat("material.shininess", toRender->shininess);
-                dirLightTexShader.setMat4("model", toRender->transform);
-                // bind textures on corresponding texture units
-                glActiveTexture(GL_TEXTURE0);
-                glBindTexture(GL_TEXTURE_2D, toRender->textureId);
-                glBindVertexArray(toRender->VAO);
-                glDrawElements(GL_TRIANGLES, toRender->indexCount, GL_UNSIGNED_INT, 0);
-            }
+        // render loop
+        // -----------
+        while (!glfwWindowShouldClose(window))
+        {
+            // per-frame time logic
+            // --------------------
+            float currentFrame = glfwGetTime();
+            deltaTime = currentFrame - lastFrame;
+            lastFrame = currentFrame;
+
+            pMonitor.update(glfwGetTime());
+            stringstream ss;
+            ss << title << " " << pMonitor;
+            glfwSetWindowTitle(window, ss.str().c_str());
+
+            // input
+            // -----
+            processInput(window);
+        
+            // render
+            // ------
+            glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+            cameraProjInfo.fov = camera.Zoom;
+            glm::mat4 projection = glm::perspective(glm::radians(cameraProjInfo.fov), cameraProjInfo.width / cameraProjInfo.height, cameraProjInfo.zNear, cameraProjInfo.zFar);
 
-            // be sure to activate shader when setting uniforms/drawing objects
-            dirLightClrShader.use();
-            // light properties
-            dirLightClrShader.setVec3("light.direction", dirLight->direction);
-            dirLightClrShader.setVec3("light.position", dirLight->position);
-            dirLightClrShader.setVec3("light.ambient", dirLight->ambient);
-            dirLightClrShader.setVec3("light.diffuse", dirLight->diffuse);
-            dirLightClrShader.setVec3("light.specular", dirLight->specular);
-            glActiveTexture(GL_TEXTURE0);
-            glBindTexture(GL_TEXTURE_2D, mShadowMap[0]);
-            glActiveTexture(GL_TEXTURE1);
-            glBindTexture(GL_TEXTURE_2D, mShadowMap[1]);
-            glActiveTexture(GL_TEXTURE2);
-            glBindTexture(GL_TEXTURE_2D, mShadowMap[2]);
-            dirLightClrShader.setFloat("cascadeEndClipSpace[0]", mCascadeEndClipSpace[0]);
-            dirLightClrShader.setFloat("cascadeEndClipSpace[1]", mCascadeEndClipSpace[1]);
-            dirLightClrShader.setFloat("cascadeEndClipSpace[2]", mCascadeEndClipSpace[2]);
-            // view/projection transformations
-            dirLightClrShader.setVec3("viewPos", camera.Position);
-            dirLightClrShader.setMat4("projection", projection);
-            dirLightClrShader.setMat4("view", camera.GetViewMatrix());
-            dirLightClrShader.setMat4("FragPosLP[0]", mShadowMapProjs[0]);
-            dirLightClrShader.setMat4("FragPosLP[1]", mShadowMapProjs[1]);
-            dirLightClrShader.setMat4("FragPosLP[2]", mShadowMapProjs[2]);
-            for(auto& toRender: phongClrObjects) {
-                // material properties
-                dirLightClrShader.setVec3("material.ambient", toRender->ka);
-                dirLightClrShader.setVec3("material.diffuse", toRender->kd);
-                dirLightClrShader.setVec3("material.specular", toRender->ks); // specular lighting doesn't have full effect on this object's material
-                dirLightClrShader.setFloat("material.shininess", toRender->shininess);
-                dirLightClrShader.setVec3("color", toRender->color);
-                dirLightClrShader.setMat4("model", toRender->transform);
-                
-                // bind textures on corresponding texture units
-                glBindVertexArray(toRender->VAO);
-                glDrawElements(GL_TRIANGLES, toRender->indexCount, GL_UNSIGNED_INT, 0);
+            dirLight->position = camera.Position + camera.Front * 3.0f + camera.Up *6.0f;
+            dirLight->view = glm::lookAt(dirLight->position, dirLight->position + glm::normalize(dirLight->direction), glm::vec3(0.0, 1.0, 0.0));
+            dirLight->spaceMatrix = dirLight->projection * dirLight->view;
+
+
+            // 1. CALCULATE THE PROJECTION MATRIX FOR EACH CASCADE
+            for (unsigned int i = 0; i < NUM_CASCADES; i++) {
+                mCascadeEndClipSpace[i] = mCascadeEnd[i+1];
             }
-        }
-        else {
-            // debug render to show the cascade
-            cascadeDebugTexShader.use();
-
-            // light properties
-            cascadeDebugTexShader.setVec3("light.direction", dirLight->direction);
-            cascadeDebugTexShader.setVec3("light.position",  dirLight->position);
-            cascadeDebugTexShader.setVec3("light.ambient", dirLight->ambient);
-            cascadeDebugTexShader.setVec3("light.diffuse", dirLight->diffuse);
-            cascadeDebugTexShader.setVec3("light.specular", dirLight->specular);
-            glActiveTexture(GL_TEXTURE1);
-            glBindTexture(GL_TEXTURE_2D, mShadowMap[0]);
-            glActiveTexture(GL_TEXTURE2);
-            glBindTexture(GL_TEXTURE_2D, mShadowMap[1]);
-            glActiveTexture(GL_TEXTURE3);
-            glBindTexture(GL_TEXTURE_2D, mShadowMap[2]);
-            cascadeDebugTexShader.setFloat("cascadeEndClipSpace[0]", mCascadeEndClipSpace[0]);
-            cascadeDebugTexShader.setFloat("cascadeEndClipSpace[1]", mCascadeEndClipSpace[1]);
-            cascadeDebugTexShader.setFloat("cascadeEndClipSpace[2]", mCascadeEndClipSpace[2]);
-
-            // view/projection transformations
-            cascadeDebugTexShader.setVec3("viewPos", camera.Position);
-            glm::mat4 projection = glm::perspective(glm::radians(camera.Zoom), (float)SCR_WIDTH / (float)SCR_HEIGHT, cameraProjInfo.zNear, cameraProjInfo.zFar);
-            cascadeDebugTexShader.setMat4("projection", projection);
-            cascadeDebugTexShader.setMat4("view", camera.GetViewMatrix());
-            cascadeDebugTexShader.setMat4("FragPosLP[0]", mShadowMapProjs[0]);
-            cascadeDebugTexShader.setMat4("FragPosLP[1]", mShadowMapProjs[1]);
-            cascadeDebugTexShader.setMat4("FragPosLP[2]", mShadowMapProjs[2]);
-            for(auto& toRender: phongTexObjects) {
-                // material properties
-                cascadeDebugTexShader.setVec3("material.ambient", toRender->ka);
-                cascadeDebugTexShader.setVec3("material.diffuse", toRender->kd);
-                cascadeDebugTexShader.setVec3("material.specular", toRender->ks); // specular lighting doesn't have full effect on this object's material
-                cascadeDebugTexShader.setFloat("material.shininess", toRender->shininess);
-                cascadeDebugTexShader.setMat4("model", toRender->transform);
-                // bind textures on corresponding texture units
-                glActiveTexture(GL_TEXTURE0);
-                glBindTexture(GL_TEXTURE_2D, toRender->textureId);
-                glBindVertexArray(toRender->VAO);
-                glDrawElements(GL_TRIANGLES, toRender->indexCount, GL_UNSIGNED_INT, 0);
+            CalcOrthoProjs();
+
+            // camera, light and cascade data, read by all four lighting shaders from the shared blocks
+            cameraBlock.Upload(CameraBlock{ projection, camera.GetViewMatrix(), camera.Position });
+            CascadesBlock cascades = {};
+            cascades.direction = dirLight->direction;
+            cascades.ambient = dirLight->ambient;
+            cascades.diffuse = dirLight->diffuse;
+            cascades.specular = dirLight->specular;
+            for (unsigned int i = 0; i < NUM_CASCADES; i++) {
+                cascades.lightSpace[i] = mShadowMapProjs[i];
+                cascades.cascadeEndClipSpace[i].x = mCascadeEndClipSpace[i];
+            }
+            cascadesBlock.Upload(cascades);
+
+            // 2. RENDER DEPTH OF SCENE TO TEXTURE FOR EACH CASCADE
+            glm::mat4 lightView = glm::lookAt(dirLight->position, dirLight->position + glm::normalize(dirLight->direction), glm::vec3(0.0, 1.0, 0.0));
+            for (unsigned int i = 0 ; i < NUM_CASCADES ; i++) {
+                // Gen the proj and view matrix
+                // render the scene to the buffer
+                glViewport(0, 0, SHADOW_WIDTH, SHADOW_HEIGHT);
+                glBindFramebuffer(GL_DRAW_FRAMEBUFFER, mFbo);
+                glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, mShadowMap[i], 0);
+                glClear(GL_DEPTH_BUFFER_BIT);
+                depthMappingShader.use();
+                depthMappingShader.setMat4("lightSpaceMat", mShadowMapProjs[i]);
+                objectBuffer.Bind(depthMappingShader);
+                // Render the textured objects, then the colored ones
+                for(auto& [textureId, batch]: texBatches)
+                    batch.Submit();
+                clrBatch.Submit();
+                glBindFramebuffer(GL_FRAMEBUFFER, 0);
             }
 
-            // be sure to activate shader when setting uniforms/drawing objects
-            cascadeDebugClrShader.use();
-            // light properties
-            cascadeDebugClrShader.setVec3("light.direction", dirLight->direction);
-            cascadeDebugClrShader.setVec3("light.position", dirLight->position);
-            cascadeDebugClrShader.setVec3("light.ambient", dirLight->ambient);
-            cascadeDebugClrShader.setVec3("light.diffuse", dirLight->diffuse);
-            cascadeDebugClrShader.setVec3("light.specular", dirLight->specular);
-            glActiveTexture(GL_TEXTURE0);
-            glBindTexture(GL_TEXTURE_2D, mShadowMap[0]);
-            glActiveTexture(GL_TEXTURE1);
-            glBindTexture(GL_TEXTURE_2D, mShadowMap[1]);
-            glActiveTexture(GL_TEXTURE2);
-            glBindTexture(GL_TEXTURE_2D, mShadowMap[2]);
-            cascadeDebugClrShader.setFloat("cascadeEndClipSpace[0]", mCascadeEndClipSpace[0]);
-            cascadeDebugClrShader.setFloat("cascadeEndClipSpace[1]", mCascadeEndClipSpace[1]);
-            cascadeDebugClrShader.setFloat("cascadeEndClipSpace[2]", mCascadeEndClipSpace[2]);
-            // view/projection transformations
-            cascadeDebugClrShader.setVec3("viewPos", camera.Position);
-            cascadeDebugClrShader.setMat4("projection", projection);
-            cascadeDebugClrShader.setMat4("view", camera.GetViewMatrix());
-            cascadeDebugClrShader.setMat4("FragPosLP[0]", mShadowMapProjs[0]);
-            cascadeDebugClrShader.setMat4("FragPosLP[1]", mShadowMapProjs[1]);
-            cascadeDebugClrShader.setMat4("FragPosLP[2]", mShadowMapProjs[2]);
-            for(auto& toRender: phongClrObjects) {
-                // material properties
-                cascadeDebugClrShader.setVec3("material.ambient", toRender->ka);
-                cascadeDebugClrShader.setVec3("material.diffuse", toRender->kd);
-                cascadeDebugClrShader.setVec3("material.specular", toRender->ks); // specular lighting doesn't have full effect on this object's material
-                cascadeDebugClrShader.setFloat("material.shininess", toRender->shininess);
-                cascadeDebugClrShader.setVec3("color", toRender->color);
-                cascadeDebugClrShader.setMat4("model", toRender->transform);
-                
-                // bind textures on corresponding texture units
-                glBindVertexArray(toRender->VAO);
-                glDrawElements(GL_TRIANGLES, toRender->indexCount, GL_UNSIGNED_INT, 0);
+            // reset viewport
+            glViewport(0, 0, SCR_WIDTH, SCR_HEIGHT);
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+            //glCullFace(GL_BACK);
+
+            // 2. render scene as normal using the generated depth/shadow map  
+            // --------------------------------------------------------------
+            if (!showCascade){
+                dirLightTexShader.use();
+                GLState::Get().ActiveTexture(GL_TEXTURE1);
+                GLState::Get().BindTexture(GL_TEXTURE_2D, mShadowMap[0]);
+                GLState::Get().ActiveTexture(GL_TEXTURE2);
+                GLState::Get().BindTexture(GL_TEXTURE_2D, mShadowMap[1]);
+                GLState::Get().ActiveTexture(GL_TEXTURE3);
+                GLState::Get().BindTexture(GL_TEXTURE_2D, mShadowMap[2]);
+                objectBuffer.Bind(dirLightTexShader);
+                for(auto& [textureId, batch]: texBatches) {
+                    // bind textures on corresponding texture units
+                    GLState::Get().ActiveTexture(GL_TEXTURE0);
+                    GLState::Get().BindTexture(GL_TEXTURE_2D, textureId);
+                    batch.Submit();
+                }
+
+                // be sure to activate shader when setting uniforms/drawing objects
+                dirLightClrShader.use();
+                GLState::Get().ActiveTexture(GL_TEXTURE0);
+                GLState::Get().BindTexture(GL_TEXTURE_2D, mShadowMap[0]);
+                GLState::Get().ActiveTexture(GL_TEXTURE1);
+                GLState::Get().BindTexture(GL_TEXTURE_2D, mShadowMap[1]);
+                GLState::Get().ActiveTexture(GL_TEXTURE2);
+                GLState::Get().BindTexture(GL_TEXTURE_2D, mShadowMap[2]);
+                objectBuffer.Bind(dirLightClrShader);
+                clrBatch.Submit();
+            }
+            else {
+                // debug render to show the cascade
+                cascadeDebugTexShader.use();
+                GLState::Get().ActiveTexture(GL_TEXTURE1);
+                GLState::Get().BindTexture(GL_TEXTURE_2D, mShadowMap[0]);
+                GLState::Get().ActiveTexture(GL_TEXTURE2);
+                GLState::Get().BindTexture(GL_TEXTURE_2D, mShadowMap[1]);
+                GLState::Get().ActiveTexture(GL_TEXTURE3);
+                GLState::Get().BindTexture(GL_TEXTURE_2D, mShadowMap[2]);
+                objectBuffer.Bind(cascadeDebugTexShader);
+                for(auto& [textureId, batch]: texBatches) {
+                    // bind textures on corresponding texture units
+                    GLState::Get().ActiveTexture(GL_TEXTURE0);
+                    GLState::Get().BindTexture(GL_TEXTURE_2D, textureId);
+                    batch.Submit();
+                }
+
+                // be sure to activate shader when setting uniforms/drawing objects
+                cascadeDebugClrShader.use();
+                GLState::Get().ActiveTexture(GL_TEXTURE0);
+                GLState::Get().BindTexture(GL_TEXTURE_2D, mShadowMap[0]);
+                GLState::Get().ActiveTexture(GL_TEXTURE1);
+                GLState::Get().BindTexture(GL_TEXTURE_2D, mShadowMap[1]);
+                GLState::Get().ActiveTexture(GL_TEXTURE2);
+                GLState::Get().BindTexture(GL_TEXTURE_2D, mShadowMap[2]);
+                objectBuffer.Bind(cascadeDebugClrShader);
+                clrBatch.Submit();
             }
-        }
 
-        if (depthMapRendered > 0) {
-            depthDebugShader.use();
-            glActiveTexture(GL_TEXTURE0);
-            switch (depthMapRendered)
-            {
-            case 1:
-                glBindTexture(GL_TEXTURE_2D, mShadowMap[0]);
-                break;
-            case 2:
-                glBindTexture(GL_TEXTURE_2D, mShadowMap[1]);
-                break;
-            case 3:
-                glBindTexture(GL_TEXTURE_2D, mShadowMap[2]);
-                break;
+            if (depthMapRendered > 0) {
+                depthDebugShader.use();
+                GLState::Get().ActiveTexture(GL_TEXTURE0);
+                switch (depthMapRendered)
+                {
+                case 1:
+                    GLState::Get().BindTexture(GL_TEXTURE_2D, mShadowMap[0]);
+                    break;
+                case 2:
+                    GLState::Get().BindTexture(GL_TEXTURE_2D, mShadowMap[1]);
+                    break;
+                case 3:
+                    GLState::Get().BindTexture(GL_TEXTURE_2D, mShadowMap[2]);
+                    break;
             
-            default:
-                glBindTexture(GL_TEXTURE_2D, dirLight->depthMap);
-                break;
+                default:
+                    GLState::Get().BindTexture(GL_TEXTURE_2D, dirLight->depthMap);
+                    break;
+                }
+                depthDebugShader.setBool("orthographic", true);
+                depthDebugShader.setFloat("nearPlane", dirLight->nearPlane);
+                depthDebugShader.setFloat("farPlane", dirLight->farPlane);
+                arena.Bind(depthQuad->geometry);
+                arena.Draw(depthQuad->geometry);
             }
-            depthDebugShader.setBool("orthographic", true);
-            depthDebugShader.setFloat("nearPlane", dirLight->nearPlane);
-            depthDebugShader.setFloat("farPlane", dirLight->farPlane);
-            glBindVertexArray(depthQuad->VAO);
-            glDrawElements(GL_TRIANGLES, depthQuad->indexCount, GL_UNSIGNED_INT, 0);
+
+            // glfw: swap buffers and poll IO events (keys pressed/released, mouse moved etc.)
+            // -------------------------------------------------------------------------------
+            glfwSwapBuffers(window);
+            glfwPollEvents();
         }
 
-        // glfw: swap buffers and poll IO events (keys pressed/released, mouse moved etc.)
-        // -------------------------------------------------------------------------------
-        glfwSwapBuffers(window);
-        glfwPollEvents();
-    }
-
-    // optional: de-allocate all resources once they've outlived their purpose:
-    // ------------------------------------------------------------------------
-    for(auto& toRender: phongTexObjects) {
-        glDeleteVertexArrays(1, &toRender->VAO);
-        glDeleteBuffers(1, &toRender->VBO);
-    }
-    for(auto& toRender: phongClrObjects) {
-        glDeleteVertexArrays(1, &toRender->VAO);
-        glDeleteBuffers(1, &toRender->VBO);
-    }
-    for(auto& toRender: coloredObjects) {
-        glDeleteVertexArrays(1, &toRender->VAO);
-        glDeleteBuffers(1, &toRender->VBO);
+        // optional: de-allocate all resources once they've outlived their purpose:
+        // ------------------------------------------------------------------------
+        for(auto& toRender: phongTexObjects)
+            arena.Free(toRender->geometry);
+        for(auto& toRender: phongClrObjects)
+            arena.Free(toRender->geometry);
+        for(auto& toRender: coloredObjects)
+            arena.Free(toRender->geometry);
+        arena.Free(depthQuad->geometry);
     }
 
     // glfw: terminate, clearing all previously allocated GLFW resources.
@@ -673,7 +626,6 @@ void scroll_callback(GLFWwindow* window, double xoffset, double yoffset)
 RenderObjectPtr createTexCube(string path, float texScale, glm::vec3 ka, glm::vec3 kd, glm::vec3 ks, float shnss)
 {
     RenderObjectPtr cubeObject = make_shared<RenderObject>();
-    unsigned int cubeEBO;
     float vertices[] = {
         -0.5f, -0.5f, -0.5f,  0.0f,  0.0f, -1.0f, 0.0f, texScale,
          0.5f, -0.5f, -0.5f,  0.0f,  0.0f, -1.0f, texScale, texScale,
@@ -713,31 +665,11 @@ RenderObjectPtr createTexCube(string path, float texScale, glm::vec3 ka, glm::ve
         16, 17, 18,  18, 19, 16,
         20, 22, 21,  22, 20, 23        
     };
-    glGenVertexArrays(1, &cubeObject->VAO);
-    glGenBuffers(1, &cubeObject->VBO);
-    glGenBuffers(1, &cubeEBO);
-    // bind the Vertex Array Object first, then bind and set vertex buffer(s), and then configure vertex attributes(s).
-    glBindVertexArray(cubeObject->VAO);
-    glBindBuffer(GL_ARRAY_BUFFER, cubeObject->VBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, cubeEBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-
-    // position attribute
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-    // normal attribute
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
-    // texture coord attribute
-    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(6 * sizeof(float)));
-    glEnableVertexAttribArray(2);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
+    // position, normal and texture coords, in the arena's buffers for that layout
+    cubeObject->geometry = GeometryArena::Get().Allocate(VertexFormat::Floats({ 3, 3, 2 }), vertices, 24, indices, 36);
     // load and create a texture 
     cubeObject->textureId = loadTexture(getPath(path).string().c_str(), false);
     cubeObject->transform = glm::mat4(1.0f);
-    cubeObject->indexCount = 36;
     cubeObject->ka = ka;
     cubeObject->kd = kd;
     cubeObject->ks = ks;
@@ -748,7 +680,6 @@ RenderObjectPtr createTexCube(string path, float texScale, glm::vec3 ka, glm::ve
 RenderObjectPtr createClrCube(glm::vec3 color, glm::vec3 ka, glm::vec3 kd, glm::vec3 ks, float shnss)
 {
     RenderObjectPtr cubeObject = make_shared<RenderObject>();
-    unsigned int cubeEBO;
     float vertices[] = {
         -0.5f, -0.5f, -0.5f,  0.0f,  0.0f, -1.0f,
          0.5f, -0.5f, -0.5f,  0.0f,  0.0f, -1.0f,
@@ -788,26 +719,9 @@ RenderObjectPtr createClrCube(glm::vec3 color, glm::vec3 ka, glm::vec3 kd, glm::
         16, 17, 18,  18, 19, 16,
         20, 22, 21,  22, 20, 23            
     };
-    glGenVertexArrays(1, &cubeObject->VAO);
-    glGenBuffers(1, &cubeObject->VBO);
-    glGenBuffers(1, &cubeEBO);
-    // bind the Vertex Array Object first, then bind and set vertex buffer(s), and then configure vertex attributes(s).
-    glBindVertexArray(cubeObject->VAO);
-    glBindBuffer(GL_ARRAY_BUFFER, cubeObject->VBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, cubeEBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-
-    // position attribute
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-    // normal attribute
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
+    // position and normal
+    cubeObject->geometry = GeometryArena::Get().Allocate(VertexFormat::Floats({ 3, 3 }), vertices, 24, indices, 36);
     cubeObject->transform = glm::mat4(1.0f);
-    cubeObject->indexCount = 36;
     cubeObject->ka = ka;
     cubeObject->kd = kd;
     cubeObject->ks = ks;
@@ -862,16 +776,11 @@ RenderObjectPtr createLightCube(glm::vec3 pos)
         -0.5f,  0.5f, -0.5f,  0.0f,  1.0f,  0.0f,
         -0.5f,  0.5f,  0.5f,  0.0f,  1.0f,  0.0f
     };
-    // first, configure the cube's VAO (and VBO)
-    glGenVertexArrays(1, &lightObject->VAO);
-    glGenBuffers(1, &lightObject->VBO);
-    glBindBuffer(GL_ARRAY_BUFFER, lightObject->VBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
-    glBindVertexArray(lightObject->VAO);
-    // note that we update the lamp's position attribute's stride to reflect the updated buffer data
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-    lightObject->indexCount = 36;
+    // not indexed: every vertex is used once, in order
+    unsigned int indices[36];
+    for (unsigned int i = 0; i < 36; i++)
+        indices[i] = i;
+    lightObject->geometry = GeometryArena::Get().Allocate(VertexFormat::Floats({ 3, 3 }), vertices, 36, indices, 36);
     lightObject->transform = glm::translate(glm::mat4(1.0f), pos);
     lightObject->transform = glm::scale(lightObject->transform, glm::vec3(0.2f)); // a smaller cube;
     lightObject->color = glm::vec3(1.0f);
@@ -881,7 +790,6 @@ RenderObjectPtr createLightCube(glm::vec3 pos)
 RenderObjectPtr createTexQuad()
 {
     RenderObjectPtr cubeObject = make_shared<RenderObject>();
-    unsigned int cubeEBO;
     float vertices[] = {
         -1.0f, -1.0f, 0.0f,  0.0f, 0.0f,
          1.0f, -1.0f, 0.0f,  1.0f, 0.0f,
@@ -891,27 +799,10 @@ RenderObjectPtr createTexQuad()
     unsigned int indices[] = {
         0, 1, 2,     2, 3, 0  
     };
-    glGenVertexArrays(1, &cubeObject->VAO);
-    glGenBuffers(1, &cubeObject->VBO);
-    glGenBuffers(1, &cubeEBO);
-    // bind the Vertex Array Object first, then bind and set vertex buffer(s), and then configure vertex attributes(s).
-    glBindVertexArray(cubeObject->VAO);
-    glBindBuffer(GL_ARRAY_BUFFER, cubeObject->VBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, cubeEBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-
-    // position attribute
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-    // texture coord attribute
-    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
+    // position and texture coords
+    cubeObject->geometry = GeometryArena::Get().Allocate(VertexFormat::Floats({ 3, 2 }), vertices, 4, indices, 6);
     cubeObject->transform = glm::mat4(1.0f);
     //cubeObject->transform = glm::scale(glm::mat4(1.0f), glm::vec3(2.0f*(float)SCR_HEIGHT/(float)SCR_WIDTH, 2.0f, 1.0f));
-    cubeObject->indexCount = 6;
     return cubeObject;
 }
 
@@ -919,48 +810,10 @@ RenderObjectPtr createTexQuad()
 // ---------------------------------------------------
 unsigned int loadTexture(char const * path, bool gammaCorrection)
 {
-    unsigned int textureID;
-    glGenTextures(1, &textureID);
-
-    int width, height, nrComponents;
-    unsigned char *data = stbi_load(path, &width, &height, &nrComponents, 0);
-    if (data)
-    {
-        GLenum internalFormat;
-        GLenum dataFormat;
-        if (nrComponents == 1)
-        {
-            internalFormat = dataFormat = GL_RED;
-        }
-        else if (nrComponents == 3)
-        {
-            internalFormat = gammaCorrection ? GL_SRGB : GL_RGB;
-            dataFormat = GL_RGB;
-        }
-        else if (nrComponents == 4)
-        {
-            internalFormat = gammaCorrection ? GL_SRGB_ALPHA : GL_RGBA;
-            dataFormat = GL_RGBA;
-        }
-
-        glBindTexture(GL_TEXTURE_2D, textureID);
-        glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, width, height, 0, dataFormat, GL_UNSIGNED_BYTE, data);
-        glGenerateMipmap(GL_TEXTURE_2D);
-
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-        stbi_image_free(data);
-    }
-    else
-    {
-        std::cout << "Texture failed to load at path: " << path << std::endl;
-        stbi_image_free(data);
-    }
-
-    return textureID;
+    // the cache decodes each image once, however many objects use it
+    TextureSettings settings;
+    settings.gammaCorrection = gammaCorrection;
+    return TextureCache::Get().Load(path, settings);
 }
 
 glm::mat4 getOrthoProj(OrthoProjInfo& info)
@@ -2,20 +2,20 @@
 
 #include <vector>
 #include <map>
+#include <memory>
 #include <glm/glm.hpp>
 #include <assimp/scene.h>
+#include <assimp/config.h>
 #include "bone.hpp"
 #include <functional>
 #include "animdata.hpp"
+#include "skeleton.hpp"
 #include "model.hpp"
 
-struct AssimpNodeData
-{
-	glm::mat4 transformation;
-	std::string name;
-	int childrenCount;
-	std::vector<AssimpNodeData> children;
-};
+/* Import flags for files that are only read for their clips: no mesh
+   post-processing, and meshes/materials are dropped right after parsing */
+#define ANIMATION_IMPORT_FLAGS aiProcess_RemoveComponent
+#define ANIMATION_IMPORT_REMOVED_COMPONENTS (aiComponent_MESHES | aiComponent_MATERIALS | aiComponent_TEXTURES | aiComponent_LIGHTS | aiComponent_CAMERAS)
 
 class Animation
 {
@@ -23,37 +23,40 @@ public:
 	Animation() = default;
 
 	Animation(const std::string& animationPath, Model* model)
+		: Animation(animationPath, model, 0)
 	{
-		Assimp::Importer importer;
-		const aiScene* scene = importer.ReadFile(animationPath, aiProcess_Triangulate);
-		assert(scene && scene->mRootNode);
-		auto animation = scene->mAnimations[0];
-		m_Duration = animation->mDuration;
-		m_TicksPerSecond = animation->mTicksPerSecond;
-		aiMatrix4x4 globalTransformation = scene->mRootNode->mTransformation;
-		globalTransformation = globalTransformation.Inverse();
-		ReadHeirarchyData(m_RootNode, scene->mRootNode);
-		ReadMissingBones(animation, *model);
 	}
 
-    Animation(const std::string& animationPath, Model* model, unsigned int index)
+	Animation(const std::string& animationPath, Model* model, unsigned int index)
 	{
 		Assimp::Importer importer;
-		const aiScene* scene = importer.ReadFile(animationPath, aiProcess_Triangulate);
-		assert(scene && scene->mRootNode);
-		auto animation = scene->mAnimations[index];
-		m_Duration = animation->mDuration;
-		m_TicksPerSecond = animation->mTicksPerSecond;
-		aiMatrix4x4 globalTransformation = scene->mRootNode->mTransformation;
-		globalTransformation = globalTransformation.Inverse();
-		ReadHeirarchyData(m_RootNode, scene->mRootNode);
-		ReadMissingBones(animation, *model);
+		const aiScene* scene = ImportAnimations(importer, animationPath);
+		assert(scene && scene->mRootNode && index < scene->mNumAnimations);
+		auto skeleton = std::make_shared<Skeleton>(scene->mRootNode, model->GetBoneInfoMap());
+		ReadAnimation(scene->mAnimations[index], skeleton, *model);
+	}
+
+	/* Builds a clip on top of a skeleton shared with the other clips of the
+	   same model (see AnimationLibrary) */
+	Animation(const aiAnimation* animation, std::shared_ptr<Skeleton> skeleton, Model* model)
+	{
+		ReadAnimation(animation, skeleton, *model);
 	}
 
 	~Animation()
 	{
 	}
 
+	/* Reads a file for its animations only, skipping every mesh post-process step */
+	static const aiScene* ImportAnimations(Assimp::Importer& importer, const std::string& path)
+	{
+		importer.SetPropertyInteger(AI_CONFIG_PP_RVC_FLAGS, ANIMATION_IMPORT_REMOVED_COMPONENTS);
+		const aiScene* scene = importer.ReadFile(path, ANIMATION_IMPORT_FLAGS);
+		if (!scene || !scene->mRootNode)
+			cout << "ERROR::ASSIMP:: " << importer.GetErrorString() << endl;
+		return scene;
+	}
+
 	Bone* FindBone(const std::string& name)
 	{
 		auto iter = std::find_if(m_Bones.begin(), m_Bones.end(),
@@ -69,13 +72,43 @@ public:
 	
 	inline float GetTicksPerSecond() { return m_TicksPerSecond; }
 	inline float GetDuration() { return m_Duration;}
-	inline const AssimpNodeData& GetRootNode() { return m_RootNode; }
+	inline const std::string& GetName() const { return m_Name; }
 	inline const std::map<std::string,BoneInfo>& GetBoneIDMap() 
 	{ 
-		return m_BoneInfoMap;
+		return m_Model->GetBoneInfoMap();
+	}
+	inline const Skeleton& GetSkeleton() const { return *m_Skeleton; }
+	/* channel (index in GetBones) animating each skeleton node, -1 if the node isn't animated */
+	inline const std::vector<int>& GetNodeChannels() const { return m_NodeChannels; }
+	inline const std::vector<Bone>& GetBones() const { return m_Bones; }
+
+	// compresses the keys of every channel, see Bone::Compress
+	void Compress(const KeyCompressionSettings& settings = KeyCompressionSettings())
+	{
+		for (auto& bone : m_Bones)
+			bone.Compress(settings);
+	}
+
+	size_t GetKeyByteSize() const
+	{
+		size_t size = 0;
+		for (const auto& bone : m_Bones)
+			size += bone.GetKeyByteSize();
+		return size;
 	}
 
 private:
+	void ReadAnimation(const aiAnimation* animation, std::shared_ptr<Skeleton> skeleton, Model& model)
+	{
+		m_Name = animation->mName.C_Str();
+		m_Duration = animation->mDuration;
+		m_TicksPerSecond = animation->mTicksPerSecond;
+		m_Model = &model;
+		m_Skeleton = skeleton;
+		ReadMissingBones(animation, model);
+		ResolveNodeChannels();
+	}
+
 	void ReadMissingBones(const aiAnimation* animation, Model& model)
 	{
 		int size = animation->mNumChannels;
@@ -92,34 +125,35 @@ private:
 			if (boneInfoMap.find(boneName) == boneInfoMap.end())
 			{
 				boneInfoMap[boneName].id = boneCount;
+				boneInfoMap[boneName].offset = glm::mat4(1.0f);
 				boneCount++;
 			}
 			m_Bones.push_back(Bone(channel->mNodeName.data,
 				boneInfoMap[channel->mNodeName.data].id, channel));
 		}
 
-		m_BoneInfoMap = boneInfoMap;
+		// the channels may have added bones, keep the shared skeleton in sync
+		m_Skeleton->ResolveBones(boneInfoMap);
 	}
 
-	void ReadHeirarchyData(AssimpNodeData& dest, const aiNode* src)
+	/* Resolves the channel of every node once, so the animator never has to
+	   search bones by name while playing */
+	void ResolveNodeChannels()
 	{
-		assert(src);
-
-		dest.name = src->mName.data;
-		dest.transformation = AssimpGLMHelpers::ConvertMatrixToGLMFormat(src->mTransformation);
-		dest.childrenCount = src->mNumChildren;
-
-		for (int i = 0; i < src->mNumChildren; i++)
+		m_NodeChannels.assign(m_Skeleton->GetNodeCount(), -1);
+		for (int channel = 0; channel < static_cast<int>(m_Bones.size()); channel++)
 		{
-			AssimpNodeData newData;
-			ReadHeirarchyData(newData, src->mChildren[i]);
-			dest.children.push_back(newData);
+			int node = m_Skeleton->FindNode(m_Bones[channel].GetBoneName());
+			if (node >= 0)
+				m_NodeChannels[node] = channel;
 		}
 	}
+
 	float m_Duration;
 	int m_TicksPerSecond;
+	std::string m_Name;
 	std::vector<Bone> m_Bones;
-	AssimpNodeData m_RootNode;
-	std::map<std::string, BoneInfo> m_BoneInfoMap;
+	Model* m_Model;
+	std::shared_ptr<Skeleton> m_Skeleton;
+	std::vector<int> m_NodeChannels;
 };
-
@@ -0,0 +1,132 @@
+#pragma once
+
+/* Owns the animation clips of a scene. Each file is imported once and every
+   aiAnimation in it becomes a clip; all the clips that drive the same model
+   share a single flattened skeleton instead of each keeping its own copy of
+   the node hierarchy and bone map. Clips of one model are expected to target
+   the same rig, as with clips exported from the same character. */
+
+#include <vector>
+#include <map>
+#include <memory>
+#include <string>
+#include <assimp/Importer.hpp>
+#include <assimp/scene.h>
+#include "animation.hpp"
+#include "model.hpp"
+
+class AnimationLibrary
+{
+public:
+	/* Imports only the clips of a file, without any mesh processing, and
+	   binds them to model. Returns the number of clips added. */
+	int Load(const std::string& path, Model* model)
+	{
+		if (IsLoaded(path))
+			return 0;
+
+		Assimp::Importer importer;
+		const aiScene* scene = Animation::ImportAnimations(importer, path);
+		if (!scene || !scene->mRootNode)
+			return 0;
+		return AddClips(scene, path, model);
+	}
+
+	/* For files that hold both the mesh and its clips: imports the file a
+	   single time, builds the model from it and adds every clip. The library
+	   owns the returned model. */
+	Model* LoadModel(const std::string& path, bool gamma = false)
+	{
+		Assimp::Importer importer;
+		const aiScene* scene = importer.ReadFile(path, MODEL_IMPORT_FLAGS);
+		if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode)
+		{
+			cout << "ERROR::ASSIMP:: " << importer.GetErrorString() << endl;
+			return nullptr;
+		}
+
+		m_Models.push_back(std::make_unique<Model>(scene, path, gamma));
+		Model* model = m_Models.back().get();
+		if (!IsLoaded(path))
+			AddClips(scene, path, model);
+		return model;
+	}
+
+	// clip by position in its file, nullptr if it wasn't loaded
+	Animation* Get(const std::string& path, unsigned int index)
+	{
+		for (auto& clip : m_Clips)
+		{
+			if (clip.path == path && clip.index == index)
+				return clip.animation.get();
+		}
+		return nullptr;
+	}
+
+	// clip by the name stored in the file, nullptr if there is none
+	Animation* Get(const std::string& name)
+	{
+		for (auto& clip : m_Clips)
+		{
+			if (clip.animation->GetName() == name)
+				return clip.animation.get();
+		}
+		return nullptr;
+	}
+
+	inline int GetClipCount() const { return static_cast<int>(m_Clips.size()); }
+	inline Animation* GetClip(int i) { return m_Clips[i].animation.get(); }
+
+	// compresses every clip loaded so far, see Bone::Compress
+	void Compress(const KeyCompressionSettings& settings = KeyCompressionSettings())
+	{
+		for (auto& clip : m_Clips)
+			clip.animation->Compress(settings);
+	}
+
+	std::shared_ptr<Skeleton> GetSkeleton(const Model* model) const
+	{
+		auto iter = m_Skeletons.find(model);
+		return iter != m_Skeletons.end() ? iter->second : nullptr;
+	}
+
+private:
+	struct Clip
+	{
+		std::string path;
+		unsigned int index;
+		std::unique_ptr<Animation> animation;
+	};
+
+	bool IsLoaded(const std::string& path) const
+	{
+		for (const auto& clip : m_Clips)
+		{
+			if (clip.path == path)
+				return true;
+		}
+		return false;
+	}
+
+	int AddClips(const aiScene* scene, const std::string& path, Model* model)
+	{
+		std::shared_ptr<Skeleton>& skeleton = m_Skeletons[model];
+		if (!skeleton)
+			skeleton = std::make_shared<Skeleton>(scene->mRootNode, model->GetBoneInfoMap());
+
+		for (unsigned int i = 0; i < scene->mNumAnimations; i++)
+		{
+			Clip clip;
+			clip.path = path;
+			clip.index = i;
+			clip.animation = std::make_unique<Animation>(scene->mAnimations[i], skeleton, model);
+			m_Clips.push_back(std::move(clip));
+		}
+		return static_cast<int>(scene->mNumAnimations);
+	}
+
+	// unique_ptr keeps the Animation and Model addresses stable for the animators
+	std::vector<Clip> m_Clips;
+	std::vector<std::unique_ptr<Model>> m_Models;
+	std::map<const Model*, std::shared_ptr<Skeleton>> m_Skeletons;
+};
@@ -0,0 +1,91 @@
+#pragma once
+
+/* Picks how often each animator evaluates its pose from how large the
+   character is on screen, and whether it is visible at all. Small or distant
+   characters update at a lower rate, with their palette blended between
+   updates (see Animator::SetUpdateInterval), and characters outside the view
+   update at a token rate or not at all. */
+
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include <glm/glm.hpp>
+#include "animator.hpp"
+
+class AnimationLodPolicy
+{
+public:
+	/* Characters covering at least minScreenSize (fraction of the screen
+	   height) evaluate their pose updateRate times per second; 0 means every
+	   frame. Characters smaller than every level use the smallest one. */
+	void AddLevel(float minScreenSize, float updateRate)
+	{
+		m_Levels.push_back({ minScreenSize, updateRate });
+		std::sort(m_Levels.begin(), m_Levels.end(),
+			[](const Level& a, const Level& b) { return a.minScreenSize > b.minScreenSize; });
+	}
+
+	// updates per second for characters out of view, 0 stops their evaluation
+	void SetOffscreenRate(float updateRate)
+	{
+		m_OffscreenRate = updateRate;
+	}
+
+	// interval for Animator::SetUpdateInterval
+	float GetUpdateInterval(float screenSize, bool visible) const
+	{
+		if (!visible)
+			return m_OffscreenRate > 0.0f ? 1.0f / m_OffscreenRate : -1.0f;
+
+		float rate = 0.0f;
+		for (const auto& level : m_Levels)
+		{
+			rate = level.updateRate;
+			if (screenSize >= level.minScreenSize)
+				break;
+		}
+		return rate > 0.0f ? 1.0f / rate : 0.0f;
+	}
+
+	void Apply(Animator& animator, float screenSize, bool visible) const
+	{
+		animator.SetUpdateInterval(GetUpdateInterval(screenSize, visible));
+	}
+
+	/* Approximate fraction of the screen height covered by a bounding sphere
+	   of the given radius, seen from distance with a vertical field of view */
+	static float ScreenSize(float radius, float distance, float fovY)
+	{
+		if (distance <= radius)
+			return 1.0f;
+		return radius / (distance * std::tan(fovY * 0.5f));
+	}
+
+	// bounding sphere against the six planes of a view projection matrix
+	static bool IsVisible(const glm::mat4& viewProjection, const glm::vec3& center, float radius)
+	{
+		glm::vec4 rowX(viewProjection[0][0], viewProjection[1][0], viewProjection[2][0], viewProjection[3][0]);
+		glm::vec4 rowY(viewProjection[0][1], viewProjection[1][1], viewProjection[2][1], viewProjection[3][1]);
+		glm::vec4 rowZ(viewProjection[0][2], viewProjection[1][2], viewProjection[2][2], viewProjection[3][2]);
+		glm::vec4 rowW(viewProjection[0][3], viewProjection[1][3], viewProjection[2][3], viewProjection[3][3]);
+		glm::vec4 planes[6] = { rowW + rowX, rowW - rowX, rowW + rowY, rowW - rowY, rowW + rowZ, rowW - rowZ };
+
+		for (const auto& plane : planes)
+		{
+			float length = glm::length(glm::vec3(plane));
+			if (glm::dot(glm::vec3(plane), center) + plane.w < -radius * length)
+				return false;
+		}
+		return true;
+	}
+
+private:
+	struct Level
+	{
+		float minScreenSize;
+		float updateRate;
+	};
+
+	std::vector<Level> m_Levels;
+	float m_OffscreenRate = 0.0f;
+};
@@ -3,10 +3,13 @@
 #include <glm/glm.hpp>
 #include <map>
 #include <vector>
+#include <span>
+#include <algorithm>
 #include <assimp/scene.h>
 #include <assimp/Importer.hpp>
 #include "animation.hpp"
 #include "bone.hpp"
+#include "trsSampler.hpp"
 
 class Animator
 {
@@ -15,21 +18,49 @@ public:
 	{
 		m_CurrentTime = 0.0;
 		m_CurrentAnimation = animation;
+		m_UpdateInterval = 0.0f;
+		m_SinceUpdate = 0.0f;
+		m_HasPose = false;
 
 		m_FinalBoneMatrices.reserve(100);
 
 		for (int i = 0; i < 100; i++)
 			m_FinalBoneMatrices.push_back(glm::mat4(1.0f));
+
+		PrepareSkeleton();
 	}
 
 	void UpdateAnimation(float dt)
+	{
+		UpdateAnimation(dt, m_FinalBoneMatrices.data(), static_cast<int>(m_FinalBoneMatrices.size()));
+	}
+
+	/* Same as UpdateAnimation(dt), but the bone palette is written to external
+	   storage of paletteSize matrices instead of GetFinalBoneMatrices(). Only
+	   touches this animator's own state, so different animators can be updated
+	   from different threads, even when they play the same Animation. */
+	void UpdateAnimation(float dt, glm::mat4* palette, int paletteSize)
 	{
 		m_DeltaTime = dt;
-		if (m_CurrentAnimation)
+		if (!m_CurrentAnimation)
+			return;
+
+		m_CurrentTime += m_CurrentAnimation->GetTicksPerSecond() * dt;
+		m_CurrentTime = fmod(m_CurrentTime, m_CurrentAnimation->GetDuration());
+
+		if (m_UpdateInterval == 0.0f)
+		{
+			CalculateBoneTransforms(palette, paletteSize);
+			m_HasPose = false;
+		}
+		else if (m_UpdateInterval < 0.0f)
+		{
+			// paused pose: the clip keeps playing but the palette keeps its last pose
+			m_HasPose = false;
+		}
+		else
 		{
-			m_CurrentTime += m_CurrentAnimation->GetTicksPerSecond() * dt;
-			m_CurrentTime = fmod(m_CurrentTime, m_CurrentAnimation->GetDuration());
-			CalculateBoneTransform(&m_CurrentAnimation->GetRootNode(), glm::mat4(1.0f));
+			UpdateInterpolated(dt, palette, paletteSize);
 		}
 	}
 
@@ -37,44 +68,129 @@ public:
 	{
 		m_CurrentAnimation = pAnimation;
 		m_CurrentTime = 0.0f;
+		m_HasPose = false;
+		PrepareSkeleton();
 	}
 
-	void CalculateBoneTransform(const AssimpNodeData* node, glm::mat4 parentTransform)
+	/* Seconds between pose evaluations. 0 evaluates every update; a positive
+	   interval evaluates one pose ahead and blends the palette towards it in
+	   the updates in between; a negative one stops evaluating and leaves the
+	   last palette in place (e.g. for characters that are off screen). */
+	void SetUpdateInterval(float seconds)
 	{
-		std::string nodeName = node->name;
-		glm::mat4 nodeTransform = node->transformation;
+		m_UpdateInterval = seconds;
+	}
 
-		Bone* Bone = m_CurrentAnimation->FindBone(nodeName);
+	inline float GetUpdateInterval() const { return m_UpdateInterval; }
 
-		if (Bone)
-		{
-			Bone->Update(m_CurrentTime);
-			nodeTransform = Bone->GetLocalTransform();
-		}
+	/* Evaluates the whole pose in one pass over the flattened skeleton. All
+	   channels are sampled first as one SIMD batch; then parents come before
+	   their children, so each node only needs its parent's global transform,
+	   which was already written earlier in the same loop. */
+	void CalculateBoneTransforms(glm::mat4* palette, int paletteSize)
+	{
+		CalculateBoneTransforms(m_CurrentTime, palette, paletteSize);
+	}
+
+	void CalculateBoneTransforms(float time, glm::mat4* palette, int paletteSize)
+	{
+		const auto& nodes = m_CurrentAnimation->GetSkeleton().GetNodes();
+		const auto& channels = m_CurrentAnimation->GetNodeChannels();
+		const auto& bones = m_CurrentAnimation->GetBones();
 
-		glm::mat4 globalTransformation = parentTransform * nodeTransform;
+		for (int channel = 0; channel < static_cast<int>(bones.size()); channel++)
+			bones[channel].Gather(time, m_Cursors[channel], m_SampleBatch, channel);
+		TRSSampler::Sample(m_SampleBatch, m_LocalTransforms.data());
 
-		auto boneInfoMap = m_CurrentAnimation->GetBoneIDMap();
-		if (boneInfoMap.find(nodeName) != boneInfoMap.end())
+		for (size_t i = 0; i < nodes.size(); i++)
 		{
-			int index = boneInfoMap[nodeName].id;
-			glm::mat4 offset = boneInfoMap[nodeName].offset;
-			m_FinalBoneMatrices[index] = globalTransformation * offset;
+			const SkeletonNode& node = nodes[i];
+			int channel = channels[i];
+			const glm::mat4& nodeTransform = channel >= 0 ? m_LocalTransforms[channel] : node.transformation;
+
+			if (node.parent >= 0)
+				m_GlobalTransforms[i] = m_GlobalTransforms[node.parent] * nodeTransform;
+			else
+				m_GlobalTransforms[i] = nodeTransform;
+
+			if (node.boneIndex >= 0 && node.boneIndex < paletteSize)
+				palette[node.boneIndex] = m_GlobalTransforms[i] * node.offset;
 		}
+	}
 
-		for (int i = 0; i < node->childrenCount; i++)
-			CalculateBoneTransform(&node->children[i], globalTransformation);
+	// palette size needed by the current clip
+	int GetBoneCount() const
+	{
+		return m_CurrentAnimation ? m_CurrentAnimation->GetSkeleton().GetBoneCount() : 0;
 	}
 
-	std::vector<glm::mat4> GetFinalBoneMatrices()
+	// non-owning view of the palette, valid until the next PlayAnimation
+	std::span<const glm::mat4> GetFinalBoneMatrices() const
 	{
 		return m_FinalBoneMatrices;
 	}
 
 private:
+	/* Reduced rate update: the pose one interval ahead is evaluated as soon as
+	   the previous one is reached, so the palette can be blended towards it
+	   every frame instead of snapping when the next evaluation happens */
+	void UpdateInterpolated(float dt, glm::mat4* palette, int paletteSize)
+	{
+		if (static_cast<int>(m_NextPose.size()) < paletteSize)
+		{
+			m_PreviousPose.resize(paletteSize, glm::mat4(1.0f));
+			m_NextPose.resize(paletteSize, glm::mat4(1.0f));
+			m_HasPose = false;
+		}
+
+		m_SinceUpdate += dt;
+		if (!m_HasPose || m_SinceUpdate >= m_UpdateInterval)
+		{
+			if (m_HasPose && m_SinceUpdate < 2.0f * m_UpdateInterval)
+				std::swap(m_PreviousPose, m_NextPose);
+			else
+				CalculateBoneTransforms(m_PreviousPose.data(), paletteSize);
+
+			float ahead = m_CurrentTime + m_CurrentAnimation->GetTicksPerSecond() * m_UpdateInterval;
+			CalculateBoneTransforms(fmod(ahead, m_CurrentAnimation->GetDuration()), m_NextPose.data(), paletteSize);
+			m_SinceUpdate = 0.0f;
+			m_HasPose = true;
+		}
+
+		float factor = std::min(m_SinceUpdate / m_UpdateInterval, 1.0f);
+		for (int i = 0; i < paletteSize; i++)
+			palette[i] = m_PreviousPose[i] * (1.0f - factor) + m_NextPose[i] * factor;
+	}
+
+	// sizes the per-node scratch once per clip so updates never allocate
+	void PrepareSkeleton()
+	{
+		if (!m_CurrentAnimation)
+			return;
+
+		const Skeleton& skeleton = m_CurrentAnimation->GetSkeleton();
+		m_GlobalTransforms.resize(skeleton.GetNodeCount());
+		m_LocalTransforms.resize(m_CurrentAnimation->GetBones().size());
+		m_SampleBatch.Resize(static_cast<int>(m_CurrentAnimation->GetBones().size()));
+		m_Cursors.assign(m_CurrentAnimation->GetBones().size(), BoneCursor());
+		if (static_cast<int>(m_FinalBoneMatrices.size()) < skeleton.GetBoneCount())
+			m_FinalBoneMatrices.resize(skeleton.GetBoneCount(), glm::mat4(1.0f));
+	}
+
 	std::vector<glm::mat4> m_FinalBoneMatrices;
+	std::vector<glm::mat4> m_GlobalTransforms;
+	std::vector<glm::mat4> m_LocalTransforms;
+	TRSSampleBatch m_SampleBatch;
+	std::vector<BoneCursor> m_Cursors;
 	Animation* m_CurrentAnimation;
 	float m_CurrentTime;
 	float m_DeltaTime;
 
+	// reduced rate updates, see SetUpdateInterval
+	float m_UpdateInterval;
+	float m_SinceUpdate;
+	bool m_HasPose;
+	std::vector<glm::mat4> m_PreviousPose;
+	std::vector<glm::mat4> m_NextPose;
+
 };
@@ -0,0 +1,70 @@
+#pragma once
+
+/* Updates many animators at once across the threads of a JobSystem. Every
+   instance gets its own slice of one contiguous palette buffer, reserved
+   when the instance is added, so a frame update never allocates. */
+
+#include <vector>
+#include <span>
+#include <algorithm>
+#include <glm/glm.hpp>
+#include "animator.hpp"
+#include "jobSystem.hpp"
+
+class AnimatorBatch
+{
+public:
+	/* Registers an animator and reserves paletteSize matrices for it (0 uses
+	   the larger of the animator's current bone count and MAX_BONES of the
+	   skinning shader). Returns the instance index. */
+	int Add(Animator* animator, int paletteSize = 0)
+	{
+		if (paletteSize <= 0)
+			paletteSize = std::max(animator->GetBoneCount(), 100);
+
+		Instance instance;
+		instance.animator = animator;
+		instance.paletteOffset = static_cast<int>(m_Palettes.size());
+		instance.paletteSize = paletteSize;
+		m_Instances.push_back(instance);
+		m_Palettes.resize(m_Palettes.size() + paletteSize, glm::mat4(1.0f));
+		return static_cast<int>(m_Instances.size()) - 1;
+	}
+
+	/* Advances every animator by dt and writes their palettes, one animator
+	   per job; a worker that finishes early steals the remaining animators */
+	void Update(JobSystem& jobs, float dt)
+	{
+		jobs.ParallelFor(static_cast<int>(m_Instances.size()), 1, [this, dt](int begin, int end)
+		{
+			for (int i = begin; i < end; i++)
+			{
+				Instance& instance = m_Instances[i];
+				instance.animator->UpdateAnimation(dt, m_Palettes.data() + instance.paletteOffset, instance.paletteSize);
+			}
+		});
+	}
+
+	inline int GetInstanceCount() const { return static_cast<int>(m_Instances.size()); }
+
+	std::span<const glm::mat4> GetPalette(int instance) const
+	{
+		const Instance& entry = m_Instances[instance];
+		return std::span<const glm::mat4>(m_Palettes.data() + entry.paletteOffset, entry.paletteSize);
+	}
+
+	// palettes of every instance back to back, in the order they were added
+	inline const std::vector<glm::mat4>& GetPalettes() const { return m_Palettes; }
+	inline int GetPaletteOffset(int instance) const { return m_Instances[instance].paletteOffset; }
+
+private:
+	struct Instance
+	{
+		Animator* animator;
+		int paletteOffset;
+		int paletteSize;
+	};
+
+	std::vector<Instance> m_Instances;
+	std::vector<glm::mat4> m_Palettes;
+};
@@ -0,0 +1,226 @@
+#ifndef BAKED_ANIMATION_H
+#define BAKED_ANIMATION_H
+
+#include <glad/glad.h>
+
+#include <glm/glm.hpp>
+
+#include "glState.hpp"
+#include "shaders/shader.hpp"
+#include "textureUnits.hpp"
+#include "animation.hpp"
+#include "animator.hpp"
+#include "model.hpp"
+
+#include <array>
+#include <vector>
+#include <cmath>
+#include <algorithm>
+
+// size of the clip table of the instanced skinning shader
+#define MAX_BAKED_CLIPS 16
+
+// "bakedClips[i]" for every entry of the clip table, hashed at compile time
+constexpr std::array<UniformName, MAX_BAKED_CLIPS> bakedClipUniformNames()
+{
+    static_assert(MAX_BAKED_CLIPS <= 100);
+    std::array<UniformName, MAX_BAKED_CLIPS> names{};
+    for (int i = 0; i < MAX_BAKED_CLIPS; i++) {
+        char name[16] = "bakedClips[";
+        size_t length = 11;
+        if (i >= 10)
+            name[length++] = static_cast<char>('0' + i / 10);
+        name[length++] = static_cast<char>('0' + i % 10);
+        name[length++] = ']';
+        names[i] = UniformName{ uniformHash(std::string_view(name, length)) };
+    }
+    return names;
+}
+inline constexpr std::array<UniformName, MAX_BAKED_CLIPS> bakedClipUniforms = bakedClipUniformNames();
+
+/* Clips sampled ahead of time into a float texture, for crowds of the same
+   model. Every row holds the bone palette of one frame as three RGBA32F texels
+   per bone (the rows of the affine matrix), and the clips are stacked one
+   after the other. The instanced skinning shader reads each instance's pose
+   from it, so drawing a crowd needs no pose evaluation on the CPU. */
+class BakedAnimation {
+public:
+    struct Clip {
+        int firstRow;
+        int frameCount;
+        float sampleRate;
+    };
+
+    BakedAnimation() : texture(0), boneCount(0) {}
+
+    ~BakedAnimation()
+    {
+        if (texture)
+            GLState::Get().DeleteTextures(1, &texture);
+    }
+
+    BakedAnimation(const BakedAnimation&) = delete;
+    BakedAnimation& operator=(const BakedAnimation&) = delete;
+
+    /* Samples a looping clip sampleRate times per second. All the clips of one
+       BakedAnimation must animate the same model. Returns the clip index used
+       by the instances. */
+    int AddClip(Animation* animation, float sampleRate = 30.0f)
+    {
+        Animator animator(animation);
+        int clipBones = animation->GetSkeleton().GetBoneCount();
+        if (clipBones > boneCount) {
+            widenRows(clipBones);
+            boneCount = clipBones;
+        }
+
+        float seconds = animation->GetDuration() / animation->GetTicksPerSecond();
+        Clip clip;
+        clip.firstRow = rowCount();
+        clip.frameCount = std::max(1, static_cast<int>(std::lround(seconds * sampleRate)));
+        clip.sampleRate = sampleRate;
+
+        std::vector<glm::mat4> palette(boneCount, glm::mat4(1.0f));
+        for (int frame = 0; frame < clip.frameCount; frame++) {
+            float ticks = frame / sampleRate * animation->GetTicksPerSecond();
+            animator.CalculateBoneTransforms(std::fmod(ticks, animation->GetDuration()), palette.data(), boneCount);
+            for (const auto& matrix : palette) {
+                for (int row = 0; row < 3; row++) {
+                    for (int column = 0; column < 4; column++)
+                        texels.push_back(matrix[column][row]);
+                }
+            }
+        }
+        clips.push_back(clip);
+        return static_cast<int>(clips.size()) - 1;
+    }
+
+    // creates the texture with every clip added so far
+    void Upload()
+    {
+        if (!texture)
+            glGenTextures(1, &texture);
+        GLState::Get().BindTexture(GL_TEXTURE_2D, texture);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA32F, boneCount * 3, rowCount(), 0, GL_RGBA, GL_FLOAT, texels.data());
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        GLState::Get().BindTexture(GL_TEXTURE_2D, 0);
+    }
+
+    // binds the poses to BAKED_ANIMATION_UNIT and fills the shader's clip table
+    void Bind(Shader& shader) const
+    {
+        GLState::Get().ActiveTexture(GL_TEXTURE0 + BAKED_ANIMATION_UNIT);
+        GLState::Get().BindTexture(GL_TEXTURE_2D, texture);
+        GLState::Get().ActiveTexture(GL_TEXTURE0);
+        shader.setInt("bakedPoses"_uniform, BAKED_ANIMATION_UNIT);
+        // the shader drops the entries it already holds, so the table only goes to GL when it changes
+        int count = std::min(static_cast<int>(clips.size()), MAX_BAKED_CLIPS);
+        for (int i = 0; i < count; i++)
+            shader.setVec3(bakedClipUniforms[i], glm::vec3(clips[i].firstRow, clips[i].frameCount, clips[i].sampleRate));
+    }
+
+    inline int GetClipCount() const { return static_cast<int>(clips.size()); }
+    inline const Clip& GetClip(int i) const { return clips[i]; }
+    inline int GetBoneCount() const { return boneCount; }
+
+private:
+    unsigned int texture;
+    int boneCount;
+    std::vector<Clip> clips;
+    std::vector<float> texels;
+
+    inline int rowCount() const { return boneCount > 0 ? static_cast<int>(texels.size()) / (boneCount * 12) : 0; }
+
+    // pads the rows baked so far when a clip with more bones is added
+    void widenRows(int newBoneCount)
+    {
+        if (boneCount == 0 || texels.empty())
+            return;
+        int rows = rowCount();
+        std::vector<float> widened(static_cast<size_t>(rows) * newBoneCount * 12, 0.0f);
+        for (int row = 0; row < rows; row++)
+            std::copy_n(texels.begin() + static_cast<size_t>(row) * boneCount * 12, boneCount * 12,
+                widened.begin() + static_cast<size_t>(row) * newBoneCount * 12);
+        texels.swap(widened);
+    }
+};
+
+/* Per-instance data of a crowd drawn from a BakedAnimation: its model matrix
+   and which clip it plays, with a time offset so the instances don't move in
+   lockstep. Attach() adds the instance attributes (locations 7 to 11) to the
+   meshes of the model, giving static meshes their own VAO; the crowd is then
+   drawn with one call per mesh. */
+class AnimationCrowd {
+public:
+    struct Instance {
+        glm::mat4 model;
+        // x: clip index, y: time offset in seconds
+        glm::vec2 clip;
+    };
+
+    std::vector<Instance> instances;
+
+    AnimationCrowd() : buffer(0) {}
+
+    ~AnimationCrowd()
+    {
+        if (buffer)
+            GLState::Get().DeleteBuffers(1, &buffer);
+    }
+
+    AnimationCrowd(const AnimationCrowd&) = delete;
+    AnimationCrowd& operator=(const AnimationCrowd&) = delete;
+
+    void Add(const glm::mat4& model, int clip, float timeOffset)
+    {
+        instances.push_back({ model, glm::vec2(static_cast<float>(clip), timeOffset) });
+    }
+
+    // sends the instances to the GPU, call again after changing them
+    void Upload()
+    {
+        if (!buffer)
+            glGenBuffers(1, &buffer);
+        GLState::Get().BindBuffer(GL_ARRAY_BUFFER, buffer);
+        glBufferData(GL_ARRAY_BUFFER, instances.size() * sizeof(Instance), instances.data(), GL_DYNAMIC_DRAW);
+        GLState::Get().BindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+
+    // sets up the instance attributes on every mesh of model
+    void Attach(Model& model)
+    {
+        if (!buffer)
+            Upload();
+        GLState::Get().BindBuffer(GL_ARRAY_BUFFER, buffer);
+        for (auto& mesh : model.meshes) {
+            // the instance attributes are per model, so the mesh can't stay on the arena's shared VAO
+            GLState::Get().BindVertexArray(mesh.UseOwnVAO());
+            for (int column = 0; column < 4; column++) {
+                glEnableVertexAttribArray(7 + column);
+                glVertexAttribPointer(7 + column, 4, GL_FLOAT, GL_FALSE, sizeof(Instance),
+                    (void*)(offsetof(Instance, model) + column * sizeof(glm::vec4)));
+                glVertexAttribDivisor(7 + column, 1);
+            }
+            glEnableVertexAttribArray(11);
+            glVertexAttribPointer(11, 2, GL_FLOAT, GL_FALSE, sizeof(Instance), (void*)offsetof(Instance, clip));
+            glVertexAttribDivisor(11, 1);
+        }
+        GLState::Get().BindVertexArray(0);
+        GLState::Get().BindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+
+    // time is the crowd's clock in seconds
+    void Draw(Model& model, Shader& shader, const BakedAnimation& poses, float time)
+    {
+        poses.Bind(shader);
+        shader.setFloat("time", time);
+        model.DrawInstanced(shader, static_cast<unsigned int>(instances.size()));
+    }
+
+private:
+    unsigned int buffer;
+};
+#endif
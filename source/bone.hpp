@@ -3,30 +3,27 @@
 /* Container for bone data */
 
 #include <vector>
+#include <algorithm>
 #include <assimp/scene.h>
 #include <list>
 #include <glm/glm.hpp>
 #define GLM_ENABLE_EXPERIMENTAL
 #include <glm/gtx/quaternion.hpp>
 #include "assimp_glm_helpers.hpp"
+#include "trsSampler.hpp"
+#include "keyCompression.hpp"
 
-struct KeyPosition
+/* Playback cursor: last key segment used by each channel, so forward playback
+   only has to look at the next few keys instead of scanning from key 0 */
+struct BoneCursor
 {
-	glm::vec3 position;
-	float timeStamp;
+	int position = 0;
+	int rotation = 0;
+	int scale = 0;
 };
 
-struct KeyRotation
-{
-	glm::quat orientation;
-	float timeStamp;
-};
-
-struct KeyScale
-{
-	glm::vec3 scale;
-	float timeStamp;
-};
+/* Keys the cursor walks forward before giving up and binary searching */
+#define BONE_CURSOR_MAX_STEPS 4
 
 class Bone
 {
@@ -35,40 +32,37 @@ public:
 		:
 		m_Name(name),
 		m_ID(ID),
+		m_Compressed(false),
 		m_LocalTransform(1.0f)
 	{
+		// keys are kept as separate time and value arrays (structure of arrays), so
+		// the key search only touches timestamps and values are read just for the
+		// two keys that end up being interpolated
 		m_NumPositions = channel->mNumPositionKeys;
-
+		m_PositionTimes.reserve(m_NumPositions);
+		m_Positions.reserve(m_NumPositions);
 		for (int positionIndex = 0; positionIndex < m_NumPositions; ++positionIndex)
 		{
-			aiVector3D aiPosition = channel->mPositionKeys[positionIndex].mValue;
-			float timeStamp = channel->mPositionKeys[positionIndex].mTime;
-			KeyPosition data;
-			data.position = AssimpGLMHelpers::GetGLMVec(aiPosition);
-			data.timeStamp = timeStamp;
-			m_Positions.push_back(data);
+			m_PositionTimes.push_back(static_cast<float>(channel->mPositionKeys[positionIndex].mTime));
+			m_Positions.push_back(AssimpGLMHelpers::GetGLMVec(channel->mPositionKeys[positionIndex].mValue));
 		}
 
 		m_NumRotations = channel->mNumRotationKeys;
+		m_RotationTimes.reserve(m_NumRotations);
+		m_Rotations.reserve(m_NumRotations);
 		for (int rotationIndex = 0; rotationIndex < m_NumRotations; ++rotationIndex)
 		{
-			aiQuaternion aiOrientation = channel->mRotationKeys[rotationIndex].mValue;
-			float timeStamp = channel->mRotationKeys[rotationIndex].mTime;
-			KeyRotation data;
-			data.orientation = AssimpGLMHelpers::GetGLMQuat(aiOrientation);
-			data.timeStamp = timeStamp;
-			m_Rotations.push_back(data);
+			m_RotationTimes.push_back(static_cast<float>(channel->mRotationKeys[rotationIndex].mTime));
+			m_Rotations.push_back(AssimpGLMHelpers::GetGLMQuat(channel->mRotationKeys[rotationIndex].mValue));
 		}
 
 		m_NumScalings = channel->mNumScalingKeys;
+		m_ScaleTimes.reserve(m_NumScalings);
+		m_Scales.reserve(m_NumScalings);
 		for (int keyIndex = 0; keyIndex < m_NumScalings; ++keyIndex)
 		{
-			aiVector3D scale = channel->mScalingKeys[keyIndex].mValue;
-			float timeStamp = channel->mScalingKeys[keyIndex].mTime;
-			KeyScale data;
-			data.scale = AssimpGLMHelpers::GetGLMVec(scale);
-			data.timeStamp = timeStamp;
-			m_Scales.push_back(data);
+			m_ScaleTimes.push_back(static_cast<float>(channel->mScalingKeys[keyIndex].mTime));
+			m_Scales.push_back(AssimpGLMHelpers::GetGLMVec(channel->mScalingKeys[keyIndex].mValue));
 		}
 	}
 	
@@ -79,6 +73,78 @@ public:
 		glm::mat4 scale = InterpolateScaling(animationTime);
 		m_LocalTransform = translation * rotation * scale;
 	}
+
+	/* Writes the keys surrounding animationTime and their blend factors into
+	   one lane of a sample batch, to be interpolated by TRSSampler::Sample
+	   together with the other channels of the clip. The cursor belongs to the
+	   caller, so several animators can sample the same bone concurrently. */
+	void Gather(float animationTime, BoneCursor& cursor, TRSSampleBatch& batch, int lane) const
+	{
+		if (1 == m_NumPositions)
+			batch.SetPosition(lane, GetPositionKey(0), GetPositionKey(0), 0.0f);
+		else
+		{
+			int p0Index = FindKeyIndex(m_PositionTimes, animationTime, cursor.position);
+			batch.SetPosition(lane, GetPositionKey(p0Index), GetPositionKey(p0Index + 1),
+				GetScaleFactor(m_PositionTimes[p0Index], m_PositionTimes[p0Index + 1], animationTime));
+		}
+
+		if (1 == m_NumRotations)
+			batch.SetRotation(lane, GetRotationKey(0), GetRotationKey(0), 0.0f);
+		else
+		{
+			int p0Index = FindKeyIndex(m_RotationTimes, animationTime, cursor.rotation);
+			batch.SetRotation(lane, GetRotationKey(p0Index), GetRotationKey(p0Index + 1),
+				GetScaleFactor(m_RotationTimes[p0Index], m_RotationTimes[p0Index + 1], animationTime));
+		}
+
+		if (1 == m_NumScalings)
+			batch.SetScale(lane, GetScaleKey(0), GetScaleKey(0), 0.0f);
+		else
+		{
+			int p0Index = FindKeyIndex(m_ScaleTimes, animationTime, cursor.scale);
+			batch.SetScale(lane, GetScaleKey(p0Index), GetScaleKey(p0Index + 1),
+				GetScaleFactor(m_ScaleTimes[p0Index], m_ScaleTimes[p0Index + 1], animationTime));
+		}
+	}
+
+	/* Drops the keys that interpolation reproduces within the tolerances of
+	   settings and packs the rest (see keyCompression.hpp). The float keys are
+	   released; sampling decodes the packed keys on the fly. */
+	void Compress(const KeyCompressionSettings& settings)
+	{
+		if (m_Compressed)
+			return;
+
+		KeyCompression::ReduceVec3Keys(m_PositionTimes, m_Positions, settings.positionError);
+		KeyCompression::ReduceQuatKeys(m_RotationTimes, m_Rotations, settings.rotationError);
+		KeyCompression::ReduceVec3Keys(m_ScaleTimes, m_Scales, settings.scaleError);
+		m_NumPositions = static_cast<int>(m_Positions.size());
+		m_NumRotations = static_cast<int>(m_Rotations.size());
+		m_NumScalings = static_cast<int>(m_Scales.size());
+
+		m_PackedPositions.Encode(m_Positions);
+		m_PackedRotations.Encode(m_Rotations);
+		m_PackedScales.Encode(m_Scales);
+		std::vector<glm::vec3>().swap(m_Positions);
+		std::vector<glm::quat>().swap(m_Rotations);
+		std::vector<glm::vec3>().swap(m_Scales);
+		m_PositionTimes.shrink_to_fit();
+		m_RotationTimes.shrink_to_fit();
+		m_ScaleTimes.shrink_to_fit();
+		m_Compressed = true;
+	}
+
+	// memory held by the keys of this bone
+	size_t GetKeyByteSize() const
+	{
+		size_t times = (m_PositionTimes.size() + m_RotationTimes.size() + m_ScaleTimes.size()) * sizeof(float);
+		if (m_Compressed)
+			return times + m_PackedPositions.GetByteSize() + m_PackedRotations.GetByteSize() + m_PackedScales.GetByteSize();
+		return times + m_Positions.size() * sizeof(glm::vec3) + m_Rotations.size() * sizeof(glm::quat)
+			+ m_Scales.size() * sizeof(glm::vec3);
+	}
+
 	glm::mat4 GetLocalTransform() { return m_LocalTransform; }
 	std::string GetBoneName() const { return m_Name; }
 	int GetBoneID() { return m_ID; }
@@ -87,56 +153,82 @@ public:
 
 	int GetPositionIndex(float animationTime)
 	{
-		for (int index = 0; index < m_NumPositions - 1; ++index)
-		{
-			if (animationTime < m_Positions[index + 1].timeStamp)
-				return index;
-		}
-		assert(0);
+		return FindKeyIndex(m_PositionTimes, animationTime, m_Cursor.position);
 	}
 
 	int GetRotationIndex(float animationTime)
 	{
-		for (int index = 0; index < m_NumRotations - 1; ++index)
-		{
-			if (animationTime < m_Rotations[index + 1].timeStamp)
-				return index;
-		}
-		assert(0);
+		return FindKeyIndex(m_RotationTimes, animationTime, m_Cursor.rotation);
 	}
 
 	int GetScaleIndex(float animationTime)
 	{
-		for (int index = 0; index < m_NumScalings - 1; ++index)
+		return FindKeyIndex(m_ScaleTimes, animationTime, m_Cursor.scale);
+	}
+
+
+private:
+
+	/* Returns the segment [index, index + 1] that contains animationTime.
+	   Starts from the cursor left by the previous frame and walks forward; if the
+	   time jumped (loop wrap, seek, new clip) it falls back to a binary search.
+	   Times before the first key or past the last key clamp to the end segments. */
+	static int FindKeyIndex(const std::vector<float>& times, float animationTime, int& cursor)
+	{
+		int lastSegment = static_cast<int>(times.size()) - 2;
+		if (animationTime <= times.front())
+			return cursor = 0;
+		if (animationTime >= times.back())
+			return cursor = lastSegment;
+
+		int index = std::clamp(cursor, 0, lastSegment);
+		if (times[index] <= animationTime)
 		{
-			if (animationTime < m_Scales[index + 1].timeStamp)
-				return index;
+			for (int step = 0; step < BONE_CURSOR_MAX_STEPS && index <= lastSegment; ++step, ++index)
+			{
+				if (animationTime < times[index + 1])
+					return cursor = index;
+			}
 		}
-		assert(0);
+
+		auto next = std::upper_bound(times.begin() + 1, times.end(), animationTime);
+		return cursor = static_cast<int>(next - times.begin()) - 1;
 	}
 
+	inline glm::vec3 GetPositionKey(int index) const
+	{
+		return m_Compressed ? m_PackedPositions.Decode(index) : m_Positions[index];
+	}
 
-private:
+	inline glm::quat GetRotationKey(int index) const
+	{
+		return m_Compressed ? m_PackedRotations.Decode(index) : m_Rotations[index];
+	}
 
-	float GetScaleFactor(float lastTimeStamp, float nextTimeStamp, float animationTime)
+	inline glm::vec3 GetScaleKey(int index) const
+	{
+		return m_Compressed ? m_PackedScales.Decode(index) : m_Scales[index];
+	}
+
+	static float GetScaleFactor(float lastTimeStamp, float nextTimeStamp, float animationTime)
 	{
-		float scaleFactor = 0.0f;
-		float midWayLength = animationTime - lastTimeStamp;
 		float framesDiff = nextTimeStamp - lastTimeStamp;
-		scaleFactor = midWayLength / framesDiff;
-		return scaleFactor;
+		if (framesDiff <= 0.0f)
+			return 0.0f;
+		float midWayLength = animationTime - lastTimeStamp;
+		return std::clamp(midWayLength / framesDiff, 0.0f, 1.0f);
 	}
 
 	glm::mat4 InterpolatePosition(float animationTime)
 	{
 		if (1 == m_NumPositions)
-			return glm::translate(glm::mat4(1.0f), m_Positions[0].position);
+			return glm::translate(glm::mat4(1.0f), GetPositionKey(0));
 
 		int p0Index = GetPositionIndex(animationTime);
 		int p1Index = p0Index + 1;
-		float scaleFactor = GetScaleFactor(m_Positions[p0Index].timeStamp,
-			m_Positions[p1Index].timeStamp, animationTime);
-		glm::vec3 finalPosition = glm::mix(m_Positions[p0Index].position, m_Positions[p1Index].position
+		float scaleFactor = GetScaleFactor(m_PositionTimes[p0Index],
+			m_PositionTimes[p1Index], animationTime);
+		glm::vec3 finalPosition = glm::mix(GetPositionKey(p0Index), GetPositionKey(p1Index)
 			, scaleFactor);
 		return glm::translate(glm::mat4(1.0f), finalPosition);
 	}
@@ -145,15 +237,15 @@ private:
 	{
 		if (1 == m_NumRotations)
 		{
-			auto rotation = glm::normalize(m_Rotations[0].orientation);
+			auto rotation = glm::normalize(GetRotationKey(0));
 			return glm::toMat4(rotation);
 		}
 
 		int p0Index = GetRotationIndex(animationTime);
 		int p1Index = p0Index + 1;
-		float scaleFactor = GetScaleFactor(m_Rotations[p0Index].timeStamp,
-			m_Rotations[p1Index].timeStamp, animationTime);
-		glm::quat finalRotation = glm::slerp(m_Rotations[p0Index].orientation, m_Rotations[p1Index].orientation
+		float scaleFactor = GetScaleFactor(m_RotationTimes[p0Index],
+			m_RotationTimes[p1Index], animationTime);
+		glm::quat finalRotation = glm::slerp(GetRotationKey(p0Index), GetRotationKey(p1Index)
 			, scaleFactor);
 		finalRotation = glm::normalize(finalRotation);
 		return glm::toMat4(finalRotation);
@@ -163,23 +255,33 @@ private:
 	glm::mat4 InterpolateScaling(float animationTime)
 	{
 		if (1 == m_NumScalings)
-			return glm::scale(glm::mat4(1.0f), m_Scales[0].scale);
+			return glm::scale(glm::mat4(1.0f), GetScaleKey(0));
 
 		int p0Index = GetScaleIndex(animationTime);
 		int p1Index = p0Index + 1;
-		float scaleFactor = GetScaleFactor(m_Scales[p0Index].timeStamp,
-			m_Scales[p1Index].timeStamp, animationTime);
-		glm::vec3 finalScale = glm::mix(m_Scales[p0Index].scale, m_Scales[p1Index].scale
+		float scaleFactor = GetScaleFactor(m_ScaleTimes[p0Index],
+			m_ScaleTimes[p1Index], animationTime);
+		glm::vec3 finalScale = glm::mix(GetScaleKey(p0Index), GetScaleKey(p1Index)
 			, scaleFactor);
 		return glm::scale(glm::mat4(1.0f), finalScale);
 	}
 
-	std::vector<KeyPosition> m_Positions;
-	std::vector<KeyRotation> m_Rotations;
-	std::vector<KeyScale> m_Scales;
+	std::vector<float> m_PositionTimes;
+	std::vector<glm::vec3> m_Positions;
+	std::vector<float> m_RotationTimes;
+	std::vector<glm::quat> m_Rotations;
+	std::vector<float> m_ScaleTimes;
+	std::vector<glm::vec3> m_Scales;
 	int m_NumPositions;
 	int m_NumRotations;
 	int m_NumScalings;
+	BoneCursor m_Cursor;
+
+	// packed keys, used instead of the float ones once the bone is compressed
+	bool m_Compressed;
+	KeyCompression::QuantizedVec3Track m_PackedPositions;
+	KeyCompression::QuantizedQuatTrack m_PackedRotations;
+	KeyCompression::QuantizedVec3Track m_PackedScales;
 
 	glm::mat4 m_LocalTransform;
 	std::string m_Name;
@@ -0,0 +1,78 @@
+#ifndef BONE_PALETTE_H
+#define BONE_PALETTE_H
+
+#include <glad/glad.h>
+
+#include <glm/glm.hpp>
+
+#include "glState.hpp"
+#include "shaders/shader.hpp"
+#include "textureUnits.hpp"
+
+#include <span>
+
+/* GPU copy of one or more bone palettes, stored in a texture buffer
+   (four RGBA32F texels per matrix). The whole palette goes up with a single
+   buffer upload and has no size limit besides GL_MAX_TEXTURE_BUFFER_SIZE, so
+   skeletons with more than 100 bones and whole AnimatorBatch palettes fit.
+   Skinning shaders read it through "uniform samplerBuffer bonePalette",
+   starting at matrix "boneOffset". */
+class BonePalette {
+public:
+    BonePalette() : buffer(0), texture(0), capacity(0) {}
+
+    ~BonePalette()
+    {
+        if (texture)
+            GLState::Get().DeleteTextures(1, &texture);
+        if (buffer)
+            GLState::Get().DeleteBuffers(1, &buffer);
+    }
+
+    BonePalette(const BonePalette&) = delete;
+    BonePalette& operator=(const BonePalette&) = delete;
+
+    // uploads every matrix in one call, reusing the buffer storage when it is big enough
+    void Upload(std::span<const glm::mat4> matrices)
+    {
+        if (!buffer)
+            setupPalette();
+
+        GLState::Get().BindBuffer(GL_TEXTURE_BUFFER, buffer);
+        GLsizeiptr size = static_cast<GLsizeiptr>(matrices.size_bytes());
+        if (matrices.size() > capacity) {
+            capacity = matrices.size();
+            glBufferData(GL_TEXTURE_BUFFER, size, matrices.data(), GL_STREAM_DRAW);
+        }
+        else {
+            glBufferSubData(GL_TEXTURE_BUFFER, 0, size, matrices.data());
+        }
+        GLState::Get().BindBuffer(GL_TEXTURE_BUFFER, 0);
+    }
+
+    // binds the palette to BONE_PALETTE_UNIT and points the shader's sampler at it
+    void Bind(Shader& shader, int boneOffset = 0) const
+    {
+        GLState::Get().ActiveTexture(GL_TEXTURE0 + BONE_PALETTE_UNIT);
+        GLState::Get().BindTexture(GL_TEXTURE_BUFFER, texture);
+        GLState::Get().ActiveTexture(GL_TEXTURE0);
+        shader.setInt("bonePalette", BONE_PALETTE_UNIT);
+        shader.setInt("boneOffset", boneOffset);
+    }
+
+private:
+    unsigned int buffer, texture;
+    size_t capacity;
+
+    void setupPalette()
+    {
+        glGenBuffers(1, &buffer);
+        glGenTextures(1, &texture);
+        GLState::Get().BindBuffer(GL_TEXTURE_BUFFER, buffer);
+        GLState::Get().BindTexture(GL_TEXTURE_BUFFER, texture);
+        glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, buffer);
+        GLState::Get().BindTexture(GL_TEXTURE_BUFFER, 0);
+        GLState::Get().BindBuffer(GL_TEXTURE_BUFFER, 0);
+    }
+};
+#endif
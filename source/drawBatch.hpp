@@ -0,0 +1,185 @@
+#ifndef DRAW_BATCH_H
+#define DRAW_BATCH_H
+
+#include <glad/glad.h>
+
+#include "geometryArena.hpp"
+#include "glState.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+// vertex attribute carrying the index of the object being drawn, above the ones Mesh and the instanced shaders use
+#define OBJECT_INDEX_ATTRIBUTE 15
+
+// layout glMultiDrawElementsIndirect reads from the indirect buffer
+struct DrawElementsIndirectCommand {
+    GLuint count;
+    GLuint instanceCount;
+    GLuint firstIndex;
+    GLint baseVertex;
+    GLuint baseInstance;
+};
+
+/* Draws of geometry arena ranges that share one vertex format, submitted
+   together. On GL 4.3 the commands go to an indirect buffer and out in a
+   single glMultiDrawElementsIndirect; each command's baseInstance is its
+   object index, which reaches the shader through an instanced
+   "layout (location = 15) in uint objectIndex" attribute. GLSL 330 has no
+   draw id, so older contexts set the attribute between draws and send each
+   run of commands with the same object index through glMultiDrawElementsBaseVertex.
+   The batch keeps the handles and re-reads their ranges once the arena has
+   moved them, so it stays valid across arena growth and Compact(). */
+class DrawBatch {
+public:
+    DrawBatch() : generation(0), commandBuffer(0), commandCapacity(0), uploaded(false) {}
+
+    ~DrawBatch()
+    {
+        if (commandBuffer)
+            GLState::Get().DeleteBuffers(1, &commandBuffer);
+    }
+
+    DrawBatch(const DrawBatch&) = delete;
+    DrawBatch& operator=(const DrawBatch&) = delete;
+
+    void Add(GeometryHandle geometry, unsigned int objectIndex)
+    {
+        const GeometryArena& arena = GeometryArena::Get();
+        if (generation != arena.GetGeneration())
+            refresh();
+        geometries.push_back(geometry);
+        commands.push_back({ arena.GetIndexCount(geometry), 1, arena.GetFirstIndex(geometry),
+                             arena.GetBaseVertex(geometry), objectIndex });
+        counts.push_back(static_cast<GLsizei>(commands.back().count));
+        offsets.push_back((const void*)(commands.back().firstIndex * sizeof(unsigned int)));
+        baseVertices.push_back(commands.back().baseVertex);
+        uploaded = false;
+    }
+
+    void Clear()
+    {
+        geometries.clear();
+        commands.clear();
+        counts.clear();
+        offsets.clear();
+        baseVertices.clear();
+        uploaded = false;
+    }
+
+    inline size_t GetDrawCount() const { return commands.size(); }
+
+    // binds the VAO of the batch's format and draws every command
+    void Submit()
+    {
+        if (commands.empty())
+            return;
+        if (generation != GeometryArena::Get().GetGeneration())
+            refresh();
+        GeometryArena::Get().Bind(geometries.front());
+        if (GLAD_GL_VERSION_4_3)
+            submitIndirect();
+        else
+            submitMultiDraw();
+    }
+
+private:
+    std::vector<GeometryHandle> geometries;
+    std::vector<DrawElementsIndirectCommand> commands;
+    // the same draws as separate arrays, for glMultiDrawElementsBaseVertex
+    std::vector<GLsizei> counts;
+    std::vector<const void*> offsets;
+    std::vector<GLint> baseVertices;
+    // arena generation the ranges above were read at
+    uint64_t generation;
+    unsigned int commandBuffer;
+    size_t commandCapacity;
+    bool uploaded;
+
+    // 0, 1, 2, ... read per instance, so instance 0 of a command fetches its baseInstance
+    inline static unsigned int objectIndexBuffer = 0;
+    inline static unsigned int objectIndexCapacity = 0;
+    // arena VAOs whose OBJECT_INDEX_ATTRIBUTE already reads objectIndexBuffer
+    inline static std::vector<unsigned int> indexedVAOs;
+
+    // reads the ranges of every draw again after the arena moved them
+    void refresh()
+    {
+        const GeometryArena& arena = GeometryArena::Get();
+        for (size_t i = 0; i < geometries.size(); i++) {
+            commands[i].firstIndex = arena.GetFirstIndex(geometries[i]);
+            commands[i].baseVertex = arena.GetBaseVertex(geometries[i]);
+            offsets[i] = (const void*)(commands[i].firstIndex * sizeof(unsigned int));
+            baseVertices[i] = commands[i].baseVertex;
+        }
+        generation = arena.GetGeneration();
+        uploaded = false;
+    }
+
+    void submitIndirect()
+    {
+        unsigned int objects = 0;
+        for (const auto& command : commands)
+            objects = std::max(objects, command.baseInstance + 1);
+        setupObjectIndices(GeometryArena::Get().GetVAO(geometries.front()), objects);
+
+        if (!commandBuffer)
+            glGenBuffers(1, &commandBuffer);
+        GLState::Get().BindBuffer(GL_DRAW_INDIRECT_BUFFER, commandBuffer);
+        if (!uploaded) {
+            GLsizeiptr size = static_cast<GLsizeiptr>(commands.size() * sizeof(DrawElementsIndirectCommand));
+            if (commands.size() > commandCapacity) {
+                commandCapacity = commands.size();
+                glBufferData(GL_DRAW_INDIRECT_BUFFER, size, commands.data(), GL_DYNAMIC_DRAW);
+            }
+            else {
+                glBufferSubData(GL_DRAW_INDIRECT_BUFFER, 0, size, commands.data());
+            }
+            uploaded = true;
+        }
+        glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, 0, static_cast<GLsizei>(commands.size()), 0);
+        GLState::Get().BindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+    }
+
+    void submitMultiDraw()
+    {
+        // the attribute array stays disabled here, so every vertex reads the value set with glVertexAttribI1ui
+        for (size_t run = 0; run < commands.size();) {
+            size_t end = run + 1;
+            while (end < commands.size() && commands[end].baseInstance == commands[run].baseInstance)
+                end++;
+            glVertexAttribI1ui(OBJECT_INDEX_ATTRIBUTE, commands[run].baseInstance);
+            glMultiDrawElementsBaseVertex(GL_TRIANGLES, &counts[run], GL_UNSIGNED_INT, &offsets[run],
+                                          static_cast<GLsizei>(end - run), &baseVertices[run]);
+            run = end;
+        }
+    }
+
+    // expects vao to be bound
+    static void setupObjectIndices(unsigned int vao, unsigned int objects)
+    {
+        if (!objectIndexBuffer)
+            glGenBuffers(1, &objectIndexBuffer);
+        if (objects > objectIndexCapacity) {
+            objectIndexCapacity = std::max(objects, objectIndexCapacity * 2);
+            std::vector<unsigned int> indices(objectIndexCapacity);
+            for (unsigned int i = 0; i < objectIndexCapacity; i++)
+                indices[i] = i;
+            // same buffer name, so VAOs set up earlier see the new storage
+            GLState::Get().BindBuffer(GL_COPY_WRITE_BUFFER, objectIndexBuffer);
+            glBufferData(GL_COPY_WRITE_BUFFER, indices.size() * sizeof(unsigned int), indices.data(), GL_STATIC_DRAW);
+            GLState::Get().BindBuffer(GL_COPY_WRITE_BUFFER, 0);
+        }
+
+        if (std::find(indexedVAOs.begin(), indexedVAOs.end(), vao) != indexedVAOs.end())
+            return;
+        GLState::Get().BindBuffer(GL_ARRAY_BUFFER, objectIndexBuffer);
+        glEnableVertexAttribArray(OBJECT_INDEX_ATTRIBUTE);
+        glVertexAttribIPointer(OBJECT_INDEX_ATTRIBUTE, 1, GL_UNSIGNED_INT, 0, (void*)0);
+        glVertexAttribDivisor(OBJECT_INDEX_ATTRIBUTE, 1);
+        GLState::Get().BindBuffer(GL_ARRAY_BUFFER, 0);
+        indexedVAOs.push_back(vao);
+    }
+};
+#endif
@@ -0,0 +1,291 @@
+#include "geometryArena.hpp"
+#include "glState.hpp"
+
+#include <algorithm>
+
+namespace {
+    // smallest buffers a pool starts with, in vertices and indices
+    const unsigned int MIN_POOL_VERTICES = 1 << 14;
+    const unsigned int MIN_POOL_INDICES = 1 << 16;
+}
+
+    VertexFormat VertexFormat::Floats(std::initializer_list<int> components)
+    {
+        VertexFormat format;
+        unsigned int location = 0;
+        for (int count : components) {
+            format.attributes.push_back({ location++, count, GL_FLOAT, false, format.stride });
+            format.stride += count * sizeof(float);
+        }
+        return format;
+    }
+
+    std::string VertexFormat::GetKey() const
+    {
+        std::string key = std::to_string(stride);
+        for (const auto& attribute : attributes)
+            key += "|" + std::to_string(attribute.location) + "," + std::to_string(attribute.components) + ","
+                + std::to_string(attribute.type) + "," + std::to_string(attribute.normalized) + ","
+                + std::to_string(attribute.offset);
+        return key;
+    }
+
+    // ------------------------------------------------------------------------
+    GeometryArena& GeometryArena::Get()
+    {
+        static GeometryArena arena;
+        return arena;
+    }
+
+    GeometryHandle GeometryArena::Allocate(const VertexFormat& format, const void* vertices, unsigned int vertexCount,
+                                           const unsigned int* indices, unsigned int indexCount)
+    {
+        if (vertexCount == 0 || indexCount == 0)
+            return GeometryHandle();
+        int p = findPool(format);
+        if (findRange(m_Pools[p].freeVertices, vertexCount) < 0 || findRange(m_Pools[p].freeIndices, indexCount) < 0) {
+            Pool& pool = m_Pools[p];
+            unsigned int vertexCapacity = std::max(pool.vertexCapacity, MIN_POOL_VERTICES);
+            unsigned int indexCapacity = std::max(pool.indexCapacity, MIN_POOL_INDICES);
+            unsigned int usedVertices = pool.vertexCapacity - freeCount(pool.freeVertices);
+            unsigned int usedIndices = pool.indexCapacity - freeCount(pool.freeIndices);
+            // the free space may only be fragmented, in which case packing the live ranges is enough
+            while (vertexCapacity - usedVertices < vertexCount)
+                vertexCapacity *= 2;
+            while (indexCapacity - usedIndices < indexCount)
+                indexCapacity *= 2;
+            relocate(p, vertexCapacity, indexCapacity);
+        }
+
+        Pool& pool = m_Pools[p];
+        Allocation allocation;
+        allocation.pool = p;
+        allocation.vertices = { takeRange(pool.freeVertices, findRange(pool.freeVertices, vertexCount), vertexCount), vertexCount };
+        allocation.indices = { takeRange(pool.freeIndices, findRange(pool.freeIndices, indexCount), indexCount), indexCount };
+
+        // the copy targets leave the bound VAO and its element buffer alone
+        size_t stride = pool.format.stride;
+        GLState::Get().BindBuffer(GL_COPY_WRITE_BUFFER, pool.vbo);
+        glBufferSubData(GL_COPY_WRITE_BUFFER, allocation.vertices.start * stride, vertexCount * stride, vertices);
+        GLState::Get().BindBuffer(GL_COPY_WRITE_BUFFER, pool.ebo);
+        glBufferSubData(GL_COPY_WRITE_BUFFER, allocation.indices.start * sizeof(unsigned int), indexCount * sizeof(unsigned int), indices);
+        GLState::Get().BindBuffer(GL_COPY_WRITE_BUFFER, 0);
+        m_UsedBytes += vertexCount * stride + indexCount * sizeof(unsigned int);
+
+        GeometryHandle handle;
+        if (!m_FreeIds.empty()) {
+            handle.id = m_FreeIds.back();
+            m_FreeIds.pop_back();
+            m_Allocations[handle.id] = allocation;
+        }
+        else {
+            handle.id = static_cast<int>(m_Allocations.size());
+            m_Allocations.push_back(allocation);
+        }
+        return handle;
+    }
+
+    void GeometryArena::Free(GeometryHandle handle)
+    {
+        if (!handle.IsValid() || handle.id >= static_cast<int>(m_Allocations.size()) || m_Allocations[handle.id].pool < 0)
+            return;
+        Allocation& allocation = m_Allocations[handle.id];
+        Pool& pool = m_Pools[allocation.pool];
+        releaseRange(pool.freeVertices, allocation.vertices);
+        releaseRange(pool.freeIndices, allocation.indices);
+        m_UsedBytes -= allocation.vertices.count * pool.format.stride + allocation.indices.count * sizeof(unsigned int);
+        allocation.pool = -1;
+        m_FreeIds.push_back(handle.id);
+    }
+
+    void GeometryArena::Bind(GeometryHandle handle) const
+    {
+        GLState::Get().BindVertexArray(GetVAO(handle));
+    }
+
+    void GeometryArena::Draw(GeometryHandle handle, GLenum mode) const
+    {
+        const Allocation& allocation = m_Allocations[handle.id];
+        glDrawElementsBaseVertex(mode, static_cast<GLsizei>(allocation.indices.count), GL_UNSIGNED_INT,
+                                 (void*)(allocation.indices.start * sizeof(unsigned int)), static_cast<GLint>(allocation.vertices.start));
+    }
+
+    void GeometryArena::DrawInstanced(GeometryHandle handle, unsigned int instanceCount, GLenum mode) const
+    {
+        const Allocation& allocation = m_Allocations[handle.id];
+        glDrawElementsInstancedBaseVertex(mode, static_cast<GLsizei>(allocation.indices.count), GL_UNSIGNED_INT,
+                                          (void*)(allocation.indices.start * sizeof(unsigned int)), instanceCount,
+                                          static_cast<GLint>(allocation.vertices.start));
+    }
+
+    void GeometryArena::Compact()
+    {
+        for (size_t p = 0; p < m_Pools.size(); p++) {
+            const Pool& pool = m_Pools[p];
+            // nothing to gain when all the free space is already one block at the end
+            bool packed = pool.freeVertices.size() <= 1 && pool.freeIndices.size() <= 1
+                && (pool.freeVertices.empty() || pool.freeVertices[0].start + pool.freeVertices[0].count == pool.vertexCapacity)
+                && (pool.freeIndices.empty() || pool.freeIndices[0].start + pool.freeIndices[0].count == pool.indexCapacity);
+            if (!packed)
+                relocate(static_cast<int>(p), pool.vertexCapacity, pool.indexCapacity);
+        }
+    }
+
+    unsigned int GeometryArena::GetVAO(GeometryHandle handle) const
+    {
+        return m_Pools[m_Allocations[handle.id].pool].vao;
+    }
+
+    unsigned int GeometryArena::GetFirstIndex(GeometryHandle handle) const
+    {
+        return m_Allocations[handle.id].indices.start;
+    }
+
+    unsigned int GeometryArena::GetIndexCount(GeometryHandle handle) const
+    {
+        return m_Allocations[handle.id].indices.count;
+    }
+
+    int GeometryArena::GetBaseVertex(GeometryHandle handle) const
+    {
+        return static_cast<int>(m_Allocations[handle.id].vertices.start);
+    }
+
+    // ------------------------------------------------------------------------
+    int GeometryArena::findPool(const VertexFormat& format)
+    {
+        std::string key = format.GetKey();
+        for (size_t p = 0; p < m_Pools.size(); p++)
+            if (m_Pools[p].key == key)
+                return static_cast<int>(p);
+
+        Pool pool;
+        pool.format = format;
+        pool.key = key;
+        m_Pools.push_back(pool);
+        return static_cast<int>(m_Pools.size()) - 1;
+    }
+
+    void GeometryArena::setupVAO(Pool& pool)
+    {
+        if (!pool.vao)
+            glGenVertexArrays(1, &pool.vao);
+        GLState::Get().BindVertexArray(pool.vao);
+        GLState::Get().BindBuffer(GL_ARRAY_BUFFER, pool.vbo);
+        for (const auto& attribute : pool.format.attributes) {
+            glEnableVertexAttribArray(attribute.location);
+            glVertexAttribPointer(attribute.location, attribute.components, attribute.type, attribute.normalized ? GL_TRUE : GL_FALSE,
+                                  static_cast<GLsizei>(pool.format.stride), (void*)attribute.offset);
+        }
+        GLState::Get().BindBuffer(GL_ELEMENT_ARRAY_BUFFER, pool.ebo);
+        GLState::Get().BindVertexArray(0);
+        GLState::Get().BindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+
+    void GeometryArena::relocate(int p, unsigned int vertexCapacity, unsigned int indexCapacity)
+    {
+        Pool& pool = m_Pools[p];
+        size_t stride = pool.format.stride;
+        unsigned int vbo, ebo;
+        glGenBuffers(1, &vbo);
+        glGenBuffers(1, &ebo);
+
+        // live ranges in buffer order; vertices and indices are packed separately
+        std::vector<Allocation*> live;
+        for (auto& allocation : m_Allocations)
+            if (allocation.pool == p)
+                live.push_back(&allocation);
+
+        // glCopyBufferSubData can't copy between overlapping ranges of one buffer, so the packed copy goes to new buffers
+        GLState::Get().BindBuffer(GL_COPY_WRITE_BUFFER, vbo);
+        glBufferData(GL_COPY_WRITE_BUFFER, vertexCapacity * stride, nullptr, GL_STATIC_DRAW);
+        GLState::Get().BindBuffer(GL_COPY_READ_BUFFER, pool.vbo);
+        std::sort(live.begin(), live.end(), [](const Allocation* a, const Allocation* b) { return a->vertices.start < b->vertices.start; });
+        unsigned int nextVertex = 0;
+        for (Allocation* allocation : live) {
+            glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, allocation->vertices.start * stride,
+                                nextVertex * stride, allocation->vertices.count * stride);
+            allocation->vertices.start = nextVertex;
+            nextVertex += allocation->vertices.count;
+        }
+
+        // indices are relative to the base vertex, so they move unchanged
+        GLState::Get().BindBuffer(GL_COPY_WRITE_BUFFER, ebo);
+        glBufferData(GL_COPY_WRITE_BUFFER, indexCapacity * sizeof(unsigned int), nullptr, GL_STATIC_DRAW);
+        GLState::Get().BindBuffer(GL_COPY_READ_BUFFER, pool.ebo);
+        std::sort(live.begin(), live.end(), [](const Allocation* a, const Allocation* b) { return a->indices.start < b->indices.start; });
+        unsigned int nextIndex = 0;
+        for (Allocation* allocation : live) {
+            glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, allocation->indices.start * sizeof(unsigned int),
+                                nextIndex * sizeof(unsigned int), allocation->indices.count * sizeof(unsigned int));
+            allocation->indices.start = nextIndex;
+            nextIndex += allocation->indices.count;
+        }
+        GLState::Get().BindBuffer(GL_COPY_READ_BUFFER, 0);
+        GLState::Get().BindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+        if (pool.vbo) {
+            GLState::Get().DeleteBuffers(1, &pool.vbo);
+            GLState::Get().DeleteBuffers(1, &pool.ebo);
+        }
+        m_CapacityBytes -= pool.vertexCapacity * stride + pool.indexCapacity * sizeof(unsigned int);
+        m_CapacityBytes += vertexCapacity * stride + indexCapacity * sizeof(unsigned int);
+        pool.vbo = vbo;
+        pool.ebo = ebo;
+        pool.vertexCapacity = vertexCapacity;
+        pool.indexCapacity = indexCapacity;
+        pool.freeVertices.clear();
+        pool.freeIndices.clear();
+        if (nextVertex < vertexCapacity)
+            pool.freeVertices.push_back({ nextVertex, vertexCapacity - nextVertex });
+        if (nextIndex < indexCapacity)
+            pool.freeIndices.push_back({ nextIndex, indexCapacity - nextIndex });
+        // the VAO still points at the old buffers
+        setupVAO(pool);
+        m_Generation++;
+    }
+
+    int GeometryArena::findRange(const std::vector<Range>& freeList, unsigned int count)
+    {
+        for (size_t i = 0; i < freeList.size(); i++)
+            if (freeList[i].count >= count)
+                return static_cast<int>(i);
+        return -1;
+    }
+
+    unsigned int GeometryArena::takeRange(std::vector<Range>& freeList, int index, unsigned int count)
+    {
+        Range& range = freeList[index];
+        unsigned int start = range.start;
+        range.start += count;
+        range.count -= count;
+        if (range.count == 0)
+            freeList.erase(freeList.begin() + index);
+        return start;
+    }
+
+    void GeometryArena::releaseRange(std::vector<Range>& freeList, Range range)
+    {
+        if (range.count == 0)
+            return;
+        auto next = std::lower_bound(freeList.begin(), freeList.end(), range,
+                                     [](const Range& a, const Range& b) { return a.start < b.start; });
+        next = freeList.insert(next, range);
+        // merge with the following range, then with the previous one
+        if (next + 1 != freeList.end() && next->start + next->count == (next + 1)->start) {
+            next->count += (next + 1)->count;
+            freeList.erase(next + 1);
+        }
+        if (next != freeList.begin() && (next - 1)->start + (next - 1)->count == next->start) {
+            (next - 1)->count += next->count;
+            freeList.erase(next);
+        }
+    }
+
+    unsigned int GeometryArena::freeCount(const std::vector<Range>& freeList)
+    {
+        unsigned int count = 0;
+        for (const auto& range : freeList)
+            count += range.count;
+        return count;
+    }
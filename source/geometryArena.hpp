@@ -0,0 +1,122 @@
+#pragma once
+
+#ifndef GEOMETRY_ARENA_H
+#define GEOMETRY_ARENA_H
+
+#include <glad/glad.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <string>
+#include <vector>
+
+// one vertex attribute, as given to glVertexAttribPointer
+struct VertexAttribute {
+    unsigned int location;
+    int components;
+    GLenum type;
+    bool normalized;
+    size_t offset;
+};
+
+/* Interleaved vertex layout. Geometry with the same format shares one vertex
+   buffer, one index buffer and one VAO in the arena. */
+struct VertexFormat {
+    size_t stride = 0;
+    std::vector<VertexAttribute> attributes;
+
+    // floats only, e.g. Floats({ 3, 3, 2 }) for position, normal and uv on locations 0, 1 and 2
+    static VertexFormat Floats(std::initializer_list<int> components);
+
+    std::string GetKey() const;
+};
+
+// sub-allocation in the arena; stays valid when the arena grows or compacts
+struct GeometryHandle {
+    int id = -1;
+    inline bool IsValid() const { return id >= 0; }
+};
+
+/* Library-wide store for static geometry. Vertices and indices live in large
+   buffers per vertex format and every piece of geometry is a range in them,
+   drawn with glDrawElementsBaseVertex, so objects of the same format draw
+   without rebinding a VAO. Indices are 32 bit and relative to the range.
+   Freed ranges go back to a free list; Compact() (or a pool that runs out of
+   room) packs the live ranges together again with GPU copies. */
+class GeometryArena {
+public:
+    static GeometryArena& Get();
+
+    GeometryArena(const GeometryArena&) = delete;
+    GeometryArena& operator=(const GeometryArena&) = delete;
+
+    GeometryHandle Allocate(const VertexFormat& format, const void* vertices, unsigned int vertexCount,
+                            const unsigned int* indices, unsigned int indexCount);
+    void Free(GeometryHandle handle);
+
+    // binds the VAO of the handle's format; objects of one format only need it once
+    void Bind(GeometryHandle handle) const;
+    // draws the handle with the VAO of its format already bound
+    void Draw(GeometryHandle handle, GLenum mode = GL_TRIANGLES) const;
+    void DrawInstanced(GeometryHandle handle, unsigned int instanceCount, GLenum mode = GL_TRIANGLES) const;
+
+    // packs the live ranges of every pool to the front of its buffers
+    void Compact();
+
+    unsigned int GetVAO(GeometryHandle handle) const;
+    // first index (in indices) and base vertex of the handle, for batching draws
+    unsigned int GetFirstIndex(GeometryHandle handle) const;
+    unsigned int GetIndexCount(GeometryHandle handle) const;
+    int GetBaseVertex(GeometryHandle handle) const;
+
+    // changes whenever ranges move (a pool grows or compacts), so copies of their offsets can be refreshed
+    inline uint64_t GetGeneration() const { return m_Generation; }
+
+    inline size_t GetCapacityBytes() const { return m_CapacityBytes; }
+    inline size_t GetUsedBytes() const { return m_UsedBytes; }
+
+private:
+    GeometryArena() : m_CapacityBytes(0), m_UsedBytes(0), m_Generation(0) {}
+
+    struct Range {
+        unsigned int start;
+        unsigned int count;
+    };
+
+    struct Allocation {
+        // -1 once freed
+        int pool;
+        Range vertices;
+        Range indices;
+    };
+
+    // buffers, VAO and free space of one vertex format
+    struct Pool {
+        VertexFormat format;
+        std::string key;
+        unsigned int vao = 0, vbo = 0, ebo = 0;
+        unsigned int vertexCapacity = 0, indexCapacity = 0;
+        // sorted by start, adjacent ranges merged
+        std::vector<Range> freeVertices, freeIndices;
+    };
+
+    int findPool(const VertexFormat& format);
+    void setupVAO(Pool& pool);
+    // moves the pool into new buffers of the given capacities with its live ranges packed at the front
+    void relocate(int pool, unsigned int vertexCapacity, unsigned int indexCapacity);
+    // first fit: index in the free list of a range holding count elements, -1 if none does
+    static int findRange(const std::vector<Range>& freeList, unsigned int count);
+    static unsigned int takeRange(std::vector<Range>& freeList, int index, unsigned int count);
+    static void releaseRange(std::vector<Range>& freeList, Range range);
+    static unsigned int freeCount(const std::vector<Range>& freeList);
+
+    std::vector<Pool> m_Pools;
+    std::vector<Allocation> m_Allocations;
+    // ids of freed allocations, reused by Allocate
+    std::vector<int> m_FreeIds;
+    size_t m_CapacityBytes;
+    size_t m_UsedBytes;
+    uint64_t m_Generation;
+};
+#endif
@@ -0,0 +1,148 @@
+#include "glState.hpp"
+
+    GLState& GLState::Get()
+    {
+        static GLState state;
+        return state;
+    }
+
+    int GLState::textureTarget(GLenum target)
+    {
+        switch (target) {
+        case GL_TEXTURE_2D: return 0;
+        case GL_TEXTURE_CUBE_MAP: return 1;
+        case GL_TEXTURE_BUFFER: return 2;
+        default: return -1;
+        }
+    }
+
+    int GLState::bufferTarget(GLenum target)
+    {
+        switch (target) {
+        case GL_ARRAY_BUFFER: return 0;
+        case GL_COPY_READ_BUFFER: return 1;
+        case GL_COPY_WRITE_BUFFER: return 2;
+        case GL_DRAW_INDIRECT_BUFFER: return 3;
+        case GL_UNIFORM_BUFFER: return 4;
+        case GL_TEXTURE_BUFFER: return 5;
+        case GL_SHADER_STORAGE_BUFFER: return 6;
+        case GL_PIXEL_UNPACK_BUFFER: return 7;
+        default: return -1;
+        }
+    }
+
+    bool GLState::skip(unsigned int& current, unsigned int value)
+    {
+        if (current == value) {
+            m_Stats.skipped++;
+            return true;
+        }
+        current = value;
+        m_Stats.issued++;
+        return false;
+    }
+
+    // ------------------------------------------------------------------------
+    void GLState::UseProgram(unsigned int program)
+    {
+        if (!skip(m_Program, program))
+            glUseProgram(program);
+    }
+
+    void GLState::BindVertexArray(unsigned int vao)
+    {
+        if (!skip(m_VAO, vao))
+            glBindVertexArray(vao);
+    }
+
+    void GLState::ActiveTexture(GLenum unit)
+    {
+        if (!skip(m_ActiveUnit, unit - GL_TEXTURE0))
+            glActiveTexture(unit);
+    }
+
+    void GLState::BindTexture(GLenum target, unsigned int texture)
+    {
+        int slot = textureTarget(target);
+        if (slot < 0 || m_ActiveUnit >= TEXTURE_UNITS) {
+            // untracked, and whatever the unit had for it is unknown now
+            if (slot >= 0)
+                for (auto& unit : m_Textures)
+                    unit[slot] = UNKNOWN;
+            m_Stats.issued++;
+            glBindTexture(target, texture);
+            return;
+        }
+        if (!skip(m_Textures[m_ActiveUnit][slot], texture))
+            glBindTexture(target, texture);
+    }
+
+    void GLState::BindBuffer(GLenum target, unsigned int buffer)
+    {
+        int slot = bufferTarget(target);
+        if (slot < 0) {
+            m_Stats.issued++;
+            glBindBuffer(target, buffer);
+            return;
+        }
+        if (!skip(m_Buffers[slot], buffer))
+            glBindBuffer(target, buffer);
+    }
+
+    void GLState::BindBufferBase(GLenum target, unsigned int index, unsigned int buffer)
+    {
+        // indexed bindings aren't tracked, the call always goes through
+        int slot = bufferTarget(target);
+        if (slot >= 0)
+            m_Buffers[slot] = buffer;
+        m_Stats.issued++;
+        glBindBufferBase(target, index, buffer);
+    }
+
+    // ------------------------------------------------------------------------
+    void GLState::DeleteProgram(unsigned int program)
+    {
+        // a program in use is only flagged for deletion; force the next UseProgram through
+        if (m_Program == program)
+            m_Program = UNKNOWN;
+        glDeleteProgram(program);
+    }
+
+    void GLState::DeleteVertexArrays(GLsizei count, const unsigned int* vaos)
+    {
+        for (GLsizei i = 0; i < count; i++)
+            if (vaos[i] && m_VAO == vaos[i])
+                m_VAO = 0;
+        glDeleteVertexArrays(count, vaos);
+    }
+
+    void GLState::DeleteTextures(GLsizei count, const unsigned int* textures)
+    {
+        for (GLsizei i = 0; i < count; i++)
+            for (auto& unit : m_Textures)
+                for (auto& bound : unit)
+                    if (textures[i] && bound == textures[i])
+                        bound = 0;
+        glDeleteTextures(count, textures);
+    }
+
+    void GLState::DeleteBuffers(GLsizei count, const unsigned int* buffers)
+    {
+        for (GLsizei i = 0; i < count; i++)
+            for (auto& bound : m_Buffers)
+                if (buffers[i] && bound == buffers[i])
+                    bound = 0;
+        glDeleteBuffers(count, buffers);
+    }
+
+    void GLState::Invalidate()
+    {
+        m_Program = UNKNOWN;
+        m_VAO = UNKNOWN;
+        m_ActiveUnit = UNKNOWN;
+        for (auto& unit : m_Textures)
+            for (auto& bound : unit)
+                bound = UNKNOWN;
+        for (auto& bound : m_Buffers)
+            bound = UNKNOWN;
+    }
@@ -0,0 +1,75 @@
+#pragma once
+
+#ifndef GL_STATE_H
+#define GL_STATE_H
+
+#include <glad/glad.h>
+
+#include <cstdint>
+
+// binds sent to GL and the ones dropped because GL already had that state
+struct GLStateStats {
+    uint64_t issued = 0;
+    uint64_t skipped = 0;
+};
+
+/* Shadow copy of the GL binding state: program, VAO, active texture unit,
+   textures per unit and buffers per target. Every bind in the library and
+   the examples goes through here, so a bind of what is already bound never
+   reaches the driver. Deleting through here unbinds the names GL unbinds,
+   since GL hands deleted names out again. GL_ELEMENT_ARRAY_BUFFER belongs
+   to the bound VAO and is always passed on. Code that binds behind its back
+   (e.g. a UI backend that doesn't restore state) has to call Invalidate().
+   Tracks the single context of the library's GL thread. */
+class GLState {
+public:
+    static GLState& Get();
+
+    GLState(const GLState&) = delete;
+    GLState& operator=(const GLState&) = delete;
+
+    void UseProgram(unsigned int program);
+    void BindVertexArray(unsigned int vao);
+    // unit as GL_TEXTURE0 + i, like glActiveTexture
+    void ActiveTexture(GLenum unit);
+    // binds to the active unit
+    void BindTexture(GLenum target, unsigned int texture);
+    void BindBuffer(GLenum target, unsigned int buffer);
+    // also binds the buffer to the target's generic binding point, as GL does
+    void BindBufferBase(GLenum target, unsigned int index, unsigned int buffer);
+
+    void DeleteProgram(unsigned int program);
+    void DeleteVertexArrays(GLsizei count, const unsigned int* vaos);
+    void DeleteTextures(GLsizei count, const unsigned int* textures);
+    void DeleteBuffers(GLsizei count, const unsigned int* buffers);
+
+    // forgets everything tracked, so the next bind of each kind reaches GL
+    void Invalidate();
+
+    // totals since the last reset, e.g. once per frame
+    inline const GLStateStats& GetStats() const { return m_Stats; }
+    void ResetStats() { m_Stats = GLStateStats(); }
+
+private:
+    GLState() { Invalidate(); }
+
+    static constexpr int TEXTURE_UNITS = 32;
+    static constexpr int TEXTURE_TARGETS = 3;
+    static constexpr int BUFFER_TARGETS = 8;
+    // name that matches no GL object, for state not known
+    static constexpr unsigned int UNKNOWN = ~0u;
+
+    // slot of a tracked target, -1 for targets passed on untracked
+    static int textureTarget(GLenum target);
+    static int bufferTarget(GLenum target);
+    // true when the value was current already; otherwise records it
+    bool skip(unsigned int& current, unsigned int value);
+
+    unsigned int m_Program;
+    unsigned int m_VAO;
+    unsigned int m_ActiveUnit;
+    unsigned int m_Textures[TEXTURE_UNITS][TEXTURE_TARGETS];
+    unsigned int m_Buffers[BUFFER_TARGETS];
+    GLStateStats m_Stats;
+};
+#endif
@@ -0,0 +1,158 @@
+#include "jobSystem.hpp"
+
+#include <algorithm>
+
+    JobSystem::JobSystem(unsigned int workerCount)
+        : m_Queues(), m_QueuedTasks(0), m_NextQueue(0), m_Stopping(false)
+    {
+        if (workerCount == 0) {
+            unsigned int hardwareThreads = std::thread::hardware_concurrency();
+            workerCount = hardwareThreads > 1 ? hardwareThreads - 1 : 0;
+        }
+        // one queue per worker plus one for the submitting thread
+        m_Queues = std::vector<WorkerQueue>(workerCount + 1);
+        m_Workers.reserve(workerCount);
+        for (unsigned int i = 0; i < workerCount; i++)
+            m_Workers.emplace_back(&JobSystem::WorkerLoop, this, i);
+    }
+
+    JobSystem::~JobSystem()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_SleepMutex);
+            m_Stopping = true;
+        }
+        m_WakeUp.notify_all();
+        for (auto& worker : m_Workers)
+            worker.join();
+    }
+
+    // ------------------------------------------------------------------------
+    void JobSystem::ParallelFor(int count, int grainSize, const std::function<void(int, int)>& job)
+    {
+        if (count <= 0)
+            return;
+        grainSize = std::max(grainSize, 1);
+        if (m_Workers.empty() || count <= grainSize) {
+            job(0, count);
+            return;
+        }
+
+        int chunks = (count + grainSize - 1) / grainSize;
+        std::atomic<int> pending(chunks);
+
+        // deal the chunks round-robin over the queues; stealing fixes any imbalance
+        unsigned int queueCount = static_cast<unsigned int>(m_Queues.size());
+        for (int chunk = 0; chunk < chunks; chunk++) {
+            Task task{ &job, chunk * grainSize, std::min(count, (chunk + 1) * grainSize), &pending, nullptr };
+            WorkerQueue& queue = m_Queues[chunk % queueCount];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            queue.tasks.push_back(task);
+        }
+        m_QueuedTasks.fetch_add(chunks);
+        {
+            std::lock_guard<std::mutex> lock(m_SleepMutex);
+        }
+        m_WakeUp.notify_all();
+
+        // the caller works on its own queue, then steals, until the batch is done
+        unsigned int callerIndex = queueCount - 1;
+        Task task;
+        while (pending.load(std::memory_order_acquire) > 0) {
+            if (PopTask(callerIndex, task))
+                Execute(task);
+            else
+                std::this_thread::yield();
+        }
+    }
+
+    // ------------------------------------------------------------------------
+    void JobSystem::Submit(JobGroup& group, std::function<void()> job)
+    {
+        if (m_Workers.empty()) {
+            job();
+            return;
+        }
+
+        group.m_Pending.fetch_add(1, std::memory_order_relaxed);
+        Task task{ nullptr, 0, 0, &group.m_Pending, std::move(job) };
+        {
+            // spread over the worker queues only, the caller's queue is drained in Wait
+            WorkerQueue& queue = m_Queues[m_NextQueue.fetch_add(1) % m_Workers.size()];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            queue.tasks.push_back(std::move(task));
+        }
+        m_QueuedTasks.fetch_add(1);
+        {
+            std::lock_guard<std::mutex> lock(m_SleepMutex);
+        }
+        m_WakeUp.notify_one();
+    }
+
+    void JobSystem::Wait(JobGroup& group)
+    {
+        unsigned int callerIndex = static_cast<unsigned int>(m_Queues.size()) - 1;
+        Task task;
+        while (!group.IsDone()) {
+            if (PopTask(callerIndex, task))
+                Execute(task);
+            else
+                std::this_thread::yield();
+        }
+    }
+
+    // ------------------------------------------------------------------------
+    void JobSystem::WorkerLoop(unsigned int index)
+    {
+        Task task;
+        while (true) {
+            if (PopTask(index, task)) {
+                Execute(task);
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(m_SleepMutex);
+            m_WakeUp.wait(lock, [this] { return m_Stopping || m_QueuedTasks.load() > 0; });
+            if (m_Stopping && m_QueuedTasks.load() == 0)
+                return;
+        }
+    }
+
+    bool JobSystem::PopTask(unsigned int index, Task& task)
+    {
+        {
+            WorkerQueue& queue = m_Queues[index];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (!queue.tasks.empty()) {
+                task = std::move(queue.tasks.back());
+                queue.tasks.pop_back();
+                m_QueuedTasks.fetch_sub(1);
+                return true;
+            }
+        }
+        return StealTask(index, task);
+    }
+
+    bool JobSystem::StealTask(unsigned int thief, Task& task)
+    {
+        unsigned int queueCount = static_cast<unsigned int>(m_Queues.size());
+        for (unsigned int offset = 1; offset < queueCount; offset++) {
+            WorkerQueue& victim = m_Queues[(thief + offset) % queueCount];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (!victim.tasks.empty()) {
+                task = std::move(victim.tasks.front());
+                victim.tasks.pop_front();
+                m_QueuedTasks.fetch_sub(1);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void JobSystem::Execute(const Task& task)
+    {
+        if (task.work)
+            task.work();
+        else
+            (*task.job)(task.begin, task.end);
+        task.pending->fetch_sub(1, std::memory_order_release);
+    }
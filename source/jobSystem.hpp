@@ -0,0 +1,81 @@
+#pragma once
+
+#ifndef JOB_SYSTEM_H
+#define JOB_SYSTEM_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/* Tracks a set of jobs handed to JobSystem::Submit */
+class JobGroup {
+public:
+    JobGroup() : m_Pending(0) {}
+
+    JobGroup(const JobGroup&) = delete;
+    JobGroup& operator=(const JobGroup&) = delete;
+
+    bool IsDone() const { return m_Pending.load(std::memory_order_acquire) == 0; }
+
+private:
+    friend class JobSystem;
+    std::atomic<int> m_Pending;
+};
+
+/* Fixed pool of worker threads. Every worker owns a task queue: it pops its
+   own tasks from the back and, once it runs dry, steals from the front of
+   the other queues, so batches with uneven task costs still balance out.
+   The thread that submits a batch helps running it while it waits. */
+class JobSystem {
+public:
+    // workerCount 0 uses one worker per hardware thread, minus the calling thread
+    explicit JobSystem(unsigned int workerCount = 0);
+    ~JobSystem();
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    unsigned int GetWorkerCount() const { return static_cast<unsigned int>(m_Workers.size()); }
+
+    // runs job(begin, end) over [0, count) in chunks of grainSize and returns once every chunk is done
+    void ParallelFor(int count, int grainSize, const std::function<void(int, int)>& job);
+
+    // queues job to run on a worker and returns right away; runs it inline when there are no workers
+    void Submit(JobGroup& group, std::function<void()> job);
+    // returns once every job submitted to group is done, running queued jobs meanwhile
+    void Wait(JobGroup& group);
+
+private:
+    struct Task {
+        const std::function<void(int, int)>* job;
+        int begin;
+        int end;
+        std::atomic<int>* pending;
+        // set for Submit tasks, which own their job instead of sharing a ParallelFor range
+        std::function<void()> work;
+    };
+
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    void WorkerLoop(unsigned int index);
+    bool PopTask(unsigned int index, Task& task);
+    bool StealTask(unsigned int thief, Task& task);
+    void Execute(const Task& task);
+
+    std::vector<std::thread> m_Workers;
+    std::vector<WorkerQueue> m_Queues;
+    std::atomic<int> m_QueuedTasks;
+    std::atomic<unsigned int> m_NextQueue;
+    std::mutex m_SleepMutex;
+    std::condition_variable m_WakeUp;
+    bool m_Stopping;
+};
+
+#endif
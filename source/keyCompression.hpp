@@ -0,0 +1,202 @@
+#pragma once
+
+/* Keyframe compression for animation channels. Keys that linear interpolation
+   between their neighbours already reproduces within a tolerance are removed,
+   rotations are packed as smallest-three quaternions (48 bits) and positions
+   and scales are quantized to 16 bits per component inside the range of their
+   track. Every key decodes on its own with a few multiplies, so compressed
+   clips are sampled directly without unpacking them first. */
+
+#include <vector>
+#include <cmath>
+#include <cstdint>
+#include <algorithm>
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+/* Largest error each reduction may introduce: distance for positions and
+   scales, angle in radians for rotations */
+struct KeyCompressionSettings
+{
+	float positionError = 0.001f;
+	float rotationError = 0.0005f;
+	float scaleError = 0.0001f;
+};
+
+namespace KeyCompression
+{
+	/* Removes every key that the lerp of the keys kept around it reproduces
+	   within tolerance. The first and last keys are always kept, and a track
+	   that turns out to be constant collapses to a single key. */
+	template <typename T, typename Lerp, typename Error>
+	void ReduceKeys(std::vector<float>& times, std::vector<T>& values, float tolerance, Lerp lerp, Error error)
+	{
+		if (values.size() < 2)
+			return;
+
+		std::vector<float> keptTimes{ times.front() };
+		std::vector<T> keptValues{ values.front() };
+		size_t anchor = 0;
+		for (size_t end = 2; end < values.size(); end++)
+		{
+			float span = times[end] - times[anchor];
+			bool fits = span > 0.0f;
+			for (size_t key = anchor + 1; fits && key < end; key++)
+			{
+				float factor = (times[key] - times[anchor]) / span;
+				fits = error(lerp(values[anchor], values[end], factor), values[key]) <= tolerance;
+			}
+			if (!fits)
+			{
+				anchor = end - 1;
+				keptTimes.push_back(times[anchor]);
+				keptValues.push_back(values[anchor]);
+			}
+		}
+
+		if (keptValues.size() == 1 && error(values.front(), values.back()) <= tolerance)
+		{
+			times = std::move(keptTimes);
+			values = std::move(keptValues);
+			return;
+		}
+		keptTimes.push_back(times.back());
+		keptValues.push_back(values.back());
+		times = std::move(keptTimes);
+		values = std::move(keptValues);
+	}
+
+	inline void ReduceVec3Keys(std::vector<float>& times, std::vector<glm::vec3>& values, float tolerance)
+	{
+		ReduceKeys(times, values, tolerance,
+			[](const glm::vec3& a, const glm::vec3& b, float t) { return glm::mix(a, b, t); },
+			[](const glm::vec3& a, const glm::vec3& b) { return glm::length(a - b); });
+	}
+
+	/* Rotations are checked against the normalized lerp the TRS sampler uses */
+	inline void ReduceQuatKeys(std::vector<float>& times, std::vector<glm::quat>& values, float tolerance)
+	{
+		ReduceKeys(times, values, tolerance,
+			[](const glm::quat& a, const glm::quat& b, float t)
+			{
+				glm::quat end = glm::dot(a, b) < 0.0f ? -b : b;
+				return glm::normalize(a * (1.0f - t) + end * t);
+			},
+			[](const glm::quat& a, const glm::quat& b)
+			{
+				float cosine = std::min(std::abs(glm::dot(glm::normalize(a), glm::normalize(b))), 1.0f);
+				return 2.0f * std::acos(cosine);
+			});
+	}
+
+	/* Vec3 keys quantized to 16 bits per component over the bounds of the track */
+	class QuantizedVec3Track
+	{
+	public:
+		void Encode(const std::vector<glm::vec3>& values)
+		{
+			m_Min = glm::vec3(0.0f);
+			m_Step = glm::vec3(0.0f);
+			m_Values.clear();
+			if (values.empty())
+				return;
+
+			glm::vec3 max = values.front();
+			m_Min = values.front();
+			for (const auto& value : values)
+			{
+				m_Min = glm::min(m_Min, value);
+				max = glm::max(max, value);
+			}
+			m_Step = (max - m_Min) / 65535.0f;
+
+			m_Values.reserve(values.size() * 3);
+			for (const auto& value : values)
+			{
+				for (int i = 0; i < 3; i++)
+				{
+					float normalized = m_Step[i] > 0.0f ? (value[i] - m_Min[i]) / m_Step[i] : 0.0f;
+					m_Values.push_back(static_cast<uint16_t>(std::clamp(std::lround(normalized), 0L, 65535L)));
+				}
+			}
+		}
+
+		inline glm::vec3 Decode(int index) const
+		{
+			const uint16_t* key = &m_Values[static_cast<size_t>(index) * 3];
+			return m_Min + m_Step * glm::vec3(key[0], key[1], key[2]);
+		}
+
+		inline size_t GetByteSize() const { return sizeof(*this) + m_Values.size() * sizeof(uint16_t); }
+
+	private:
+		glm::vec3 m_Min = glm::vec3(0.0f);
+		glm::vec3 m_Step = glm::vec3(0.0f);
+		std::vector<uint16_t> m_Values;
+	};
+
+	/* Quaternions in 48 bits: the three smallest components get 15 bits each
+	   in [-1/sqrt(2), 1/sqrt(2)], the two spare high bits hold which component
+	   was dropped, and that one is rebuilt from the unit length */
+	class QuantizedQuatTrack
+	{
+	public:
+		void Encode(const std::vector<glm::quat>& values)
+		{
+			m_Values.clear();
+			m_Values.reserve(values.size() * 3);
+			for (const auto& value : values)
+			{
+				glm::quat q = glm::normalize(value);
+				float components[4] = { q.x, q.y, q.z, q.w };
+				int largest = 0;
+				for (int i = 1; i < 4; i++)
+				{
+					if (std::abs(components[i]) > std::abs(components[largest]))
+						largest = i;
+				}
+				// q and -q are the same rotation, keep the dropped component positive
+				float sign = components[largest] < 0.0f ? -1.0f : 1.0f;
+
+				uint16_t packed[3];
+				for (int i = 0, slot = 0; i < 4; i++)
+				{
+					if (i == largest)
+						continue;
+					float normalized = (sign * components[i] * SQRT_2 + 1.0f) * 0.5f;
+					packed[slot++] = static_cast<uint16_t>(std::clamp(std::lround(normalized * 32767.0f), 0L, 32767L));
+				}
+				packed[0] |= static_cast<uint16_t>((largest >> 1) << 15);
+				packed[1] |= static_cast<uint16_t>((largest & 1) << 15);
+				m_Values.insert(m_Values.end(), packed, packed + 3);
+			}
+		}
+
+		inline glm::quat Decode(int index) const
+		{
+			const uint16_t* key = &m_Values[static_cast<size_t>(index) * 3];
+			int largest = ((key[0] >> 15) << 1) | (key[1] >> 15);
+
+			float components[4];
+			float sum = 0.0f;
+			for (int i = 0, slot = 0; i < 4; i++)
+			{
+				if (i == largest)
+					continue;
+				float value = ((key[slot++] & 0x7FFF) * (2.0f / 32767.0f) - 1.0f) * INV_SQRT_2;
+				components[i] = value;
+				sum += value * value;
+			}
+			components[largest] = std::sqrt(std::max(1.0f - sum, 0.0f));
+			return glm::quat(components[3], components[0], components[1], components[2]);
+		}
+
+		inline size_t GetByteSize() const { return sizeof(*this) + m_Values.size() * sizeof(uint16_t); }
+
+	private:
+		static constexpr float SQRT_2 = 1.41421356f;
+		static constexpr float INV_SQRT_2 = 0.70710678f;
+
+		std::vector<uint16_t> m_Values;
+	};
+}
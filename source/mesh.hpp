@@ -6,10 +6,17 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 
+#include "geometryArena.hpp"
+#include "glState.hpp"
 #include "shaders/shader.hpp"
+#include "textureUnits.hpp"
 
 #include <string>
 #include <vector>
+#include <span>
+#include <cmath>
+#include <cstring>
+#include <algorithm>
 using namespace std;
 
 #define MAX_BONE_INFLUENCE 4
@@ -25,10 +32,12 @@ struct Vertex {
     glm::vec3 Tangent;
     // bitangent
     glm::vec3 Bitangent;
-	//bone indexes which will influence this vertex
-	int m_BoneIDs[MAX_BONE_INFLUENCE];
-	//weights from each bone
-	float m_Weights[MAX_BONE_INFLUENCE];
+};
+
+// bone influences of a skinned vertex, strongest first; unused slots have weight 0
+struct VertexSkin {
+    unsigned short boneIDs[MAX_BONE_INFLUENCE];
+    float weights[MAX_BONE_INFLUENCE];
 };
 
 struct Texture {
@@ -37,84 +46,249 @@ struct Texture {
     string path;
 };
 
+/* Static meshes live in the GeometryArena and draw under the shared VAO of
+   the Vertex format. Skinned meshes, and meshes whose callers add attributes
+   of their own (see UseOwnVAO), keep a VAO and buffers per mesh. */
 class Mesh {
 public:
     // mesh Data
     vector<Vertex>       vertices;
     vector<unsigned int> indices;
     vector<Texture>      textures;
-    unsigned int VAO;
+    // one entry per vertex for skinned meshes, empty for static ones
+    vector<VertexSkin>   skin;
+    // the mesh's own VAO, 0 while it draws from the arena
+    unsigned int VAO = 0;
 
     // constructor
-    Mesh(vector<Vertex> vertices, vector<unsigned int> indices, vector<Texture> textures)
+    Mesh(vector<Vertex> vertices, vector<unsigned int> indices, vector<Texture> textures, vector<VertexSkin> skin = {})
     {
         this->vertices = vertices;
         this->indices = indices;
         this->textures = textures;
+        this->skin = skin;
 
         // now that we have all the required data, set the vertex buffers and its attribute pointers.
         setupMesh();
+        setupBindings();
+    }
+
+    // constructor from data that is already laid out for upload, e.g. mapped from a MeshCache
+    Mesh(span<const Vertex> vertices, span<const unsigned int> indices, vector<Texture> textures, span<const VertexSkin> skin)
+        : vertices(vertices.begin(), vertices.end()), indices(indices.begin(), indices.end()),
+          textures(textures), skin(skin.begin(), skin.end())
+    {
+        setupMesh();
+        setupBindings();
     }
 
     // render the mesh
     void Draw(Shader &shader) 
     {
-        // bind appropriate textures
-        unsigned int diffuseNr  = 1;
-        unsigned int specularNr = 1;
-        unsigned int normalNr   = 1;
-        unsigned int heightNr   = 1;
-        for(unsigned int i = 0; i < textures.size(); i++)
-        {
-            glActiveTexture(GL_TEXTURE0 + i); // active proper texture unit before binding
-            // retrieve texture number (the N in diffuse_textureN)
-            string number;
-            string name = textures[i].type;
-            if(name == "texture_diffuse")
-                number = std::to_string(diffuseNr++);
-            else if(name == "texture_specular")
-                number = std::to_string(specularNr++); // transfer unsigned int to string
-            else if(name == "texture_normal")
-                number = std::to_string(normalNr++); // transfer unsigned int to string
-             else if(name == "texture_height")
-                number = std::to_string(heightNr++); // transfer unsigned int to string
-
-            // now set the sampler to the correct texture unit
-            glUniform1i(glGetUniformLocation(shader.ID, (name + number).c_str()), i);
-            // and finally bind the texture
-            glBindTexture(GL_TEXTURE_2D, textures[i].id);
-        }
-        
+        bindTextures(shader);
+        bindDefaultSkin();
+
         // draw mesh
-        glBindVertexArray(VAO);
-        glDrawElements(GL_TRIANGLES, static_cast<unsigned int>(indices.size()), GL_UNSIGNED_INT, 0);
-        glBindVertexArray(0);
+        if (geometry.IsValid()) {
+            GeometryArena::Get().Bind(geometry);
+            GeometryArena::Get().Draw(geometry);
+        }
+        else {
+            GLState::Get().BindVertexArray(VAO);
+            glDrawElements(GL_TRIANGLES, static_cast<unsigned int>(indices.size()), GL_UNSIGNED_INT, 0);
+        }
 
         // always good practice to set everything back to defaults once configured.
-        glActiveTexture(GL_TEXTURE0);
+        GLState::Get().ActiveTexture(GL_TEXTURE0);
+    }
+
+    // render instanceCount copies of the mesh, the per-instance attributes must be set up on UseOwnVAO()
+    void DrawInstanced(Shader &shader, unsigned int instanceCount)
+    {
+        bindTextures(shader);
+        bindDefaultSkin();
+
+        if (geometry.IsValid()) {
+            GeometryArena::Get().Bind(geometry);
+            GeometryArena::Get().DrawInstanced(geometry, instanceCount);
+        }
+        else {
+            GLState::Get().BindVertexArray(VAO);
+            glDrawElementsInstanced(GL_TRIANGLES, static_cast<unsigned int>(indices.size()), GL_UNSIGNED_INT, 0, instanceCount);
+        }
+
+        GLState::Get().ActiveTexture(GL_TEXTURE0);
+    }
+
+    /* Moves a mesh out of the arena into buffers of its own, for callers that
+       add attributes to its VAO (e.g. per-instance ones). Returns that VAO. */
+    unsigned int UseOwnVAO()
+    {
+        if (geometry.IsValid()) {
+            GeometryArena::Get().Free(geometry);
+            geometry = GeometryHandle();
+            setupBuffers();
+        }
+        return VAO;
+    }
+
+    // gives the mesh's range back to the arena; meshes with their own buffers keep them
+    void ReleaseGeometry()
+    {
+        GeometryArena::Get().Free(geometry);
+        geometry = GeometryHandle();
+    }
+
+    // layout of Vertex, shared by every static mesh in the arena
+    static const VertexFormat& GetVertexFormat()
+    {
+        static const VertexFormat format = { sizeof(Vertex), {
+            { 0, 3, GL_FLOAT, false, offsetof(Vertex, Position) },
+            { 1, 3, GL_FLOAT, false, offsetof(Vertex, Normal) },
+            { 2, 2, GL_FLOAT, false, offsetof(Vertex, TexCoords) },
+            { 3, 3, GL_FLOAT, false, offsetof(Vertex, Tangent) },
+            { 4, 3, GL_FLOAT, false, offsetof(Vertex, Bitangent) } } };
+        return format;
     }
 
 private:
     // render data 
-    unsigned int VBO, EBO;
+    unsigned int VBO = 0, EBO = 0, skinVBO = 0;
+    // range in the arena for static meshes, invalid for meshes with their own buffers
+    GeometryHandle geometry;
 
-    // initializes all the buffer objects/arrays
+    // meshes without a skin stream read zero weights, which skinning shaders treat as the bind pose
+    void bindDefaultSkin()
+    {
+        if (skin.empty())
+            glVertexAttrib4f(6, 0.0f, 0.0f, 0.0f, 0.0f);
+    }
+
+    /* Packs the skin into its GPU layout: 8 bit bone indices and unorm8
+       weights (8 bytes per vertex) when every bone index fits in a byte,
+       16 bit indices and unorm16 weights (16 bytes) otherwise */
+    void setupSkin()
+    {
+        unsigned short maxBone = 0;
+        for (const auto& influences : skin)
+            for (int i = 0; i < MAX_BONE_INFLUENCE; i++)
+                maxBone = std::max(maxBone, influences.boneIDs[i]);
+        bool wide = maxBone > 255;
+        size_t componentSize = wide ? 2 : 1;
+        size_t stride = 2 * MAX_BONE_INFLUENCE * componentSize;
+        float maxWeight = wide ? 65535.0f : 255.0f;
+
+        vector<unsigned char> packed(skin.size() * stride);
+        for (size_t v = 0; v < skin.size(); v++) {
+            unsigned char* ids = &packed[v * stride];
+            unsigned char* weights = ids + MAX_BONE_INFLUENCE * componentSize;
+            for (int i = 0; i < MAX_BONE_INFLUENCE; i++) {
+                unsigned short weight = static_cast<unsigned short>(std::lround(std::clamp(skin[v].weights[i], 0.0f, 1.0f) * maxWeight));
+                if (wide) {
+                    std::memcpy(ids + i * 2, &skin[v].boneIDs[i], 2);
+                    std::memcpy(weights + i * 2, &weight, 2);
+                }
+                else {
+                    ids[i] = static_cast<unsigned char>(skin[v].boneIDs[i]);
+                    weights[i] = static_cast<unsigned char>(weight);
+                }
+            }
+        }
+
+        glGenBuffers(1, &skinVBO);
+        GLState::Get().BindBuffer(GL_ARRAY_BUFFER, skinVBO);
+        glBufferData(GL_ARRAY_BUFFER, packed.size(), packed.data(), GL_STATIC_DRAW);
+        GLenum type = wide ? GL_UNSIGNED_SHORT : GL_UNSIGNED_BYTE;
+        // ids
+        glEnableVertexAttribArray(5);
+        glVertexAttribIPointer(5, 4, type, static_cast<GLsizei>(stride), (void*)0);
+        // weights
+        glEnableVertexAttribArray(6);
+        glVertexAttribPointer(6, 4, type, GL_TRUE, static_cast<GLsizei>(stride), (void*)(MAX_BONE_INFLUENCE * componentSize));
+    }
+
+    // texture to bind and the unit and sampler it goes to, resolved once in setupBindings
+    struct TextureBinding {
+        int unit;
+        unsigned int id;
+        string sampler;
+    };
+    vector<TextureBinding> bindings;
+    // generations of the programs whose samplers already point at the units in bindings
+    vector<uint64_t> samplerPrograms;
+
+    // first unit of each material texture type, -1 for types the shaders don't sample
+    static int firstMaterialUnit(const string& type)
+    {
+        if (type == "texture_diffuse")
+            return 0;
+        if (type == "texture_specular")
+            return MATERIAL_UNITS_PER_TYPE;
+        if (type == "texture_normal")
+            return 2 * MATERIAL_UNITS_PER_TYPE;
+        if (type == "texture_height")
+            return 3 * MATERIAL_UNITS_PER_TYPE;
+        return -1;
+    }
+
+    void setupBindings()
+    {
+        // the N in texture_diffuseN, counted per type
+        int counts[4] = { 0, 0, 0, 0 };
+        for (const auto& texture : textures) {
+            int firstUnit = firstMaterialUnit(texture.type);
+            if (firstUnit < 0)
+                continue;
+            int& number = counts[firstUnit / MATERIAL_UNITS_PER_TYPE];
+            if (number == MATERIAL_UNITS_PER_TYPE)
+                continue;
+            bindings.push_back({ firstUnit + number, texture.id, texture.type + std::to_string(number + 1) });
+            number++;
+        }
+    }
+
+    void bindTextures(Shader &shader)
+    {
+        // the sampler uniforms are program state: set them the first time this shader draws the mesh
+        if (std::find(samplerPrograms.begin(), samplerPrograms.end(), shader.getGeneration()) == samplerPrograms.end()) {
+            for (const auto& binding : bindings)
+                shader.set(shader.getUniform<int>(binding.sampler), binding.unit);
+            samplerPrograms.push_back(shader.getGeneration());
+        }
+
+        for (const auto& binding : bindings) {
+            GLState::Get().ActiveTexture(GL_TEXTURE0 + binding.unit);
+            GLState::Get().BindTexture(GL_TEXTURE_2D, binding.id);
+        }
+    }
+
+    // static meshes go to the arena, skinned ones get buffers of their own for the skin stream
     void setupMesh()
+    {
+        if (skin.empty())
+            geometry = GeometryArena::Get().Allocate(GetVertexFormat(), vertices.data(), static_cast<unsigned int>(vertices.size()),
+                                                     indices.data(), static_cast<unsigned int>(indices.size()));
+        else
+            setupBuffers();
+    }
+
+    // initializes all the buffer objects/arrays
+    void setupBuffers()
     {
         // create buffers/arrays
         glGenVertexArrays(1, &VAO);
         glGenBuffers(1, &VBO);
         glGenBuffers(1, &EBO);
 
-        glBindVertexArray(VAO);
+        GLState::Get().BindVertexArray(VAO);
         // load data into vertex buffers
-        glBindBuffer(GL_ARRAY_BUFFER, VBO);
+        GLState::Get().BindBuffer(GL_ARRAY_BUFFER, VBO);
         // A great thing about structs is that their memory layout is sequential for all its items.
         // The effect is that we can simply pass a pointer to the struct and it translates perfectly to a glm::vec3/2 array which
         // again translates to 3/2 floats which translates to a byte array.
         glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex), &vertices[0], GL_STATIC_DRAW);  
 
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+        GLState::Get().BindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
         glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), &indices[0], GL_STATIC_DRAW);
 
         // set the vertex attribute pointers
@@ -133,14 +307,10 @@ private:
         // vertex bitangent
         glEnableVertexAttribArray(4);
         glVertexAttribPointer(4, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, Bitangent));
-		// ids
-		glEnableVertexAttribArray(5);
-		glVertexAttribIPointer(5, 4, GL_INT, sizeof(Vertex), (void*)offsetof(Vertex, m_BoneIDs));
-
-		// weights
-		glEnableVertexAttribArray(6);
-		glVertexAttribPointer(6, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, m_Weights));
-        glBindVertexArray(0);
+        // bone ids and weights live in their own buffer, only for skinned meshes
+        if (!skin.empty())
+            setupSkin();
+        GLState::Get().BindVertexArray(0);
     }
 };
 #endif
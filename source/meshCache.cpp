@@ -0,0 +1,324 @@
+#include "meshCache.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+    const uint32_t MESH_CACHE_MAGIC = 0x434D4743; // "CGMC"
+    // blobs start at multiples of this, so the mapped data can be read in place
+    const size_t MESH_CACHE_ALIGNMENT = 16;
+
+    struct MeshCacheHeader {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t vertexSize;
+        uint32_t skinSize;
+        uint32_t importFlags;
+        uint32_t meshCount;
+        uint64_t sourceHash;
+        int32_t boneCount;
+        uint32_t boneInfoCount;
+    };
+
+    // sequential writer that pads blobs to MESH_CACHE_ALIGNMENT
+    class CacheWriter {
+    public:
+        explicit CacheWriter(std::ofstream& file) : file(file), offset(0) {}
+
+        void bytes(const void* data, size_t size)
+        {
+            file.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+            offset += size;
+        }
+
+        template <typename T>
+        void value(const T& data) { bytes(&data, sizeof(T)); }
+
+        void string(const std::string& text)
+        {
+            value(static_cast<uint32_t>(text.size()));
+            bytes(text.data(), text.size());
+        }
+
+        void align()
+        {
+            static const char padding[MESH_CACHE_ALIGNMENT] = {};
+            size_t misalignment = offset % MESH_CACHE_ALIGNMENT;
+            if (misalignment)
+                bytes(padding, MESH_CACHE_ALIGNMENT - misalignment);
+        }
+
+    private:
+        std::ofstream& file;
+        size_t offset;
+    };
+
+    // bounds-checked reader over the mapped file
+    class CacheReader {
+    public:
+        CacheReader(const unsigned char* data, size_t size) : data(data), size(size), offset(0), failed(false) {}
+
+        const unsigned char* bytes(size_t count)
+        {
+            if (failed || count > size - offset) {
+                failed = true;
+                return nullptr;
+            }
+            const unsigned char* start = data + offset;
+            offset += count;
+            return start;
+        }
+
+        template <typename T>
+        T value()
+        {
+            T result{};
+            if (const unsigned char* source = bytes(sizeof(T)))
+                std::memcpy(&result, source, sizeof(T));
+            return result;
+        }
+
+        std::string string()
+        {
+            uint32_t length = value<uint32_t>();
+            const unsigned char* source = bytes(length);
+            return source ? std::string(reinterpret_cast<const char*>(source), length) : std::string();
+        }
+
+        template <typename T>
+        std::span<const T> blob(uint32_t count)
+        {
+            align();
+            const unsigned char* source = bytes(static_cast<size_t>(count) * sizeof(T));
+            if (!source)
+                return {};
+            return std::span<const T>(reinterpret_cast<const T*>(source), count);
+        }
+
+        void align()
+        {
+            size_t misalignment = offset % MESH_CACHE_ALIGNMENT;
+            if (misalignment)
+                bytes(MESH_CACHE_ALIGNMENT - misalignment);
+        }
+
+        inline bool ok() const { return !failed; }
+
+    private:
+        const unsigned char* data;
+        size_t size;
+        size_t offset;
+        bool failed;
+    };
+
+    std::string cachePath(const std::string& sourcePath)
+    {
+        return sourcePath + MESH_CACHE_EXTENSION;
+    }
+}
+
+    // ------------------------------------------------------------------------
+    MappedFile::~MappedFile()
+    {
+        Close();
+    }
+
+    bool MappedFile::Open(const std::string& path)
+    {
+        Close();
+#ifdef _WIN32
+        HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+        if (file == INVALID_HANDLE_VALUE)
+            return false;
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+            CloseHandle(file);
+            return false;
+        }
+        HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+        void* data = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+        if (!data) {
+            if (mapping)
+                CloseHandle(mapping);
+            CloseHandle(file);
+            return false;
+        }
+        m_File = file;
+        m_Mapping = mapping;
+        m_Data = static_cast<const unsigned char*>(data);
+        m_Size = static_cast<size_t>(size.QuadPart);
+#else
+        int file = open(path.c_str(), O_RDONLY);
+        if (file < 0)
+            return false;
+        struct stat info;
+        if (fstat(file, &info) != 0 || info.st_size == 0) {
+            close(file);
+            return false;
+        }
+        void* data = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+        // the mapping stays valid after closing the descriptor
+        close(file);
+        if (data == MAP_FAILED)
+            return false;
+        m_Data = static_cast<const unsigned char*>(data);
+        m_Size = static_cast<size_t>(info.st_size);
+#endif
+        return true;
+    }
+
+    void MappedFile::Close()
+    {
+        if (!m_Data)
+            return;
+#ifdef _WIN32
+        UnmapViewOfFile(m_Data);
+        CloseHandle(m_Mapping);
+        CloseHandle(m_File);
+        m_File = nullptr;
+        m_Mapping = nullptr;
+#else
+        munmap(const_cast<unsigned char*>(m_Data), m_Size);
+#endif
+        m_Data = nullptr;
+        m_Size = 0;
+    }
+
+    // ------------------------------------------------------------------------
+    uint64_t MeshCache::HashFile(const std::string& path)
+    {
+        MappedFile file;
+        if (!file.Open(path))
+            return 0;
+        // 64 bit FNV-1a
+        uint64_t hash = 14695981039346656037ull;
+        for (size_t i = 0; i < file.GetSize(); i++) {
+            hash ^= file.GetData()[i];
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+
+    bool MeshCache::Open(const std::string& sourcePath, unsigned int importFlags)
+    {
+        m_Meshes.clear();
+        m_BoneInfoMap.clear();
+        m_BoneCount = 0;
+        if (!m_File.Open(cachePath(sourcePath)))
+            return false;
+
+        CacheReader reader(m_File.GetData(), m_File.GetSize());
+        MeshCacheHeader header = reader.value<MeshCacheHeader>();
+        if (!reader.ok() || header.magic != MESH_CACHE_MAGIC || header.version != MESH_CACHE_VERSION
+            || header.vertexSize != sizeof(Vertex) || header.skinSize != sizeof(VertexSkin)
+            || header.importFlags != importFlags || header.sourceHash != HashFile(sourcePath)) {
+            m_File.Close();
+            return false;
+        }
+
+        m_BoneCount = header.boneCount;
+        for (uint32_t i = 0; i < header.boneInfoCount && reader.ok(); i++) {
+            std::string name = reader.string();
+            BoneInfo info;
+            info.id = reader.value<int32_t>();
+            info.offset = reader.value<glm::mat4>();
+            m_BoneInfoMap[name] = info;
+        }
+
+        m_Meshes.resize(header.meshCount);
+        for (auto& mesh : m_Meshes) {
+            uint32_t textureCount = reader.value<uint32_t>();
+            for (uint32_t i = 0; i < textureCount && reader.ok(); i++) {
+                Texture texture;
+                texture.id = 0;
+                texture.type = reader.string();
+                texture.path = reader.string();
+                mesh.textures.push_back(texture);
+            }
+            uint32_t vertexCount = reader.value<uint32_t>();
+            uint32_t indexCount = reader.value<uint32_t>();
+            uint32_t skinCount = reader.value<uint32_t>();
+            mesh.vertices = reader.blob<Vertex>(vertexCount);
+            mesh.indices = reader.blob<unsigned int>(indexCount);
+            mesh.skin = reader.blob<VertexSkin>(skinCount);
+            if (!reader.ok())
+                break;
+        }
+
+        if (!reader.ok()) {
+            std::cout << "ERROR::MESH_CACHE::DAMAGED " << cachePath(sourcePath) << std::endl;
+            m_Meshes.clear();
+            m_BoneInfoMap.clear();
+            m_File.Close();
+            return false;
+        }
+        return true;
+    }
+
+    bool MeshCache::Write(const std::string& sourcePath, unsigned int importFlags, const std::vector<Mesh>& meshes,
+                          const std::map<std::string, BoneInfo>& boneInfoMap, int boneCount)
+    {
+        // write to a temporary file first, so a crash never leaves a half written cache behind
+        std::string path = cachePath(sourcePath);
+        std::string temporaryPath = path + ".tmp";
+        {
+            std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+            if (!file)
+                return false;
+            CacheWriter writer(file);
+
+            MeshCacheHeader header;
+            header.magic = MESH_CACHE_MAGIC;
+            header.version = MESH_CACHE_VERSION;
+            header.vertexSize = sizeof(Vertex);
+            header.skinSize = sizeof(VertexSkin);
+            header.importFlags = importFlags;
+            header.meshCount = static_cast<uint32_t>(meshes.size());
+            header.sourceHash = HashFile(sourcePath);
+            header.boneCount = boneCount;
+            header.boneInfoCount = static_cast<uint32_t>(boneInfoMap.size());
+            writer.value(header);
+
+            for (const auto& [name, info] : boneInfoMap) {
+                writer.string(name);
+                writer.value(static_cast<int32_t>(info.id));
+                writer.value(info.offset);
+            }
+
+            for (const auto& mesh : meshes) {
+                writer.value(static_cast<uint32_t>(mesh.textures.size()));
+                for (const auto& texture : mesh.textures) {
+                    writer.string(texture.type);
+                    writer.string(texture.path);
+                }
+                writer.value(static_cast<uint32_t>(mesh.vertices.size()));
+                writer.value(static_cast<uint32_t>(mesh.indices.size()));
+                writer.value(static_cast<uint32_t>(mesh.skin.size()));
+                writer.align();
+                writer.bytes(mesh.vertices.data(), mesh.vertices.size() * sizeof(Vertex));
+                writer.align();
+                writer.bytes(mesh.indices.data(), mesh.indices.size() * sizeof(unsigned int));
+                writer.align();
+                writer.bytes(mesh.skin.data(), mesh.skin.size() * sizeof(VertexSkin));
+            }
+            if (!file)
+                return false;
+        }
+
+        std::remove(path.c_str());
+        return std::rename(temporaryPath.c_str(), path.c_str()) == 0;
+    }
@@ -0,0 +1,76 @@
+#pragma once
+
+#ifndef MESH_CACHE_H
+#define MESH_CACHE_H
+
+#include <cstdint>
+#include <map>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "mesh.hpp"
+#include "animdata.hpp"
+
+// bump whenever the layout of the file, Vertex or VertexSkin changes
+#define MESH_CACHE_VERSION 1
+#define MESH_CACHE_EXTENSION ".cgcache"
+
+/* Read-only view of a file mapped into memory */
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool Open(const std::string& path);
+    void Close();
+
+    inline const unsigned char* GetData() const { return m_Data; }
+    inline size_t GetSize() const { return m_Size; }
+
+private:
+    const unsigned char* m_Data = nullptr;
+    size_t m_Size = 0;
+#ifdef _WIN32
+    void* m_File = nullptr;
+    void* m_Mapping = nullptr;
+#endif
+};
+
+/* Binary copy of what Model builds from an Assimp import, stored next to the
+   source file as <path>.cgcache: the bone info map, and per mesh the vertex,
+   index and skin blobs plus its texture references. The file is memory mapped
+   and the blobs are aligned so they can be handed to Mesh as they are. It is
+   tied to a FNV-1a hash of the source file, so editing the source invalidates it. */
+class MeshCache {
+public:
+    struct CachedMesh {
+        std::span<const Vertex> vertices;
+        std::span<const unsigned int> indices;
+        std::span<const VertexSkin> skin;
+        // texture type and path relative to the model directory, as stored in the material
+        std::vector<Texture> textures;
+    };
+
+    // maps the cache of sourcePath; false if there is none, or it is stale, damaged or from other import flags
+    bool Open(const std::string& sourcePath, unsigned int importFlags);
+
+    inline const std::vector<CachedMesh>& GetMeshes() const { return m_Meshes; }
+    inline const std::map<std::string, BoneInfo>& GetBoneInfoMap() const { return m_BoneInfoMap; }
+    inline int GetBoneCount() const { return m_BoneCount; }
+
+    static bool Write(const std::string& sourcePath, unsigned int importFlags, const std::vector<Mesh>& meshes,
+                      const std::map<std::string, BoneInfo>& boneInfoMap, int boneCount);
+
+    static uint64_t HashFile(const std::string& path);
+
+private:
+    MappedFile m_File;
+    std::vector<CachedMesh> m_Meshes;
+    std::map<std::string, BoneInfo> m_BoneInfoMap;
+    int m_BoneCount = 0;
+};
+#endif
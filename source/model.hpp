@@ -21,9 +21,14 @@
 #include <vector>
 #include "assimp_glm_helpers.hpp"
 #include "animdata.hpp"
+#include "meshCache.hpp"
+#include "textureCache.hpp"
+#include <unordered_map>
 
 using namespace std;
 
+#define MODEL_IMPORT_FLAGS (aiProcess_Triangulate | aiProcess_GenSmoothNormals | aiProcess_CalcTangentSpace)
+
 class Model 
 {
 public:
@@ -41,12 +46,38 @@ public:
         loadModel(path);
     }
 
+    // constructor from a scene that was already imported (with MODEL_IMPORT_FLAGS) from path
+    Model(const aiScene* scene, string const &path, bool gamma = false) : gammaCorrection(gamma)
+    {
+        processScene(scene, path);
+    }
+
+    // gives the model's textures back to the TextureCache and its static meshes' ranges to the GeometryArena
+    ~Model()
+    {
+        for (const auto& texture : textures_loaded)
+            TextureCache::Get().Release(texture.id);
+        for (auto& mesh : meshes)
+            mesh.ReleaseGeometry();
+    }
+
+    // every model holds one reference per texture, so it can't be copied
+    Model(const Model&) = delete;
+    Model& operator=(const Model&) = delete;
+
     // draws the model, and thus all its meshes
     void Draw(Shader &shader)
     {
         for(unsigned int i = 0; i < meshes.size(); i++)
             meshes[i].Draw(shader);
     }
+
+    // draws instanceCount copies of every mesh, see Mesh::DrawInstanced
+    void DrawInstanced(Shader &shader, unsigned int instanceCount)
+    {
+        for(unsigned int i = 0; i < meshes.size(); i++)
+            meshes[i].DrawInstanced(shader, instanceCount);
+    }
     
 	auto& GetBoneInfoMap() { return m_BoneInfoMap; }
 	int& GetBoneCount() { return m_BoneCounter; }
@@ -56,24 +87,59 @@ private:
 
 	std::map<string, BoneInfo> m_BoneInfoMap;
 	int m_BoneCounter = 0;
+    // index of each path in textures_loaded
+    unordered_map<string, size_t> textureIndices;
 
     // loads a model with supported ASSIMP extensions from file and stores the resulting meshes in the meshes vector.
+    // A binary cache is written next to the file after the first import and used instead of ASSIMP later on.
     void loadModel(string const &path)
     {
+        if (loadCache(path))
+            return;
+
         // read file via ASSIMP
         Assimp::Importer importer;
-        const aiScene* scene = importer.ReadFile(path, aiProcess_Triangulate | aiProcess_GenSmoothNormals | aiProcess_CalcTangentSpace);
+        const aiScene* scene = importer.ReadFile(path, MODEL_IMPORT_FLAGS);
         // check for errors
         if(!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode) // if is Not Zero
         {
             cout << "ERROR::ASSIMP:: " << importer.GetErrorString() << endl;
             return;
         }
+        processScene(scene, path);
+        if (!MeshCache::Write(path, MODEL_IMPORT_FLAGS, meshes, m_BoneInfoMap, m_BoneCounter))
+            cout << "ERROR::MESH_CACHE::WRITE_FAILED " << path << endl;
+    }
+
+    bool loadCache(string const &path)
+    {
+        MeshCache cache;
+        if (!cache.Open(path, MODEL_IMPORT_FLAGS))
+            return false;
+
+        directory = path.substr(0, path.find_last_of('/'));
+        m_BoneInfoMap = cache.GetBoneInfoMap();
+        m_BoneCounter = cache.GetBoneCount();
+        meshes.reserve(cache.GetMeshes().size());
+        for (const auto& cached : cache.GetMeshes())
+        {
+            vector<Texture> textures;
+            for (const auto& reference : cached.textures)
+                textures.push_back(loadTexture(reference.path.c_str(), reference.type));
+            meshes.push_back(Mesh(cached.vertices, cached.indices, textures, cached.skin));
+        }
+        uploadTextures();
+        return true;
+    }
+
+    void processScene(const aiScene* scene, string const &path)
+    {
         // retrieve the directory path of the filepath
         directory = path.substr(0, path.find_last_of('/'));
 
         // process ASSIMP's root node recursively
         processNode(scene->mRootNode, scene);
+        uploadTextures();
     }
 
     // processes a node in a recursive fashion. Processes each individual mesh located at the node and repeats this process on its children nodes (if any).
@@ -95,12 +161,12 @@ private:
 
     }
 
-	void SetVertexBoneDataToDefault(Vertex& vertex)
+	void SetVertexBoneDataToDefault(VertexSkin& skin)
 	{
 		for (int i = 0; i < MAX_BONE_INFLUENCE; i++)
 		{
-			vertex.m_BoneIDs[i] = -1;
-			vertex.m_Weights[i] = 0.0f;
+			skin.boneIDs[i] = 0;
+			skin.weights[i] = 0.0f;
 		}
 	}
 
@@ -114,7 +180,6 @@ private:
 		for (unsigned int i = 0; i < mesh->mNumVertices; i++)
 		{
 			Vertex vertex;
-			SetVertexBoneDataToDefault(vertex);
 			vertex.Position = AssimpGLMHelpers::GetGLMVec(mesh->mVertices[i]);
 			vertex.Normal = AssimpGLMHelpers::GetGLMVec(mesh->mNormals[i]);
 			
@@ -147,26 +212,53 @@ private:
 		std::vector<Texture> heightMaps = loadMaterialTextures(material, aiTextureType_AMBIENT, "texture_height");
 		textures.insert(textures.end(), heightMaps.begin(), heightMaps.end());
 
-		ExtractBoneWeightForVertices(vertices,mesh,scene);
+		// static meshes get no skin stream at all
+		vector<VertexSkin> skin;
+		if (mesh->HasBones())
+		{
+			skin.resize(vertices.size());
+			for (auto& influences : skin)
+				SetVertexBoneDataToDefault(influences);
+			ExtractBoneWeightForVertices(skin,mesh,scene);
+			for (auto& influences : skin)
+				NormalizeVertexBoneData(influences);
+		}
 
-		return Mesh(vertices, indices, textures);
+		return Mesh(vertices, indices, textures, skin);
 	}
 
-	void SetVertexBoneData(Vertex& vertex, int boneID, float weight)
+	// keeps the MAX_BONE_INFLUENCE strongest influences, sorted by weight
+	void SetVertexBoneData(VertexSkin& skin, int boneID, float weight)
 	{
-		for (int i = 0; i < MAX_BONE_INFLUENCE; ++i)
+		int slot = MAX_BONE_INFLUENCE;
+		while (slot > 0 && skin.weights[slot - 1] < weight)
+			slot--;
+		if (slot == MAX_BONE_INFLUENCE)
+			return;
+
+		for (int i = MAX_BONE_INFLUENCE - 1; i > slot; --i)
 		{
-			if (vertex.m_BoneIDs[i] < 0)
-			{
-				vertex.m_Weights[i] = weight;
-				vertex.m_BoneIDs[i] = boneID;
-				break;
-			}
+			skin.weights[i] = skin.weights[i - 1];
+			skin.boneIDs[i] = skin.boneIDs[i - 1];
 		}
+		skin.weights[slot] = weight;
+		skin.boneIDs[slot] = static_cast<unsigned short>(boneID);
+	}
+
+	// the dropped influences leave the weights short of 1, scale the kept ones back up
+	void NormalizeVertexBoneData(VertexSkin& skin)
+	{
+		float total = 0.0f;
+		for (int i = 0; i < MAX_BONE_INFLUENCE; ++i)
+			total += skin.weights[i];
+		if (total <= 0.0f)
+			return;
+		for (int i = 0; i < MAX_BONE_INFLUENCE; ++i)
+			skin.weights[i] /= total;
 	}
 
 
-	void ExtractBoneWeightForVertices(std::vector<Vertex>& vertices, aiMesh* mesh, const aiScene* scene)
+	void ExtractBoneWeightForVertices(std::vector<VertexSkin>& skin, aiMesh* mesh, const aiScene* scene)
 	{
 		auto& boneInfoMap = m_BoneInfoMap;
 		int& boneCount = m_BoneCounter;
@@ -196,51 +288,29 @@ private:
 			{
 				int vertexId = weights[weightIndex].mVertexId;
 				float weight = weights[weightIndex].mWeight;
-				assert(vertexId <= vertices.size());
-				SetVertexBoneData(vertices[vertexId], boneID, weight);
+				assert(vertexId < skin.size());
+				SetVertexBoneData(skin[vertexId], boneID, weight);
 			}
 		}
 	}
 
 
+	// the texture comes from the shared TextureCache, which decodes it on a worker thread;
+	// the pixels are uploaded by uploadTextures once the meshes are built
 	unsigned int TextureFromFile(const char* path, const string& directory, bool gamma = false)
 	{
 		string filename = string(path);
 		filename = directory + '/' + filename;
 
-		unsigned int textureID;
-		glGenTextures(1, &textureID);
-
-		int width, height, nrComponents;
-		unsigned char* data = stbi_load(filename.c_str(), &width, &height, &nrComponents, 0);
-		if (data)
-		{
-			GLenum format;
-			if (nrComponents == 1)
-				format = GL_RED;
-			else if (nrComponents == 3)
-				format = GL_RGB;
-			else if (nrComponents == 4)
-				format = GL_RGBA;
-
-			glBindTexture(GL_TEXTURE_2D, textureID);
-			glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
-			glGenerateMipmap(GL_TEXTURE_2D);
-
-			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-			stbi_image_free(data);
-		}
-		else
-		{
-			std::cout << "Texture failed to load at path: " << path << std::endl;
-			stbi_image_free(data);
-		}
+		TextureSettings settings;
+		settings.gammaCorrection = gamma;
+		return TextureCache::Get().Request(filename, settings);
+	}
 
-		return textureID;
+	// uploads the decoded images, on the thread that owns the GL context
+	void uploadTextures()
+	{
+		TextureCache::Get().Flush();
 	}
     
     // checks all material textures of a given type and loads the textures if they're not loaded yet.
@@ -252,29 +322,27 @@ private:
         {
             aiString str;
             mat->GetTexture(type, i, &str);
-            // check if texture was loaded before and if so, continue to next iteration: skip loading a new texture
-            bool skip = false;
-            for(unsigned int j = 0; j < textures_loaded.size(); j++)
-            {
-                if(std::strcmp(textures_loaded[j].path.data(), str.C_Str()) == 0)
-                {
-                    textures.push_back(textures_loaded[j]);
-                    skip = true; // a texture with the same filepath has already been loaded, continue to next one. (optimization)
-                    break;
-                }
-            }
-            if(!skip)
-            {   // if texture hasn't been loaded already, load it
-                Texture texture;
-                texture.id = TextureFromFile(str.C_Str(), this->directory);
-                texture.type = typeName;
-                texture.path = str.C_Str();
-                textures.push_back(texture);
-                textures_loaded.push_back(texture);  // store it as texture loaded for entire model, to ensure we won't unnecesery load duplicate textures.
-            }
+            textures.push_back(loadTexture(str.C_Str(), typeName));
         }
         return textures;
     }
+
+    // loads the texture at path (relative to the model directory) unless the model already loaded it
+    Texture loadTexture(const char *path, const string &typeName)
+    {
+        // check if texture was loaded before and if so, skip loading a new texture
+        auto loaded = textureIndices.find(path);
+        if(loaded != textureIndices.end())
+            return textures_loaded[loaded->second]; // a texture with the same filepath has already been loaded. (optimization)
+        // if texture hasn't been loaded already, load it (the cache shares it with other models)
+        Texture texture;
+        texture.id = TextureFromFile(path, this->directory);
+        texture.type = typeName;
+        texture.path = path;
+        textureIndices[texture.path] = textures_loaded.size();
+        textures_loaded.push_back(texture);  // store it as texture loaded for entire model, to ensure we won't unnecesery load duplicate textures.
+        return texture;
+    }
 };
 
 
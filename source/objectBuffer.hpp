@@ -0,0 +1,132 @@
+#ifndef OBJECT_BUFFER_H
+#define OBJECT_BUFFER_H
+
+#include <glad/glad.h>
+
+#include <glm/glm.hpp>
+
+#include "glState.hpp"
+#include "shaders/shader.hpp"
+#include "textureUnits.hpp"
+#include "uniformBlocks.hpp"
+
+#include <algorithm>
+#include <span>
+#include <vector>
+
+/* What a shader needs to know about one object, in the std430 layout of
+   struct ObjectData { mat4 model; vec4 normalMatrix[3]; vec4 material; }.
+   The normal matrix is computed here once instead of per vertex. */
+struct ObjectData {
+    glm::mat4 model;
+    // columns of transpose(inverse(mat3(model))), padded to vec4
+    glm::vec4 normalMatrix[3];
+    /* index into the Materials block, as a float so the RGBA32F texels of the
+       texture buffer path hold it exactly; its bits would be a denormal there */
+    float material;
+    float padding[3];
+
+    ObjectData() : model(1.0f), normalMatrix{}, material(0.0f), padding{} {}
+    ObjectData(const glm::mat4& model, unsigned int material) : model(model), material(static_cast<float>(material)), padding{}
+    {
+        glm::mat3 normal = glm::transpose(glm::inverse(glm::mat3(model)));
+        for (int i = 0; i < 3; i++)
+            normalMatrix[i] = glm::vec4(normal[i], 0.0f);
+    }
+};
+
+static_assert(sizeof(ObjectData) == 128);
+
+/* Per-object data of the draws in a DrawBatch, uploaded in one call and found
+   by the shader through the objectIndex attribute, plus the material table the
+   objects index into. On GL 4.3 the objects live in a shader storage buffer
+   ("buffer Objects"); before that in a texture buffer read with texelFetch
+   ("uniform samplerBuffer objectData", eight RGBA32F texels per object).
+   Shaders have to be built with Variant() to read the matching one. */
+class ObjectBuffer {
+public:
+    ObjectBuffer() : buffer(0), texture(0), capacity(0), materials(MATERIALS_BLOCK_BINDING) {}
+
+    ~ObjectBuffer()
+    {
+        if (texture)
+            GLState::Get().DeleteTextures(1, &texture);
+        if (buffer)
+            GLState::Get().DeleteBuffers(1, &buffer);
+    }
+
+    ObjectBuffer(const ObjectBuffer&) = delete;
+    ObjectBuffer& operator=(const ObjectBuffer&) = delete;
+
+    static bool UsesStorageBuffer() { return GLAD_GL_VERSION_4_3; }
+
+    /* OBJECT_BUFFER, and OBJECT_STORAGE_BUFFER when the objects live in a storage
+       buffer, which GLSL only has from 430 on; the texture buffer path stays on 330 */
+    static ShaderVariant Variant()
+    {
+        ShaderVariant variant;
+        variant.Define("OBJECT_BUFFER");
+        if (UsesStorageBuffer())
+            variant.Version("430 core").Define("OBJECT_STORAGE_BUFFER");
+        return variant;
+    }
+
+    // every object, in objectIndex order
+    void Upload(std::span<const ObjectData> objects)
+    {
+        if (!buffer)
+            setupBuffer();
+
+        // the copy target works for both kinds of buffer
+        GLState::Get().BindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+        GLsizeiptr size = static_cast<GLsizeiptr>(objects.size_bytes());
+        if (objects.size() > capacity) {
+            capacity = objects.size();
+            glBufferData(GL_COPY_WRITE_BUFFER, size, objects.data(), GL_DYNAMIC_DRAW);
+        }
+        else {
+            glBufferSubData(GL_COPY_WRITE_BUFFER, 0, size, objects.data());
+        }
+        GLState::Get().BindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    }
+
+    // the whole block is uploaded, up to MATERIALS_BLOCK_COUNT materials
+    void UploadMaterials(std::span<const MaterialBlock> table)
+    {
+        std::vector<MaterialBlock> block(MATERIALS_BLOCK_COUNT, MaterialBlock{});
+        std::copy_n(table.begin(), std::min<size_t>(table.size(), MATERIALS_BLOCK_COUNT), block.begin());
+        materials.Upload(block.data(), block.size() * sizeof(MaterialBlock));
+    }
+
+    // binds the objects for the shader; the materials are on their uniform block binding already
+    void Bind(Shader& shader) const
+    {
+        if (UsesStorageBuffer()) {
+            GLState::Get().BindBufferBase(GL_SHADER_STORAGE_BUFFER, OBJECTS_STORAGE_BINDING, buffer);
+            return;
+        }
+        GLState::Get().ActiveTexture(GL_TEXTURE0 + OBJECT_BUFFER_UNIT);
+        GLState::Get().BindTexture(GL_TEXTURE_BUFFER, texture);
+        GLState::Get().ActiveTexture(GL_TEXTURE0);
+        shader.setInt("objectData", OBJECT_BUFFER_UNIT);
+    }
+
+private:
+    unsigned int buffer, texture;
+    size_t capacity;
+    UniformBuffer materials;
+
+    void setupBuffer()
+    {
+        glGenBuffers(1, &buffer);
+        if (UsesStorageBuffer())
+            return;
+        glGenTextures(1, &texture);
+        GLState::Get().BindBuffer(GL_TEXTURE_BUFFER, buffer);
+        GLState::Get().BindTexture(GL_TEXTURE_BUFFER, texture);
+        glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, buffer);
+        GLState::Get().BindTexture(GL_TEXTURE_BUFFER, 0);
+        GLState::Get().BindBuffer(GL_TEXTURE_BUFFER, 0);
+    }
+};
+#endif
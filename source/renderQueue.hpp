@@ -0,0 +1,178 @@
+#ifndef RENDER_QUEUE_H
+#define RENDER_QUEUE_H
+
+#include <glad/glad.h>
+
+#include "glState.hpp"
+#include "shaders/shader.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+// one indexed draw and the state it needs
+struct DrawItem {
+    uint64_t key = 0;
+    const Shader* shader = nullptr;
+    unsigned int vao = 0;
+    // bound on texture unit 0; 0 when the draw doesn't sample one
+    unsigned int texture = 0;
+    unsigned int indexCount = 0;
+    unsigned int firstIndex = 0;
+    int baseVertex = 0;
+    // caller's index of the object, handed back when the draw is submitted
+    unsigned int object = 0;
+};
+
+// draws submitted since the last reset and the state binds the sort saved
+struct RenderQueueStats {
+    uint64_t draws = 0;
+    uint64_t programChanges = 0;
+    uint64_t textureChanges = 0;
+    uint64_t vaoChanges = 0;
+    uint64_t skipped = 0;
+};
+
+/* Draws collected over a frame, radix sorted by a 64 bit key and submitted
+   so that consecutive draws only bind the state that differs. From the most
+   significant bits the key holds the pass, program, material (texture),
+   VAO and the quantized depth, so opaque draws sharing state also go front
+   to back for early-Z rejection. Names wider than their field only make the
+   grouping coarser; the binds compare the full names. */
+class RenderQueue {
+public:
+    static constexpr int PASS_BITS = 4;
+    static constexpr int PROGRAM_BITS = 12;
+    static constexpr int MATERIAL_BITS = 16;
+    static constexpr int VAO_BITS = 12;
+    static constexpr int DEPTH_BITS = 20;
+    static_assert(PASS_BITS + PROGRAM_BITS + MATERIAL_BITS + VAO_BITS + DEPTH_BITS == 64);
+
+    /* depth in [0, 1], 0 being nearest, e.g. the view distance over the far
+       plane; give 1 - depth for back to front passes such as transparency */
+    static uint64_t MakeKey(unsigned int pass, unsigned int program, unsigned int material, unsigned int vao, float depth)
+    {
+        uint64_t quantized = static_cast<uint64_t>(std::clamp(depth, 0.0f, 1.0f) * mask(DEPTH_BITS));
+        uint64_t key = pass & mask(PASS_BITS);
+        key = (key << PROGRAM_BITS) | (program & mask(PROGRAM_BITS));
+        key = (key << MATERIAL_BITS) | (material & mask(MATERIAL_BITS));
+        key = (key << VAO_BITS) | (vao & mask(VAO_BITS));
+        return (key << DEPTH_BITS) | quantized;
+    }
+
+    // key from the item's own program, texture and VAO
+    static uint64_t MakeKey(unsigned int pass, const DrawItem& item, float depth)
+    {
+        return MakeKey(pass, item.shader ? item.shader->ID : 0, item.texture, item.vao, depth);
+    }
+
+    void Push(const DrawItem& item)
+    {
+        items.push_back(item);
+        sorted = false;
+    }
+
+    void Clear()
+    {
+        items.clear();
+        entries.clear();
+        sorted = false;
+    }
+
+    inline size_t GetCount() const { return items.size(); }
+
+    /* LSD radix sort on the keys, a byte per pass; bytes every key shares are
+       skipped. Stable, so equal keys keep the order they were pushed in. */
+    void Sort()
+    {
+        size_t count = items.size();
+        entries.resize(count);
+        scratch.resize(count);
+        for (size_t i = 0; i < count; i++)
+            entries[i] = { items[i].key, static_cast<unsigned int>(i) };
+
+        for (int shift = 0; shift < 64 && count > 1; shift += 8) {
+            size_t offsets[256] = {};
+            for (const auto& entry : entries)
+                offsets[(entry.key >> shift) & 0xFF]++;
+            if (offsets[(entries[0].key >> shift) & 0xFF] == count)
+                continue;
+            size_t offset = 0;
+            for (size_t& bucket : offsets) {
+                size_t size = bucket;
+                bucket = offset;
+                offset += size;
+            }
+            for (const auto& entry : entries)
+                scratch[offsets[(entry.key >> shift) & 0xFF]++] = entry;
+            entries.swap(scratch);
+        }
+        sorted = true;
+    }
+
+    /* Draws every item in key order. setup(shader, item) runs right before each
+       draw, with the item's program in use, to set its per-draw uniforms. */
+    template <typename Setup>
+    void Submit(Setup&& setup, GLenum mode = GL_TRIANGLES)
+    {
+        if (!sorted)
+            Sort();
+
+        const Shader* program = nullptr;
+        unsigned int vao = 0, texture = 0;
+        bool first = true;
+        GLState::Get().ActiveTexture(GL_TEXTURE0);
+        for (const auto& entry : entries) {
+            const DrawItem& item = items[entry.item];
+            if (first || item.shader != program) {
+                item.shader->use();
+                program = item.shader;
+                stats.programChanges++;
+            }
+            else {
+                stats.skipped++;
+            }
+            if (item.texture && (first || item.texture != texture)) {
+                GLState::Get().BindTexture(GL_TEXTURE_2D, item.texture);
+                texture = item.texture;
+                stats.textureChanges++;
+            }
+            else if (item.texture) {
+                stats.skipped++;
+            }
+            if (first || item.vao != vao) {
+                GLState::Get().BindVertexArray(item.vao);
+                vao = item.vao;
+                stats.vaoChanges++;
+            }
+            else {
+                stats.skipped++;
+            }
+            first = false;
+
+            setup(*item.shader, item);
+            glDrawElementsBaseVertex(mode, item.indexCount, GL_UNSIGNED_INT,
+                                     (void*)(item.firstIndex * sizeof(unsigned int)), item.baseVertex);
+            stats.draws++;
+        }
+    }
+
+    // totals since the last reset, e.g. once per frame
+    inline const RenderQueueStats& GetStats() const { return stats; }
+    void ResetStats() { stats = RenderQueueStats(); }
+
+private:
+    struct SortEntry {
+        uint64_t key;
+        unsigned int item;
+    };
+
+    std::vector<DrawItem> items;
+    // items in key order after Sort(), and the buffer the sort passes swap with
+    std::vector<SortEntry> entries, scratch;
+    bool sorted = false;
+    RenderQueueStats stats;
+
+    static constexpr uint64_t mask(int bits) { return (uint64_t(1) << bits) - 1; }
+};
+#endif
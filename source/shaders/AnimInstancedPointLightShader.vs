@@ -0,0 +1,74 @@
+#version 330 core
+
+layout(location = 0) in vec3 pos;
+layout(location = 1) in vec3 norm;
+layout(location = 2) in vec2 tex;
+layout(location = 3) in vec3 tangent;
+layout(location = 4) in vec3 bitangent;
+layout(location = 5) in uvec4 boneIds;
+layout(location = 6) in vec4 weights;
+// per instance: model matrix, then clip index and time offset
+layout(location = 7) in mat4 instanceModel;
+layout(location = 11) in vec2 instanceClip;
+
+layout (std140) uniform Camera {
+    mat4 projection;
+    mat4 view;
+    vec3 viewPos;
+};
+
+const int MAX_BONE_INFLUENCE = 4;
+const int MAX_BAKED_CLIPS = 16;
+// baked poses: one row per frame, three texels (matrix rows) per bone
+uniform sampler2D bakedPoses;
+// first row, frame count and sample rate of each clip
+uniform vec3 bakedClips[MAX_BAKED_CLIPS];
+uniform float time;
+
+out vec3 FragPos;
+out vec2 FragTexCoords;
+out vec3 Normal;
+
+mat4 bakedMatrix(int row, int boneId)
+{
+    int texel = boneId * 3;
+    return transpose(mat4(texelFetch(bakedPoses, ivec2(texel, row), 0),
+                          texelFetch(bakedPoses, ivec2(texel + 1, row), 0),
+                          texelFetch(bakedPoses, ivec2(texel + 2, row), 0),
+                          vec4(0.0f, 0.0f, 0.0f, 1.0f)));
+}
+
+void main()
+{
+    vec3 clip = bakedClips[int(instanceClip.x)];
+    int frameCount = int(clip.y);
+    float frame = mod((time + instanceClip.y) * clip.z, float(frameCount));
+    int row0 = int(clip.x) + int(frame);
+    int row1 = int(clip.x) + (int(frame) + 1) % frameCount;
+    float blend = fract(frame);
+
+    vec4 totalPosition = vec4(0.0f);
+    vec3 totalNormal = vec3(0.0f);
+    for(int i = 0 ; i < MAX_BONE_INFLUENCE ; i++)
+    {
+        if(weights[i] == 0.0f) 
+            continue;
+        int boneId = int(boneIds[i]);
+        mat4 bone = bakedMatrix(row0, boneId) * (1.0f - blend) + bakedMatrix(row1, boneId) * blend;
+        totalPosition += bone * vec4(pos, 1.0f) * weights[i];
+        totalNormal += mat3(bone) * norm * weights[i];
+    }
+    // meshes without a skin have no weights and stay in the bind pose
+    if(dot(weights, vec4(1.0f)) == 0.0f)
+    {
+        totalPosition = vec4(pos, 1.0f);
+        totalNormal = norm;
+    }
+
+    vec4 worldPosition = instanceModel * totalPosition;
+    gl_Position = projection * view * worldPosition;
+
+    FragPos = worldPosition.xyz;
+    FragTexCoords = tex;
+    Normal = mat3(instanceModel) * totalNormal;
+}
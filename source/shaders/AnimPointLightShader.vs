@@ -5,42 +5,55 @@ layout(location = 1) in vec3 norm;
 layout(location = 2) in vec2 tex;
 layout(location = 3) in vec3 tangent;
 layout(location = 4) in vec3 bitangent;
-layout(location = 5) in ivec4 boneIds; 
+layout(location = 5) in uvec4 boneIds;
 layout(location = 6) in vec4 weights;
 
-uniform mat4 projection;
-uniform mat4 view;
+layout (std140) uniform Camera {
+    mat4 projection;
+    mat4 view;
+    vec3 viewPos;
+};
 uniform mat4 model;
+uniform mat3 normalMatrix;
 
-const int MAX_BONES = 100;
 const int MAX_BONE_INFLUENCE = 4;
-uniform mat4 finalBonesMatrices[MAX_BONES];
+// bone palette, four texels per matrix, starting at matrix boneOffset
+uniform samplerBuffer bonePalette;
+uniform int boneOffset;
 
 out vec3 FragPos;
 out vec2 FragTexCoords;
 out vec3 Normal;
 
+mat4 boneMatrix(int boneId)
+{
+    int texel = (boneOffset + boneId) * 4;
+    return mat4(texelFetch(bonePalette, texel),
+                texelFetch(bonePalette, texel + 1),
+                texelFetch(bonePalette, texel + 2),
+                texelFetch(bonePalette, texel + 3));
+}
+
 void main()
 {
     vec4 totalPosition = vec4(0.0f);
     for(int i = 0 ; i < MAX_BONE_INFLUENCE ; i++)
     {
-        if(boneIds[i] == -1) 
+        if(weights[i] == 0.0f) 
             continue;
-        if(boneIds[i] >=MAX_BONES) 
-        {
-            totalPosition = vec4(pos,1.0f);
-            break;
-        }
-        vec4 localPosition = finalBonesMatrices[boneIds[i]] * vec4(pos,1.0f);
+        mat4 bone = boneMatrix(int(boneIds[i]));
+        vec4 localPosition = bone * vec4(pos,1.0f);
         totalPosition += localPosition * weights[i];
-        vec3 localNormal = mat3(finalBonesMatrices[boneIds[i]]) * norm;
+        vec3 localNormal = mat3(bone) * norm;
    }
+    // meshes without a skin have no weights and stay in the bind pose
+    if(dot(weights, vec4(1.0f)) == 0.0f)
+        totalPosition = vec4(pos, 1.0f);
 	
     mat4 viewModel = view * model;
     gl_Position =  projection * viewModel * totalPosition;
 
     FragPos = totalPosition.xyz;
     FragTexCoords = tex;
-    Normal = mat3(transpose(inverse(model))) * norm;
+    Normal = normalMatrix * norm;
 }
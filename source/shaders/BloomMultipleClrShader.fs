@@ -1,156 +0,0 @@
-#version 330 core
-
-layout (location = 0) out vec4 FragColor;
-layout (location = 1) out vec4 BrightColor;
-
-struct Material {
-    vec3 ambient;
-    vec3 diffuse;
-    vec3 specular;    
-    float shininess;
-}; 
-
-struct DirectionalLight {
-    bool on;
-    vec3 direction;
-    vec3 ambient;
-    vec3 diffuse;
-    vec3 specular;
-};
-
-struct PointLight {
-    bool on;
-    vec3 position;
-    vec3 ambient;
-    vec3 diffuse;
-    vec3 specular;
-    // attenuation
-    float constant;
-    float linear;
-    float quadratic;
-};
-
-struct SpotLight {
-    bool on;
-    vec3 position;  
-    vec3 direction;
-    float cutOff;
-    float outerCutOff;
-
-    vec3 ambient;
-    vec3 diffuse;
-    vec3 specular;
-	// attenuation
-    float constant;
-    float linear;
-    float quadratic;
-};
-
-#define NR_DIR_LIGHTS $ND$
-#define NR_POINT_LIGHTS $NP$
-#define NR_SPOT_LIGHTS $NS$
-
-in vec3 FragPos;  
-in vec3 Normal;  
-  
-uniform vec3 viewPos;
-uniform Material material;
-uniform vec3 color;
-
-uniform DirectionalLight dirLights[NR_DIR_LIGHTS];
-uniform PointLight pointLights[NR_POINT_LIGHTS];
-uniform SpotLight spotLights[NR_SPOT_LIGHTS];
-
-// function prototypes
-vec3 CalcDirLight(DirectionalLight light, vec3 normal, vec3 viewDir);
-vec3 CalcPointLight(PointLight light, vec3 normal, vec3 fragPos, vec3 viewDir);
-vec3 CalcSpotLight(SpotLight light, vec3 normal, vec3 fragPos, vec3 viewDir);
-
-void main()
-{
-    vec3 norm = normalize(Normal);
-    vec3 viewDir = normalize(viewPos - FragPos);
-
-    vec3 result = vec3(0.0, 0.0, 0.0);
-
-    for(int i = 0; i < NR_DIR_LIGHTS; i++)
-        result += dirLights[i].on ? CalcDirLight(dirLights[i], norm, viewDir) : vec3(0.0, 0.0, 0.0);
-    for(int i = 0; i < NR_POINT_LIGHTS; i++)
-        result += pointLights[i].on ? CalcPointLight(pointLights[i], norm, FragPos, viewDir) : vec3(0.0, 0.0, 0.0);
-    for(int i = 0; i < NR_SPOT_LIGHTS; i++)
-        result += spotLights[i].on ? CalcSpotLight(spotLights[i], norm, FragPos, viewDir) : vec3(0.0, 0.0, 0.0);
-
-    vec3 resultFinal = result * color;
-
-    // check whether result is higher than some threshold, if so, output as bloom threshold color
-    float brightness = dot(resultFinal, vec3(0.2126, 0.7152, 0.0722));
-    if(brightness > 1.0)
-        BrightColor = vec4(resultFinal, 1.0);
-    else
-        BrightColor = vec4(0.0, 0.0, 0.0, 1.0);
-
-    FragColor = vec4(resultFinal, 1.0f);
-} 
-
-vec3 CalcDirLight(DirectionalLight light, vec3 normal, vec3 viewDir)
-{
-    // ambient
-    vec3 ambient = light.ambient * material.ambient;
-    // diffuse 
-    vec3 lightDir = normalize(-light.direction);
-    float diff = max(dot(normal, lightDir), 0.0);
-    vec3 diffuse = light.diffuse * (diff * material.diffuse);
-    // specular
-    vec3 halfwayDir = normalize(lightDir + viewDir);  
-    float spec = pow(max(dot(normal, halfwayDir), 0.0), material.shininess);
-    vec3 specular = light.specular * (spec * material.specular);
-
-    return ambient + diffuse + specular;
-}
-
-vec3 CalcPointLight(PointLight light, vec3 normal, vec3 fragPos, vec3 viewDir)
-{
-    // ambient
-    vec3 ambient = light.ambient * material.ambient;
-    // diffuse 
-    vec3 lightDir = normalize(light.position - fragPos);
-    float diff = max(dot(normal, lightDir), 0.0);
-    vec3 diffuse = light.diffuse * (diff * material.diffuse);
-    // specular
-    vec3 halfwayDir = normalize(lightDir + viewDir);  
-    float spec = pow(max(dot(normal, halfwayDir), 0.0), material.shininess);
-    vec3 specular = light.specular * (spec * material.specular);
-    // attenuation
-    float distance = length(light.position - fragPos);
-    float attenuation = light.constant + light.linear * distance + 
-    		    light.quadratic * (distance * distance);
-
-    return ambient + ((diffuse + specular)/attenuation);
-}
-
-vec3 CalcSpotLight(SpotLight light, vec3 normal, vec3 fragPos, vec3 viewDir)
-{
-    // ambient
-    vec3 ambient = light.ambient * material.ambient;
-    // diffuse 
-    vec3 lightDir = normalize(light.position - fragPos);
-    float diff = max(dot(normal, lightDir), 0.0);
-    vec3 diffuse = light.diffuse * (diff * material.diffuse);
-    // specular
-    vec3 halfwayDir = normalize(lightDir + viewDir);  
-    float spec = pow(max(dot(normal, halfwayDir), 0.0), material.shininess);
-    vec3 specular = light.specular * (spec * material.specular); 
-    // spotlight (soft edges)
-    float theta = dot(lightDir, normalize(-light.direction)); 
-    float epsilon = (light.cutOff - light.outerCutOff);
-    float intensity = clamp((theta - light.outerCutOff) / epsilon, 0.0, 1.0);
-    diffuse  *= intensity;
-    specular *= intensity;
-
-    // attenuation
-    float distance = length(light.position - fragPos);
-    float attenuation = light.constant + light.linear * distance + 
-    		    light.quadratic * (distance * distance);
-
-    return ambient + ((diffuse + specular)/attenuation);
-}
\ No newline at end of file
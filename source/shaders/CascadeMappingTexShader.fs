@@ -1,7 +1,9 @@
 #version 330 core
 out vec4 FragColor;
 
+#ifndef NUM_CASCADES
 #define NUM_CASCADES 3
+#endif
 
 struct Material {
     vec3 ambient;
@@ -27,13 +29,38 @@ in vec4 LightSpacePos[NUM_CASCADES];
 uniform sampler2D texture_diffuse0;
 uniform sampler2D shadowMap[NUM_CASCADES];
   
-uniform vec3 viewPos;
+layout (std140) uniform Camera {
+    mat4 projection;
+    mat4 view;
+    vec3 viewPos;
+};
+#ifdef OBJECT_BUFFER
+#ifndef MAX_MATERIALS
+#define MAX_MATERIALS 64
+#endif
+// the object's material, from the table in the Materials block
+struct MaterialData {
+    vec3 ambient;
+    float shininess;
+    vec3 diffuse;
+    vec3 specular;
+    vec3 color;
+};
+layout (std140) uniform Materials {
+    MaterialData materials[MAX_MATERIALS];
+};
+flat in uint MaterialIndex;
+#define material materials[MaterialIndex]
+#else
 uniform Material material;
-uniform Light light;
-uniform float cascadeEndClipSpace[NUM_CASCADES];
+#endif
+layout (std140) uniform Cascades {
+    Light light;
+    mat4 FragPosLP[NUM_CASCADES]; //FragPosLightSpace
+    float cascadeEndClipSpace[NUM_CASCADES];
+};
 
 
-uniform mat4 view;
 
 void main()
 {
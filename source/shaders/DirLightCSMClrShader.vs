@@ -3,21 +3,72 @@
 layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec3 aNormal;
 
+#ifndef NUM_CASCADES
 #define NUM_CASCADES 3
+#endif
+
+struct Light {
+    vec3 direction;
+
+    vec3 ambient;
+    vec3 diffuse;
+    vec3 specular;
+};
 
 out vec3 FragPos;
 out vec3 Normal;
 out vec4 LightSpacePos[NUM_CASCADES];
 
+#ifdef OBJECT_BUFFER
+// drawn through a DrawBatch: model, normal matrix and material come from the ObjectBuffer
+layout (location = 15) in uint objectIndex;
+flat out uint MaterialIndex;
+#ifdef OBJECT_STORAGE_BUFFER
+struct ObjectData {
+    mat4 model;
+    vec4 normalMatrix[3];
+    vec4 material;
+};
+layout (std430) buffer Objects {
+    ObjectData objects[];
+};
+
+mat4 objectModel() { return objects[objectIndex].model; }
+mat3 objectNormalMatrix() { return mat3(objects[objectIndex].normalMatrix[0].xyz, objects[objectIndex].normalMatrix[1].xyz, objects[objectIndex].normalMatrix[2].xyz); }
+uint objectMaterial() { return uint(objects[objectIndex].material.x); }
+#else
+uniform samplerBuffer objectData;
+
+vec4 objectTexel(int i) { return texelFetch(objectData, int(objectIndex) * 8 + i); }
+mat4 objectModel() { return mat4(objectTexel(0), objectTexel(1), objectTexel(2), objectTexel(3)); }
+mat3 objectNormalMatrix() { return mat3(objectTexel(4).xyz, objectTexel(5).xyz, objectTexel(6).xyz); }
+uint objectMaterial() { return uint(objectTexel(7).x); }
+#endif
+#else
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
-uniform mat4 FragPosLP[NUM_CASCADES]; //FragPosLightSpace
+uniform mat3 normalMatrix;
+
+mat4 objectModel() { return model; }
+mat3 objectNormalMatrix() { return normalMatrix; }
+#endif
+layout (std140) uniform Camera {
+    mat4 projection;
+    mat4 view;
+    vec3 viewPos;
+};
+layout (std140) uniform Cascades {
+    Light light;
+    mat4 FragPosLP[NUM_CASCADES]; //FragPosLightSpace
+    float cascadeEndClipSpace[NUM_CASCADES];
+};
 
 void main()
 {
-    FragPos = vec3(model * vec4(aPos, 1.0));
-    Normal = mat3(transpose(inverse(model))) * aNormal;  
+    FragPos = vec3(objectModel() * vec4(aPos, 1.0));
+    Normal = objectNormalMatrix() * aNormal;
+#ifdef OBJECT_BUFFER
+    MaterialIndex = objectMaterial();
+#endif
     gl_Position = projection * view * vec4(FragPos, 1.0);
 
     for (int i = 0 ; i < NUM_CASCADES ; i++) {
@@ -19,7 +19,11 @@ struct Light {
 in vec3 FragPos;  
 in vec3 Normal;  
   
-uniform vec3 viewPos;
+layout (std140) uniform Camera {
+    mat4 projection;
+    mat4 view;
+    vec3 viewPos;
+};
 uniform Material material;
 uniform Light light;
 uniform vec3 color;
@@ -8,13 +8,17 @@ out vec2 FragTexCoords;
 out vec3 Normal;
 
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+uniform mat3 normalMatrix;
+layout (std140) uniform Camera {
+    mat4 projection;
+    mat4 view;
+    vec3 viewPos;
+};
 
 void main()
 {
     FragPos = vec3(model * vec4(aPos, 1.0));
-    Normal = mat3(transpose(inverse(model))) * aNormal;    
+    Normal = normalMatrix * aNormal;    
     FragTexCoords = aTexCoords;
     
     gl_Position = projection * view * vec4(FragPos, 1.0);
@@ -1,7 +1,11 @@
 #version 330 core
+// variants: TEXTURED samples texture_diffuse0 instead of using color,
+// BLOOM also writes the bright parts to a second target
 
 layout (location = 0) out vec4 FragColor;
+#ifdef BLOOM
 layout (location = 1) out vec4 BrightColor;
+#endif
 
 struct Material {
     vec3 ambient;
@@ -46,23 +50,39 @@ struct SpotLight {
     float quadratic;
 };
 
-#define NR_DIR_LIGHTS $ND$
-#define NR_POINT_LIGHTS $NP$
-#define NR_SPOT_LIGHTS $NS$
+#ifndef NR_DIR_LIGHTS
+#define NR_DIR_LIGHTS 1
+#endif
+#ifndef NR_POINT_LIGHTS
+#define NR_POINT_LIGHTS 1
+#endif
+#ifndef NR_SPOT_LIGHTS
+#define NR_SPOT_LIGHTS 1
+#endif
 
 in vec3 FragPos;  
-in vec2 FragTexCoords;
 in vec3 Normal;  
+#ifdef TEXTURED
+in vec2 FragTexCoords;
 
 // texture samplers
 uniform sampler2D texture_diffuse0;
+#else
+uniform vec3 color;
+#endif
   
-uniform vec3 viewPos;
+layout (std140) uniform Camera {
+    mat4 projection;
+    mat4 view;
+    vec3 viewPos;
+};
 uniform Material material;
 
-uniform DirectionalLight dirLights[NR_DIR_LIGHTS];
-uniform PointLight pointLights[NR_POINT_LIGHTS];
-uniform SpotLight spotLights[NR_SPOT_LIGHTS];
+layout (std140) uniform Lights {
+    DirectionalLight dirLights[NR_DIR_LIGHTS];
+    PointLight pointLights[NR_POINT_LIGHTS];
+    SpotLight spotLights[NR_SPOT_LIGHTS];
+};
 
 // function prototypes
 vec3 CalcDirLight(DirectionalLight light, vec3 normal, vec3 viewDir);
@@ -83,15 +103,21 @@ void main()
     for(int i = 0; i < NR_SPOT_LIGHTS; i++)
         result += spotLights[i].on ? CalcSpotLight(spotLights[i], norm, FragPos, viewDir) : vec3(0.0, 0.0, 0.0);
 
+#ifdef TEXTURED
     vec4 fragOriginalColor = texture(texture_diffuse0, FragTexCoords);
+#else
+    vec4 fragOriginalColor = vec4(color, 1.0f);
+#endif
     vec3 resultFinal = result * fragOriginalColor.rgb;
 
+#ifdef BLOOM
     // check whether result is higher than some threshold, if so, output as bloom threshold color
     float brightness = dot(resultFinal, vec3(0.2126, 0.7152, 0.0722));
     if(brightness > 1.0)
         BrightColor = vec4(resultFinal, 1.0);
     else
         BrightColor = vec4(0.0, 0.0, 0.0, 1.0);
+#endif
 
     FragColor = vec4(resultFinal, fragOriginalColor[3]);
 } 
@@ -1,21 +1,31 @@
 #version 330 core
 layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec3 aNormal;
+#ifdef TEXTURED
 layout (location = 2) in vec2 aTexCoord;
+#endif
 
 out vec3 FragPos;
+#ifdef TEXTURED
 out vec2 FragTexCoords;
+#endif
 out vec3 Normal;
 
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+uniform mat3 normalMatrix;
+layout (std140) uniform Camera {
+    mat4 projection;
+    mat4 view;
+    vec3 viewPos;
+};
 
 void main()
 {
     FragPos = vec3(model * vec4(aPos, 1.0));
+#ifdef TEXTURED
     FragTexCoords = aTexCoord;
-    Normal = mat3(transpose(inverse(model))) * aNormal;  
+#endif
+    Normal = normalMatrix * aNormal;  
     
     gl_Position = projection * view * vec4(FragPos, 1.0);
 }
\ No newline at end of file
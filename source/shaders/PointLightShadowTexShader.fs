@@ -28,7 +28,11 @@ in vec4 FragPosLightSpace;
 uniform sampler2D texture_diffuse0;
 uniform sampler2D shadowMap;
   
-uniform vec3 viewPos;
+layout (std140) uniform Camera {
+    mat4 projection;
+    mat4 view;
+    vec3 viewPos;
+};
 uniform Material material;
 uniform Light light;
 
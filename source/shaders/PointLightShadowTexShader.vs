@@ -9,15 +9,19 @@ out vec3 Normal;
 out vec4 FragPosLightSpace;
 
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+uniform mat3 normalMatrix;
+layout (std140) uniform Camera {
+    mat4 projection;
+    mat4 view;
+    vec3 viewPos;
+};
 uniform mat4 lightSpaceMat;
 
 void main()
 {
     FragPos = vec3(model * vec4(aPos, 1.0));
     FragTexCoords = aTexCoord;
-    Normal = mat3(transpose(inverse(model))) * aNormal;  
+    Normal = normalMatrix * aNormal;  
     FragPosLightSpace = lightSpaceMat * vec4(FragPos, 1.0);
     gl_Position = projection * view * vec4(FragPos, 1.0);
 }
\ No newline at end of file
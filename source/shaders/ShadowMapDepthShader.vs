@@ -4,9 +4,34 @@ layout (location = 1) in vec3 aNormal;
 layout (location = 2) in vec2 aTexCoords;
 
 uniform mat4 lightSpaceMat;
+
+#ifdef OBJECT_BUFFER
+// drawn through a DrawBatch: the model matrix comes from the ObjectBuffer
+layout (location = 15) in uint objectIndex;
+#ifdef OBJECT_STORAGE_BUFFER
+struct ObjectData {
+    mat4 model;
+    vec4 normalMatrix[3];
+    vec4 material;
+};
+layout (std430) buffer Objects {
+    ObjectData objects[];
+};
+
+mat4 objectModel() { return objects[objectIndex].model; }
+#else
+uniform samplerBuffer objectData;
+
+vec4 objectTexel(int i) { return texelFetch(objectData, int(objectIndex) * 8 + i); }
+mat4 objectModel() { return mat4(objectTexel(0), objectTexel(1), objectTexel(2), objectTexel(3)); }
+#endif
+#else
 uniform mat4 model;
 
+mat4 objectModel() { return model; }
+#endif
+
 void main()
 {
-    gl_Position = lightSpaceMat * model * vec4(aPos, 1.0);
-}
\ No newline at end of file
+    gl_Position = lightSpaceMat * objectModel() * vec4(aPos, 1.0);
+}
@@ -30,7 +30,11 @@ in vec4 FragPosLightSpace;
 // texture samplers
 uniform sampler2D shadowMap;
 
-uniform vec3 viewPos;
+layout (std140) uniform Camera {
+    mat4 projection;
+    mat4 view;
+    vec3 viewPos;
+};
 uniform Material material;
 uniform Light light;
 uniform vec3 color;
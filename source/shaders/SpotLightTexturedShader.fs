@@ -29,7 +29,11 @@ in vec2 FragTexCoords;
 // texture samplers
 uniform sampler2D texture_diffuse0;
   
-uniform vec3 viewPos;
+layout (std140) uniform Camera {
+    mat4 projection;
+    mat4 view;
+    vec3 viewPos;
+};
 uniform Material material;
 uniform Light light;
 
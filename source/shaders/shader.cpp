@@ -1,10 +1,62 @@
 #include "shader.hpp"
+#include "../uniformBlocks.hpp"
+#include "../glState.hpp"
 
 #include <glad/glad.h>
+#include <algorithm>
+#include <cstring>
+#include <cstdio>
+#include <filesystem>
 #include <fstream>
 #include <sstream>
+#include <utility>
 #include <iostream>
 
+namespace {
+    const uint32_t PROGRAM_BINARY_MAGIC = 0x50424743; // "CGBP"
+
+    struct ProgramBinaryHeader {
+        uint32_t magic;
+        uint32_t version;
+        uint64_t key;
+        uint32_t format;
+        uint32_t length;
+    };
+
+    std::string glString(GLenum name)
+    {
+        const GLubyte* value = glGetString(name);
+        return value ? reinterpret_cast<const char*>(value) : "";
+    }
+
+    // program binaries need GL 4.1 and a driver that offers at least one format
+    bool programBinariesSupported()
+    {
+        if (!GLAD_GL_VERSION_4_1)
+            return false;
+        GLint formats = 0;
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+        return formats > 0;
+    }
+
+    // GL_KHR_parallel_shader_compile and GL_ARB_parallel_shader_compile, not part of the generated glad
+    const GLenum COMPLETION_STATUS = 0x91B1;
+    typedef void (APIENTRYP MaxShaderCompilerThreadsProc)(GLuint count);
+
+    bool hasExtension(const char* name)
+    {
+        GLint count = 0;
+        glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+        for (GLint i = 0; i < count; i++)
+        {
+            const GLubyte* extension = glGetStringi(GL_EXTENSIONS, i);
+            if (extension && std::strcmp(reinterpret_cast<const char*>(extension), name) == 0)
+                return true;
+        }
+        return false;
+    }
+}
+
     Shader::Shader(const char* vertexPath, const char* fragmentPath) 
     {
         StartUp(vertexPath, fragmentPath);
@@ -12,7 +64,18 @@
 
     void Shader::StartUp(const char* vertexPath, const char* fragmentPath, int dirLights, int pointLights, int spotLights)
     {
-        // 1. retrieve the vertex/fragment source code from filePath
+        StartUp(vertexPath, fragmentPath, ShaderVariant().Lights(dirLights, pointLights, spotLights));
+    }
+
+    void Shader::StartUp(const char* vertexPath, const char* fragmentPath, const ShaderVariant& variant)
+    {
+        StartUpAsync(vertexPath, fragmentPath, variant);
+        waitUntilReady();
+    }
+
+    void Shader::StartUpAsync(const char* vertexPath, const char* fragmentPath, const ShaderVariant& variant)
+    {
+        // 1. retrieve the vertex/fragment source code from filePath and specialize it
         std::string vertexCode;
         std::string fragmentCode;
         std::ifstream vShaderFile;
@@ -40,114 +103,350 @@
         {
             std::cout << "ERROR::SHADER::FILE_NOT_SUCCESFULLY_READ" << std::endl;
         }
-        // Replace the amount of lights in the fragment shader code
-        if (dirLights > 0) {
-            std::string replacement = "$ND$";
-            size_t pos = fragmentCode.find(replacement);
-            std::string lights = std::to_string(dirLights);
-            fragmentCode.replace(pos, replacement.size(), lights);
-        }
-        if (pointLights > 0) {
-            std::string replacement = "$NP$";
-            size_t pos = fragmentCode.find(replacement);
-            std::string lights = std::to_string(pointLights);
-            fragmentCode.replace(pos, replacement.size(), lights);
-        }
-        if (spotLights > 0) {
-            std::string replacement = "$NS$";
-            size_t pos = fragmentCode.find(replacement);
-            std::string lights = std::to_string(spotLights);
-            fragmentCode.replace(pos, replacement.size(), lights);
+        vertexCode = variant.Apply(vertexCode);
+        fragmentCode = variant.Apply(fragmentCode);
+
+        generation = ++generationCount;
+        // 2. reuse the program linked by an earlier run when the sources and the driver are the same
+        bool useBinaryCache = !binaryCacheDirectory.empty() && programBinariesSupported();
+        uint64_t binaryKey = 0;
+        if (useBinaryCache)
+        {
+            binaryKey = programBinaryKey(vertexCode, fragmentCode);
+            if (loadProgramBinary(binaryKey))
+            {
+                reflectUniforms();
+                bindUniformBlocks();
+                return;
+            }
         }
-    
+
         const char* vShaderCode = vertexCode.c_str();
         const char* fShaderCode = fragmentCode.c_str();
-        // 2. compile shaders
+        // 3. compile shaders, their status is checked once the program is done
         unsigned int vertex, fragment;
         // vertex shader
         vertex = glCreateShader(GL_VERTEX_SHADER);
         glShaderSource(vertex, 1, &vShaderCode, NULL);
         glCompileShader(vertex);
-        checkCompileErrors(vertex, "VERTEX");
         // fragment Shader
         fragment = glCreateShader(GL_FRAGMENT_SHADER);
         glShaderSource(fragment, 1, &fShaderCode, NULL);
         glCompileShader(fragment);
-        checkCompileErrors(fragment, "FRAGMENT");
         // shader Program
         ID = glCreateProgram();
         glAttachShader(ID, vertex);
         glAttachShader(ID, fragment);
+        if (useBinaryCache)
+            glProgramParameteri(ID, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
         glLinkProgram(ID);
+        pendingLink = PendingLink{ true, vertex, fragment, useBinaryCache, binaryKey };
+    }
+
+    bool Shader::isReady()
+    {
+        if (!pendingLink.active)
+            return true;
+        // without the extension there is no way to ask without waiting
+        if (parallelCompile)
+        {
+            GLint done = GL_FALSE;
+            glGetProgramiv(ID, COMPLETION_STATUS, &done);
+            if (!done)
+                return false;
+        }
+        waitUntilReady();
+        return true;
+    }
+
+    void Shader::waitUntilReady()
+    {
+        if (!pendingLink.active)
+            return;
+        pendingLink.active = false;
+        checkCompileErrors(pendingLink.vertex, "VERTEX");
+        checkCompileErrors(pendingLink.fragment, "FRAGMENT");
         checkCompileErrors(ID, "PROGRAM");
+        if (pendingLink.saveBinary)
+            saveProgramBinary(pendingLink.binaryKey);
+        reflectUniforms();
+        bindUniformBlocks();
         // delete the shaders as they're linked into our program now and no longer necessery
-        glDeleteShader(vertex);
-        glDeleteShader(fragment);
+        glDeleteShader(pendingLink.vertex);
+        glDeleteShader(pendingLink.fragment);
+    }
+
+    bool Shader::EnableParallelCompile(GLADloadproc load)
+    {
+        const char* maxThreadsName = nullptr;
+        if (hasExtension("GL_KHR_parallel_shader_compile"))
+            maxThreadsName = "glMaxShaderCompilerThreadsKHR";
+        else if (hasExtension("GL_ARB_parallel_shader_compile"))
+            maxThreadsName = "glMaxShaderCompilerThreadsARB";
+        parallelCompile = maxThreadsName != nullptr;
+        if (!parallelCompile)
+            return false;
 
+        // 0xFFFFFFFF lets the driver pick the number of threads
+        MaxShaderCompilerThreadsProc maxThreads = reinterpret_cast<MaxShaderCompilerThreadsProc>(load(maxThreadsName));
+        if (maxThreads)
+            maxThreads(0xFFFFFFFF);
+        return true;
     }
     // activate the shader
     // ------------------------------------------------------------------------
     void Shader::use() const
     {
-        glUseProgram(ID);
+        GLState::Get().UseProgram(ID);
     }
-    // utility uniform functions
+    // program binary cache
     // ------------------------------------------------------------------------
-    void Shader::setBool(const std::string& name, bool value) const
+    void Shader::SetBinaryCacheDirectory(const std::string& directory)
+    {
+        binaryCacheDirectory = directory;
+    }
+
+    // the light counts are already substituted into the sources, so they are part of the key
+    uint64_t Shader::programBinaryKey(const std::string& vertexCode, const std::string& fragmentCode)
     {
-        glUniform1i(glGetUniformLocation(ID, name.c_str()), (int)value);
+        std::string key = std::to_string(PROGRAM_BINARY_VERSION);
+        key += '\0' + vertexCode + '\0' + fragmentCode;
+        key += '\0' + glString(GL_VENDOR) + '\0' + glString(GL_RENDERER) + '\0' + glString(GL_VERSION);
+        return uniformHash(key);
     }
+
+    std::string Shader::programBinaryPath(uint64_t key)
+    {
+        char name[17];
+        std::snprintf(name, sizeof(name), "%016llx", static_cast<unsigned long long>(key));
+        return (std::filesystem::path(binaryCacheDirectory) / (std::string(name) + ".bin")).string();
+    }
+
+    bool Shader::loadProgramBinary(uint64_t key)
+    {
+        std::ifstream file(programBinaryPath(key), std::ios::binary);
+        if (!file)
+            return false;
+        ProgramBinaryHeader header;
+        if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) || header.magic != PROGRAM_BINARY_MAGIC
+            || header.version != PROGRAM_BINARY_VERSION || header.key != key)
+            return false;
+        std::vector<char> binary(header.length);
+        if (!file.read(binary.data(), static_cast<std::streamsize>(binary.size())))
+            return false;
+
+        ID = glCreateProgram();
+        glProgramBinary(ID, header.format, binary.data(), static_cast<GLsizei>(binary.size()));
+        // a driver update can reject a binary it wrote itself: compile from source instead
+        GLint success = 0;
+        glGetProgramiv(ID, GL_LINK_STATUS, &success);
+        if (!success)
+        {
+            GLState::Get().DeleteProgram(ID);
+            ID = 0;
+            return false;
+        }
+        return true;
+    }
+
+    void Shader::saveProgramBinary(uint64_t key) const
+    {
+        GLint success = 0, length = 0;
+        glGetProgramiv(ID, GL_LINK_STATUS, &success);
+        glGetProgramiv(ID, GL_PROGRAM_BINARY_LENGTH, &length);
+        if (!success || length <= 0)
+            return;
+        std::vector<char> binary(length);
+        GLenum format = 0;
+        glGetProgramBinary(ID, length, &length, &format, binary.data());
+
+        std::error_code error;
+        std::filesystem::create_directories(binaryCacheDirectory, error);
+        // write to a temporary file first, so a crash never leaves a half written binary behind
+        std::string path = programBinaryPath(key);
+        std::string temporaryPath = path + ".tmp";
+        {
+            std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+            if (!file)
+                return;
+            ProgramBinaryHeader header{ PROGRAM_BINARY_MAGIC, PROGRAM_BINARY_VERSION, key, format, static_cast<uint32_t>(length) };
+            file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            file.write(binary.data(), length);
+            if (!file)
+                return;
+        }
+        std::remove(path.c_str());
+        std::rename(temporaryPath.c_str(), path.c_str());
+    }
+
+    // records the location of every active uniform, so setting one never has to ask GL for it
+    // ------------------------------------------------------------------------
+    void Shader::reflectUniforms()
+    {
+        uniformLocations.clear();
+        uniformValues.clear();
+        GLint count = 0, maxLength = 0;
+        glGetProgramiv(ID, GL_ACTIVE_UNIFORMS, &count);
+        glGetProgramiv(ID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+        std::string name(maxLength > 0 ? maxLength : 1, '\0');
+        for (GLint i = 0; i < count; i++)
+        {
+            GLsizei length = 0;
+            GLint size = 0;
+            GLenum type = 0;
+            glGetActiveUniform(ID, i, maxLength, &length, &size, &type, name.data());
+            std::string_view uniform(name.data(), length);
+            int location = glGetUniformLocation(ID, name.c_str());
+            if (location < 0)
+                continue; // member of a uniform block
+            uniformLocations[uniformHash(uniform)] = location;
+            if (location + size > static_cast<GLint>(uniformValues.size()))
+                uniformValues.resize(location + size);
+
+            // arrays are reported as "name[0]": also register "name" and every other element
+            if (uniform.size() > 3 && uniform.substr(uniform.size() - 3) == "[0]")
+            {
+                std::string_view base = uniform.substr(0, uniform.size() - 3);
+                uniformLocations[uniformHash(base)] = location;
+                for (GLint element = 1; element < size; element++)
+                {
+                    std::string elementName = std::string(base) + "[" + std::to_string(element) + "]";
+                    int elementLocation = glGetUniformLocation(ID, elementName.c_str());
+                    uniformLocations[uniformHash(elementName)] = elementLocation;
+                    if (elementLocation >= static_cast<int>(uniformValues.size()))
+                        uniformValues.resize(elementLocation + 1);
+                }
+            }
+        }
+    }
+
+    // points the shared blocks the program declares at their fixed binding points
     // ------------------------------------------------------------------------
-    void Shader::setInt(const std::string& name, int value) const
+    void Shader::bindUniformBlocks()
+    {
+        // size of the matching C++ struct, 0 for blocks sized at run time
+        struct SharedBlock {
+            const char* name;
+            unsigned int binding;
+            GLint size;
+        };
+        static const SharedBlock blocks[] = {
+            { "Camera", CAMERA_BLOCK_BINDING, sizeof(CameraBlock) },
+            { "Lights", LIGHTS_BLOCK_BINDING, 0 },
+            { "Cascades", CASCADES_BLOCK_BINDING, sizeof(CascadesBlock) },
+            { "Materials", MATERIALS_BLOCK_BINDING, sizeof(MaterialBlock) * MATERIALS_BLOCK_COUNT },
+        };
+        for (const auto& block : blocks)
+        {
+            unsigned int index = glGetUniformBlockIndex(ID, block.name);
+            if (index == GL_INVALID_INDEX)
+                continue;
+            glUniformBlockBinding(ID, index, block.binding);
+            // e.g. a NUM_CASCADES other than CASCADES_BLOCK_COUNT, which would read the buffer with the wrong layout
+            GLint size = 0;
+            glGetActiveUniformBlockiv(ID, index, GL_UNIFORM_BLOCK_DATA_SIZE, &size);
+            // drivers may or may not round the size up to the std140 16 byte alignment
+            if (block.size && (size + 15) / 16 * 16 != block.size)
+                std::cout << "ERROR::SHADER::UNIFORM_BLOCK_SIZE_MISMATCH " << block.name << ": " << size
+                          << " bytes in the shader, " << block.size << " in uniformBlocks.hpp" << std::endl;
+        }
+        // storage blocks only exist in programs built with OBJECT_STORAGE_BUFFER, which needs GL 4.3
+        if (GLAD_GL_VERSION_4_3)
+        {
+            unsigned int index = glGetProgramResourceIndex(ID, GL_SHADER_STORAGE_BLOCK, "Objects");
+            if (index != GL_INVALID_INDEX)
+                glShaderStorageBlockBinding(ID, index, OBJECTS_STORAGE_BINDING);
+        }
+    }
+
+    int Shader::getLocation(UniformName name) const
     {
-        glUniform1i(glGetUniformLocation(ID, name.c_str()), value);
+        auto found = uniformLocations.find(name.hash);
+        return found != uniformLocations.end() ? found->second : -1;
     }
+
+    // compares against the shadow copy and takes the new value; false means the upload can be skipped
     // ------------------------------------------------------------------------
-    void Shader::setFloat(const std::string& name, float value) const
+    template <typename T>
+    bool Shader::changed(int location, const T& value) const
     {
-        glUniform1f(glGetUniformLocation(ID, name.c_str()), value);
+        static_assert(sizeof(T) <= sizeof(UniformValue::bytes));
+        if (location < 0 || location >= static_cast<int>(uniformValues.size()))
+            return false;
+        UniformValue& shadow = uniformValues[location];
+        if (shadow.known && std::memcmp(shadow.bytes, &value, sizeof(T)) == 0) {
+            uniformStats.skipped++;
+            return false;
+        }
+        std::memcpy(shadow.bytes, &value, sizeof(T));
+        shadow.known = true;
+        uniformStats.issued++;
+        return true;
     }
+
+    // utility uniform functions
     // ------------------------------------------------------------------------
-    void Shader::setVec2(const std::string& name, const glm::vec2& value) const
+    void Shader::set(Uniform<bool> uniform, bool value) const
     {
-        glUniform2fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]);
+        int asInt = (int)value;
+        if (changed(uniform.location, asInt))
+            glUniform1i(uniform.location, asInt);
     }
-    void Shader::setVec2(const std::string& name, float x, float y) const
+    // ------------------------------------------------------------------------
+    void Shader::set(Uniform<int> uniform, int value) const
     {
-        glUniform2f(glGetUniformLocation(ID, name.c_str()), x, y);
+        if (changed(uniform.location, value))
+            glUniform1i(uniform.location, value);
     }
     // ------------------------------------------------------------------------
-    void Shader::setVec3(const std::string& name, const glm::vec3& value) const
+    void Shader::set(Uniform<float> uniform, float value) const
     {
-        glUniform3fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]);
+        if (changed(uniform.location, value))
+            glUniform1f(uniform.location, value);
     }
-    void Shader::setVec3(const std::string& name, float x, float y, float z) const
+    // ------------------------------------------------------------------------
+    void Shader::set(Uniform<glm::vec2> uniform, const glm::vec2& value) const
     {
-        glUniform3f(glGetUniformLocation(ID, name.c_str()), x, y, z);
+        if (changed(uniform.location, value))
+            glUniform2fv(uniform.location, 1, &value[0]);
     }
     // ------------------------------------------------------------------------
-    void Shader::setVec4(const std::string& name, const glm::vec4& value) const
+    void Shader::set(Uniform<glm::vec3> uniform, const glm::vec3& value) const
     {
-        glUniform4fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]);
+        if (changed(uniform.location, value))
+            glUniform3fv(uniform.location, 1, &value[0]);
     }
-    void Shader::setVec4(const std::string& name, float x, float y, float z, float w) const
+    // ------------------------------------------------------------------------
+    void Shader::set(Uniform<glm::vec4> uniform, const glm::vec4& value) const
     {
-        glUniform4f(glGetUniformLocation(ID, name.c_str()), x, y, z, w);
+        if (changed(uniform.location, value))
+            glUniform4fv(uniform.location, 1, &value[0]);
     }
     // ------------------------------------------------------------------------
-    void Shader::setMat2(const std::string& name, const glm::mat2& mat) const
+    void Shader::set(Uniform<glm::mat2> uniform, const glm::mat2& mat) const
     {
-        glUniformMatrix2fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+        if (changed(uniform.location, mat))
+            glUniformMatrix2fv(uniform.location, 1, GL_FALSE, &mat[0][0]);
     }
     // ------------------------------------------------------------------------
-    void Shader::setMat3(const std::string& name, const glm::mat3& mat) const
+    void Shader::set(Uniform<glm::mat3> uniform, const glm::mat3& mat) const
     {
-        glUniformMatrix3fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+        if (changed(uniform.location, mat))
+            glUniformMatrix3fv(uniform.location, 1, GL_FALSE, &mat[0][0]);
     }
     // ------------------------------------------------------------------------
-    void Shader::setMat4(const std::string& name, const glm::mat4& mat) const
+    void Shader::set(Uniform<glm::mat4> uniform, const glm::mat4& mat) const
     {
-        glUniformMatrix4fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+        if (changed(uniform.location, mat))
+            glUniformMatrix4fv(uniform.location, 1, GL_FALSE, &mat[0][0]);
+    }
+
+    void Shader::setModel(const glm::mat4& model) const
+    {
+        setMat4("model"_uniform, model);
+        Uniform<glm::mat3> normalMatrix = getUniform<glm::mat3>("normalMatrix"_uniform);
+        if (normalMatrix.location >= 0)
+            set(normalMatrix, glm::transpose(glm::inverse(glm::mat3(model))));
     }
 
     void Shader::checkCompileErrors(unsigned int shader, std::string type)
@@ -173,3 +472,83 @@
             }
         }
     }
+
+    // ------------------------------------------------------------------------
+    ShaderVariant& ShaderVariant::Lights(int dirLights, int pointLights, int spotLights)
+    {
+        if (dirLights > 0)
+            Define("NR_DIR_LIGHTS", dirLights);
+        if (pointLights > 0)
+            Define("NR_POINT_LIGHTS", pointLights);
+        if (spotLights > 0)
+            Define("NR_SPOT_LIGHTS", spotLights);
+        return *this;
+    }
+
+    std::string ShaderVariant::GetKey() const
+    {
+        std::string key = version.empty() ? "" : "#version=" + version + ";";
+        for (const auto& [name, value] : defines)
+            key += name + "=" + value + ";";
+        return key;
+    }
+
+    std::string ShaderVariant::Apply(const std::string& source) const
+    {
+        if (defines.empty() && version.empty())
+            return source;
+        std::string preamble;
+        for (const auto& [name, value] : defines)
+            preamble += "#define " + name + " " + value + "\n";
+
+        // #version has to stay the first statement
+        size_t versionStart = source.find("#version");
+        if (versionStart == std::string::npos) {
+            std::string versionLine = version.empty() ? "" : "#version " + version + "\n";
+            return versionLine + preamble + "#line 1\n" + source;
+        }
+        size_t lineEnd = source.find('\n', versionStart);
+        std::string versionLine = version.empty() ? source.substr(0, lineEnd) : source.substr(0, versionStart) + "#version " + version;
+        if (lineEnd == std::string::npos)
+            return versionLine + "\n" + preamble;
+        // keep compiler messages pointing at the lines of the file
+        size_t nextLine = 2 + std::count(source.begin(), source.begin() + versionStart, '\n');
+        return versionLine + "\n" + preamble + "#line " + std::to_string(nextLine) + "\n" + source.substr(lineEnd + 1);
+    }
+
+    // ------------------------------------------------------------------------
+    ShaderCache& ShaderCache::Get()
+    {
+        static ShaderCache cache;
+        return cache;
+    }
+
+    Shader& ShaderCache::Load(const std::string& vertexPath, const std::string& fragmentPath, const ShaderVariant& variant)
+    {
+        Shader& shader = LoadAsync(vertexPath, fragmentPath, variant);
+        shader.waitUntilReady();
+        return shader;
+    }
+
+    int ShaderCache::GetPendingCount()
+    {
+        int pending = 0;
+        for (auto& [key, shader] : shaders)
+            if (!shader->isReady())
+                pending++;
+        return pending;
+    }
+
+    Shader& ShaderCache::LoadAsync(const std::string& vertexPath, const std::string& fragmentPath, const ShaderVariant& variant)
+    {
+        std::string key = vertexPath + "|" + fragmentPath + "|" + variant.GetKey();
+        auto cached = shaders.find(key);
+        if (cached != shaders.end())
+            return *cached->second;
+
+        std::unique_ptr<Shader> shader = std::make_unique<Shader>();
+        shader->StartUpAsync(vertexPath.c_str(), fragmentPath.c_str(), variant);
+        Shader& loaded = *shader;
+        shaders[key] = std::move(shader);
+        return loaded;
+    }
@@ -3,10 +3,91 @@
 #ifndef SHADER_H
 #define SHADER_H
 
+#include <glad/glad.h>
+
+#include <cstdint>
+#include <map>
+#include <memory>
 #include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
 #include <glm/glm.hpp>
 
-    
+// 64 bit FNV-1a of a uniform name, usable at compile time
+constexpr uint64_t uniformHash(std::string_view name)
+{
+    uint64_t hash = 14695981039346656037ull;
+    for (char c : name) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+/* Uniform name hashed at compile time: "light.position"_uniform */
+struct UniformName {
+    uint64_t hash;
+};
+
+consteval UniformName operator""_uniform(const char* name, size_t length)
+{
+    return UniformName{ uniformHash(std::string_view(name, length)) };
+}
+
+/* Location of a uniform of type T, resolved once with Shader::getUniform and
+   then set with Shader::set without any lookup */
+template <typename T>
+struct Uniform {
+    int location = -1;
+};
+
+// uniform updates sent to GL and the ones dropped because the value was already set
+struct UniformStats {
+    uint64_t issued = 0;
+    uint64_t skipped = 0;
+};
+
+/* A specialization of a shader source: #defines injected right after #version
+   in every stage, e.g. ShaderVariant().Define("TEXTURED").Lights(1, 8, 2).
+   Constants known at compile time let the GLSL compiler strip dead branches
+   and unroll loops, so one source serves what used to be hand-kept copies. */
+class ShaderVariant {
+public:
+    ShaderVariant& Define(const std::string& name, const std::string& value = "1")
+    {
+        defines[name] = value;
+        return *this;
+    }
+    ShaderVariant& Define(const std::string& name, int value) { return Define(name, std::to_string(value)); }
+
+    // NR_DIR_LIGHTS, NR_POINT_LIGHTS and NR_SPOT_LIGHTS, counts of 0 are left to the shader's default
+    ShaderVariant& Lights(int dirLights, int pointLights, int spotLights);
+    // replaces the source's #version line, e.g. Version("430 core") for features 330 lacks
+    ShaderVariant& Version(const std::string& value)
+    {
+        version = value;
+        return *this;
+    }
+
+    // canonical "NAME=VALUE;..." string, the same for equal sets of defines
+    std::string GetKey() const;
+    // source with the defines inserted after its #version line
+    std::string Apply(const std::string& source) const;
+
+private:
+    // empty keeps the source's own
+    std::string version;
+    // ordered, so the key and the injected text don't depend on the order of Define calls
+    std::map<std::string, std::string> defines;
+};
+
+/* Programs are cached on disk with glGetProgramBinary, keyed by a hash of the
+   final sources (light counts included) and the GL vendor, renderer and version,
+   so a restart skips compiling and linking. Binaries the driver no longer
+   accepts are recompiled and replaced. Bump this to drop every cached binary. */
+#define PROGRAM_BINARY_VERSION 1
+
 class Shader {
 public:
     unsigned int ID;
@@ -14,24 +95,140 @@ public:
     Shader(const char* vertexPath, const char* fragmentPath);
 
     void StartUp(const char* vertexPath, const char* fragmentPath, int dirLights=0, int pointLights=0, int spotLights=0);
+    void StartUp(const char* vertexPath, const char* fragmentPath, const ShaderVariant& variant);
+    /* Submits the compile and link without querying their status, which would make
+       the driver finish them on the spot. The program can be used once isReady(). */
+    void StartUpAsync(const char* vertexPath, const char* fragmentPath, const ShaderVariant& variant = ShaderVariant());
+    // true once the program is linked and reflected; only non-blocking with parallel compile enabled
+    bool isReady();
+    // finishes a program submitted with StartUpAsync, blocking until the driver is done
+    void waitUntilReady();
+    // this program when it is ready, the fallback while it is still compiling
+    Shader& readyOr(Shader& fallback) { return isReady() ? *this : fallback; }
     void use() const;
-    void setBool(const std::string& name, bool value) const;
-    void setInt(const std::string& name, int value) const;
-    void setFloat(const std::string& name, float value) const;
-    void setVec2(const std::string& name, const glm::vec2& value) const;
-    void setVec2(const std::string& name, float x, float y) const;
-    void setVec3(const std::string& name, const glm::vec3& value) const;
-    void setVec3(const std::string& name, float x, float y, float z) const;
-    void setVec4(const std::string& name, const glm::vec4& value) const;
-    void setVec4(const std::string& name, float x, float y, float z, float w) const;
-    void setMat2(const std::string& name, const glm::mat2& mat) const;
-    void setMat3(const std::string& name, const glm::mat3& mat) const;
-    void setMat4(const std::string& name, const glm::mat4& mat) const;
+    // unique for every program this process links, unlike ID, which GL hands out again after a delete
+    uint64_t getGeneration() const { return generation; }
+
+    /* Turns on GL_KHR_parallel_shader_compile (or the ARB version) when the driver
+       has it: compiles run on driver threads and isReady() polls without blocking.
+       Returns false when it's not available. */
+    static bool EnableParallelCompile(GLADloadproc load);
+
+    // where linked programs are cached, relative to the working directory; empty disables the cache
+    static void SetBinaryCacheDirectory(const std::string& directory);
+
+    // location of an active uniform from the table built at link time, -1 if there is none
+    int getLocation(std::string_view name) const { return getLocation(UniformName{ uniformHash(name) }); }
+    int getLocation(UniformName name) const;
+    template <typename T>
+    Uniform<T> getUniform(std::string_view name) const { return Uniform<T>{ getLocation(name) }; }
+    template <typename T>
+    Uniform<T> getUniform(UniformName name) const { return Uniform<T>{ getLocation(name) }; }
+
+    void set(Uniform<bool> uniform, bool value) const;
+    void set(Uniform<int> uniform, int value) const;
+    void set(Uniform<float> uniform, float value) const;
+    void set(Uniform<glm::vec2> uniform, const glm::vec2& value) const;
+    void set(Uniform<glm::vec3> uniform, const glm::vec3& value) const;
+    void set(Uniform<glm::vec4> uniform, const glm::vec4& value) const;
+    void set(Uniform<glm::mat2> uniform, const glm::mat2& mat) const;
+    void set(Uniform<glm::mat3> uniform, const glm::mat3& mat) const;
+    void set(Uniform<glm::mat4> uniform, const glm::mat4& mat) const;
+
+    void setBool(std::string_view name, bool value) const { set(getUniform<bool>(name), value); }
+    void setInt(std::string_view name, int value) const { set(getUniform<int>(name), value); }
+    void setFloat(std::string_view name, float value) const { set(getUniform<float>(name), value); }
+    void setVec2(std::string_view name, const glm::vec2& value) const { set(getUniform<glm::vec2>(name), value); }
+    void setVec2(std::string_view name, float x, float y) const { setVec2(name, glm::vec2(x, y)); }
+    void setVec3(std::string_view name, const glm::vec3& value) const { set(getUniform<glm::vec3>(name), value); }
+    void setVec3(std::string_view name, float x, float y, float z) const { setVec3(name, glm::vec3(x, y, z)); }
+    void setVec4(std::string_view name, const glm::vec4& value) const { set(getUniform<glm::vec4>(name), value); }
+    void setVec4(std::string_view name, float x, float y, float z, float w) const { setVec4(name, glm::vec4(x, y, z, w)); }
+    void setMat2(std::string_view name, const glm::mat2& mat) const { set(getUniform<glm::mat2>(name), mat); }
+    void setMat3(std::string_view name, const glm::mat3& mat) const { set(getUniform<glm::mat3>(name), mat); }
+    void setMat4(std::string_view name, const glm::mat4& mat) const { set(getUniform<glm::mat4>(name), mat); }
+
+    void setBool(UniformName name, bool value) const { set(getUniform<bool>(name), value); }
+    void setInt(UniformName name, int value) const { set(getUniform<int>(name), value); }
+    void setFloat(UniformName name, float value) const { set(getUniform<float>(name), value); }
+    void setVec2(UniformName name, const glm::vec2& value) const { set(getUniform<glm::vec2>(name), value); }
+    void setVec3(UniformName name, const glm::vec3& value) const { set(getUniform<glm::vec3>(name), value); }
+    void setVec4(UniformName name, const glm::vec4& value) const { set(getUniform<glm::vec4>(name), value); }
+    void setMat2(UniformName name, const glm::mat2& mat) const { set(getUniform<glm::mat2>(name), mat); }
+    void setMat3(UniformName name, const glm::mat3& mat) const { set(getUniform<glm::mat3>(name), mat); }
+    void setMat4(UniformName name, const glm::mat4& mat) const { set(getUniform<glm::mat4>(name), mat); }
+
+    /* "model", and "normalMatrix" in shaders that have one: the inverse transpose
+       of the model's upper 3x3, worked out once per object instead of per vertex */
+    void setModel(const glm::mat4& model) const;
+
+    // totals over every shader since the last reset, e.g. once per frame
+    static UniformStats getUniformStats() { return uniformStats; }
+    static void resetUniformStats() { uniformStats = UniformStats(); }
 
 private:
+    // active uniforms by hashed name, filled once the program is linked
+    std::unordered_map<uint64_t, int> uniformLocations;
+
+    /* Last value uploaded to each location. Uniforms are program state, so a
+       set with the value the program already holds is dropped. Values set
+       without going through the Shader are not seen here. */
+    struct UniformValue {
+        alignas(16) unsigned char bytes[sizeof(glm::mat4)];
+        bool known = false;
+    };
+    mutable std::vector<UniformValue> uniformValues;
+    inline static UniformStats uniformStats;
+    inline static std::string binaryCacheDirectory = "shader_cache";
+    inline static bool parallelCompile = false;
+    uint64_t generation = 0;
+    inline static uint64_t generationCount = 0;
+
+    // a link submitted by StartUpAsync whose status hasn't been checked yet
+    struct PendingLink {
+        bool active = false;
+        unsigned int vertex = 0;
+        unsigned int fragment = 0;
+        bool saveBinary = false;
+        uint64_t binaryKey = 0;
+    };
+    PendingLink pendingLink;
+
+    template <typename T>
+    bool changed(int location, const T& value) const;
+
+    void reflectUniforms();
+    void bindUniformBlocks();
+    static uint64_t programBinaryKey(const std::string& vertexCode, const std::string& fragmentCode);
+    static std::string programBinaryPath(uint64_t key);
+    bool loadProgramBinary(uint64_t key);
+    void saveProgramBinary(uint64_t key) const;
     void checkCompileErrors(unsigned int shader, std::string type);
 
 };
 
 
+/* Library-wide cache of shader variants: each combination of sources and
+   defines is compiled once and shared by everyone who asks for it. */
+class ShaderCache {
+public:
+    static ShaderCache& Get();
+
+    ShaderCache(const ShaderCache&) = delete;
+    ShaderCache& operator=(const ShaderCache&) = delete;
+
+    Shader& Load(const std::string& vertexPath, const std::string& fragmentPath, const ShaderVariant& variant = ShaderVariant());
+    // like Load, but returns as soon as the program is submitted; see Shader::StartUpAsync
+    Shader& LoadAsync(const std::string& vertexPath, const std::string& fragmentPath, const ShaderVariant& variant = ShaderVariant());
+
+    inline int GetCount() const { return static_cast<int>(shaders.size()); }
+    // polls every program still compiling and returns how many are not ready
+    int GetPendingCount();
+
+private:
+    ShaderCache() {}
+
+    std::unordered_map<std::string, std::unique_ptr<Shader>> shaders;
+};
+
 #endif
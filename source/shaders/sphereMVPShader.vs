@@ -4,8 +4,11 @@ layout (location = 0) in vec3 aPos;
 uniform float pointRadius; 
 uniform float pointScale;
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+layout (std140) uniform Camera {
+    mat4 projection;
+    mat4 view;
+    vec3 viewPos;
+};
 
 void main()
 {	
@@ -0,0 +1,100 @@
+#pragma once
+
+/* Flattened node hierarchy, evaluated by the animator in one linear pass */
+
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include <string>
+#include <algorithm>
+#include <cassert>
+#include <glm/glm.hpp>
+#include <assimp/scene.h>
+#include "animdata.hpp"
+#include "assimp_glm_helpers.hpp"
+
+struct SkeletonNode
+{
+	/*bind pose transform relative to the parent node*/
+	glm::mat4 transformation;
+
+	/*offset matrix of the bone driven by this node, identity when boneIndex is -1*/
+	glm::mat4 offset;
+
+	/*index of the parent node, always smaller than the node's own index (-1 for the root)*/
+	int parent;
+
+	/*index in finalBoneMatrices, -1 when the node doesn't drive a bone*/
+	int boneIndex;
+
+	std::string name;
+};
+
+class Skeleton
+{
+public:
+	Skeleton() = default;
+
+	Skeleton(const aiNode* root, const std::map<std::string, BoneInfo>& boneInfoMap)
+	{
+		Flatten(root, -1);
+		ResolveBones(boneInfoMap);
+	}
+
+	/* Refreshes the bone palette index and offset of every node, needed when
+	   the bone info map grows after the skeleton was built */
+	void ResolveBones(const std::map<std::string, BoneInfo>& boneInfoMap)
+	{
+		m_BoneCount = 0;
+		for (auto& node : m_Nodes)
+		{
+			auto iter = boneInfoMap.find(node.name);
+			if (iter != boneInfoMap.end())
+			{
+				node.boneIndex = iter->second.id;
+				node.offset = iter->second.offset;
+				m_BoneCount = std::max(m_BoneCount, node.boneIndex + 1);
+			}
+			else
+			{
+				node.boneIndex = -1;
+				node.offset = glm::mat4(1.0f);
+			}
+		}
+	}
+
+	int FindNode(const std::string& name) const
+	{
+		auto iter = m_NodeIndices.find(name);
+		return iter != m_NodeIndices.end() ? iter->second : -1;
+	}
+
+	inline const std::vector<SkeletonNode>& GetNodes() const { return m_Nodes; }
+	inline int GetNodeCount() const { return static_cast<int>(m_Nodes.size()); }
+	inline int GetBoneCount() const { return m_BoneCount; }
+
+private:
+	// pre-order traversal, so parents are always stored before their children
+	void Flatten(const aiNode* src, int parent)
+	{
+		assert(src);
+
+		SkeletonNode node;
+		node.transformation = AssimpGLMHelpers::ConvertMatrixToGLMFormat(src->mTransformation);
+		node.offset = glm::mat4(1.0f);
+		node.parent = parent;
+		node.boneIndex = -1;
+		node.name = src->mName.data;
+
+		int index = static_cast<int>(m_Nodes.size());
+		m_NodeIndices.emplace(node.name, index);
+		m_Nodes.push_back(node);
+
+		for (unsigned int i = 0; i < src->mNumChildren; i++)
+			Flatten(src->mChildren[i], index);
+	}
+
+	std::vector<SkeletonNode> m_Nodes;
+	std::unordered_map<std::string, int> m_NodeIndices;
+	int m_BoneCount = 0;
+};
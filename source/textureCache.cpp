@@ -0,0 +1,170 @@
+#include "textureCache.hpp"
+#include "glState.hpp"
+
+#include <stb_image.h>
+
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+    TextureCache& TextureCache::Get()
+    {
+        static TextureCache cache;
+        return cache;
+    }
+
+    std::string TextureCache::settingsKey(const TextureSettings& settings, bool flip)
+    {
+        return "|" + std::to_string(settings.gammaCorrection) + "," + std::to_string(settings.wrap) + ","
+            + std::to_string(settings.minFilter) + "," + std::to_string(settings.magFilter) + ","
+            + std::to_string(settings.channels) + "," + std::to_string(flip);
+    }
+
+    // ------------------------------------------------------------------------
+    unsigned int TextureCache::Request(const std::string& path, const TextureSettings& settings)
+    {
+        std::error_code error;
+        std::filesystem::path canonical = std::filesystem::weakly_canonical(path, error);
+        std::string pathKey = (error ? std::filesystem::path(path).lexically_normal() : canonical).string()
+            + settingsKey(settings, m_FlipVertically);
+
+        auto cached = m_ByPath.find(pathKey);
+        if (cached != m_ByPath.end()) {
+            m_Entries[cached->second].references++;
+            return cached->second;
+        }
+
+        std::unique_ptr<Pending> pending = std::make_unique<Pending>();
+        std::string contentKey;
+        if (m_ContentDedup) {
+            std::ifstream file(path, std::ios::binary);
+            pending->file.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+            // 64 bit FNV-1a
+            uint64_t hash = 14695981039346656037ull;
+            for (unsigned char byte : pending->file) {
+                hash ^= byte;
+                hash *= 1099511628211ull;
+            }
+            contentKey = std::to_string(hash) + ":" + std::to_string(pending->file.size()) + settingsKey(settings, m_FlipVertically);
+
+            auto sameContent = m_ByContent.find(contentKey);
+            if (sameContent != m_ByContent.end()) {
+                Entry& entry = m_Entries[sameContent->second];
+                entry.references++;
+                entry.pathKeys.push_back(pathKey);
+                m_ByPath[pathKey] = sameContent->second;
+                return sameContent->second;
+            }
+        }
+
+        unsigned int textureID;
+        glGenTextures(1, &textureID);
+        Entry entry{ 1, 0, { pathKey }, contentKey };
+        m_Entries[textureID] = entry;
+        m_ByPath[pathKey] = textureID;
+        if (!contentKey.empty())
+            m_ByContent[contentKey] = textureID;
+
+        pending->id = textureID;
+        pending->path = path;
+        pending->settings = settings;
+        pending->flip = m_FlipVertically;
+        Pending* job = pending.get();
+        m_Pending.push_back(std::move(pending));
+        m_Jobs.Submit(m_Decodes, [job]()
+        {
+            // per thread, so the flag of this request holds whatever the global one is
+            stbi_set_flip_vertically_on_load_thread(job->flip);
+            if (!job->file.empty())
+                job->data = stbi_load_from_memory(job->file.data(), static_cast<int>(job->file.size()),
+                    &job->width, &job->height, &job->channels, job->settings.channels);
+            else
+                job->data = stbi_load(job->path.c_str(), &job->width, &job->height, &job->channels, job->settings.channels);
+            if (job->settings.channels)
+                job->channels = job->settings.channels;
+            std::vector<unsigned char>().swap(job->file);
+        });
+        return textureID;
+    }
+
+    void TextureCache::Flush()
+    {
+        m_Jobs.Wait(m_Decodes);
+        for (auto& pending : m_Pending)
+            upload(*pending);
+        m_Pending.clear();
+    }
+
+    unsigned int TextureCache::Load(const std::string& path, const TextureSettings& settings)
+    {
+        unsigned int textureID = Request(path, settings);
+        Flush();
+        return textureID;
+    }
+
+    void TextureCache::Release(unsigned int id)
+    {
+        auto found = m_Entries.find(id);
+        if (found == m_Entries.end() || --found->second.references > 0)
+            return;
+
+        // still decoding: let Flush finish it first so the worker never writes to a dropped Pending
+        for (const auto& pending : m_Pending) {
+            if (pending->id == id) {
+                Flush();
+                break;
+            }
+        }
+
+        for (const auto& key : found->second.pathKeys)
+            m_ByPath.erase(key);
+        if (!found->second.contentKey.empty())
+            m_ByContent.erase(found->second.contentKey);
+        m_MemoryUsage -= found->second.bytes;
+        m_Entries.erase(found);
+        GLState::Get().DeleteTextures(1, &id);
+    }
+
+    // ------------------------------------------------------------------------
+    void TextureCache::upload(Pending& pending)
+    {
+        if (!pending.data) {
+            std::cout << "Texture failed to load at path: " << pending.path << std::endl;
+            return;
+        }
+
+        GLenum internalFormat = GL_RGBA;
+        GLenum dataFormat = GL_RGBA;
+        if (pending.channels == 1) {
+            internalFormat = dataFormat = GL_RED;
+        }
+        else if (pending.channels == 3) {
+            internalFormat = pending.settings.gammaCorrection ? GL_SRGB : GL_RGB;
+            dataFormat = GL_RGB;
+        }
+        else if (pending.channels == 4) {
+            internalFormat = pending.settings.gammaCorrection ? GL_SRGB_ALPHA : GL_RGBA;
+            dataFormat = GL_RGBA;
+        }
+
+        GLState::Get().BindTexture(GL_TEXTURE_2D, pending.id);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, pending.width, pending.height, 0, dataFormat, GL_UNSIGNED_BYTE, pending.data);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        glGenerateMipmap(GL_TEXTURE_2D);
+
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, pending.settings.wrap);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, pending.settings.wrap);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, pending.settings.minFilter);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, pending.settings.magFilter);
+        stbi_image_free(pending.data);
+
+        // the mip chain adds about a third on top of the base level
+        size_t bytes = static_cast<size_t>(pending.width) * pending.height * pending.channels * 4 / 3;
+        auto entry = m_Entries.find(pending.id);
+        if (entry != m_Entries.end()) {
+            entry->second.bytes = bytes;
+            m_MemoryUsage += bytes;
+        }
+    }
@@ -0,0 +1,96 @@
+#pragma once
+
+#ifndef TEXTURE_CACHE_H
+#define TEXTURE_CACHE_H
+
+#include <glad/glad.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "jobSystem.hpp"
+
+/* How an image is turned into a GL texture. Part of the cache key, so the
+   same file loaded with different settings gets separate textures. */
+struct TextureSettings {
+    bool gammaCorrection = false;
+    GLint wrap = GL_REPEAT;
+    GLint minFilter = GL_LINEAR_MIPMAP_LINEAR;
+    GLint magFilter = GL_LINEAR;
+    // channels to decode to (0 keeps the ones in the file)
+    int channels = 0;
+};
+
+/* Library-wide cache of 2D textures, shared by Model and the examples'
+   loaders. Images are looked up by canonical path (and optionally by a hash
+   of the file contents, to also catch copies of an image under different
+   names), so each unique image is decoded and uploaded once. Textures are
+   reference counted and their GPU memory is tracked. Decoding runs on worker
+   threads; only the upload happens on the GL thread, in Flush().
+   Images are flipped vertically when SetFlipVertically() was on at the time
+   of the request. The flag is part of the key, and the workers decode with
+   it instead of the global stbi_set_flip_vertically_on_load one. */
+class TextureCache {
+public:
+    static TextureCache& Get();
+
+    TextureCache(const TextureCache&) = delete;
+    TextureCache& operator=(const TextureCache&) = delete;
+
+    // returns the texture right away; its pixels arrive with the next Flush()
+    unsigned int Request(const std::string& path, const TextureSettings& settings = TextureSettings());
+    // uploads every decoded image requested so far, waiting for the ones still decoding
+    void Flush();
+    // Request() followed by Flush()
+    unsigned int Load(const std::string& path, const TextureSettings& settings = TextureSettings());
+
+    // drops one reference; the texture is deleted with the last one
+    void Release(unsigned int id);
+
+    // also match images by content hash; costs reading each new file on the calling thread
+    void SetContentDedup(bool enabled) { m_ContentDedup = enabled; }
+    // flip the images requested from now on, like stbi_set_flip_vertically_on_load
+    void SetFlipVertically(bool flip) { m_FlipVertically = flip; }
+
+    inline size_t GetMemoryUsage() const { return m_MemoryUsage; }
+    inline int GetTextureCount() const { return static_cast<int>(m_Entries.size()); }
+
+private:
+    TextureCache() : m_ContentDedup(false), m_FlipVertically(false), m_MemoryUsage(0) {}
+
+    struct Entry {
+        int references;
+        size_t bytes;
+        // every path key that resolved to this texture
+        std::vector<std::string> pathKeys;
+        std::string contentKey;
+    };
+
+    // image decoded on a worker, waiting for its upload
+    struct Pending {
+        unsigned int id;
+        std::string path;
+        TextureSettings settings;
+        bool flip = false;
+        std::vector<unsigned char> file;
+        unsigned char* data = nullptr;
+        int width = 0, height = 0, channels = 0;
+    };
+
+    static std::string settingsKey(const TextureSettings& settings, bool flip);
+    void upload(Pending& pending);
+
+    JobSystem m_Jobs;
+    JobGroup m_Decodes;
+    std::vector<std::unique_ptr<Pending>> m_Pending;
+    std::unordered_map<std::string, unsigned int> m_ByPath;
+    std::unordered_map<std::string, unsigned int> m_ByContent;
+    std::unordered_map<unsigned int, Entry> m_Entries;
+    bool m_ContentDedup;
+    bool m_FlipVertically;
+    size_t m_MemoryUsage;
+};
+#endif
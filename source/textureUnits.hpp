@@ -0,0 +1,25 @@
+#ifndef TEXTURE_UNITS_H
+#define TEXTURE_UNITS_H
+
+/* Texture units of the library. Samplers keep the same unit in every shader,
+   so each user owns its units and they must not overlap; add new ones here. */
+
+/* Every material texture type owns a fixed range of texture units
+   (texture_diffuse1..3 on units 0-2, texture_specular on 3-5, texture_normal
+   on 6-8, texture_height on 9-11), so a sampler has the same unit in every
+   mesh and only needs to be set once per shader */
+#define MATERIAL_UNITS_PER_TYPE 3
+#define MATERIAL_UNIT_COUNT (4 * MATERIAL_UNITS_PER_TYPE)
+
+// ObjectBuffer's texture buffer, when storage buffers aren't available
+#define OBJECT_BUFFER_UNIT 13
+// BakedAnimation's pose texture
+#define BAKED_ANIMATION_UNIT 14
+// BonePalette's texture buffer
+#define BONE_PALETTE_UNIT 15
+
+static_assert(OBJECT_BUFFER_UNIT >= MATERIAL_UNIT_COUNT);
+static_assert(OBJECT_BUFFER_UNIT != BAKED_ANIMATION_UNIT && OBJECT_BUFFER_UNIT != BONE_PALETTE_UNIT);
+static_assert(BAKED_ANIMATION_UNIT >= MATERIAL_UNIT_COUNT && BAKED_ANIMATION_UNIT != BONE_PALETTE_UNIT);
+static_assert(BONE_PALETTE_UNIT >= MATERIAL_UNIT_COUNT);
+#endif
@@ -0,0 +1,248 @@
+#pragma once
+
+/* Batched TRS sampling: interpolates the translation, rotation and scale of
+   many channels at once and composes their local matrices directly, using
+   AVX or SSE lanes when the compiler targets them and plain floats otherwise.
+   Define CGRAPHICS_NO_SIMD to force the scalar path. */
+
+#include <vector>
+#include <cmath>
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#if !defined(CGRAPHICS_NO_SIMD)
+#if defined(__AVX__)
+#define CGRAPHICS_TRS_AVX 1
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CGRAPHICS_TRS_SSE 1
+#endif
+#endif
+
+#if defined(CGRAPHICS_TRS_AVX) || defined(CGRAPHICS_TRS_SSE)
+#include <immintrin.h>
+#endif
+
+/* Lane streams of a TRSSampleBatch. Each one holds a single float per channel. */
+enum TRSStream
+{
+	TRS_P0X, TRS_P0Y, TRS_P0Z, TRS_P1X, TRS_P1Y, TRS_P1Z, TRS_PT,
+	TRS_R0X, TRS_R0Y, TRS_R0Z, TRS_R0W, TRS_R1X, TRS_R1Y, TRS_R1Z, TRS_R1W, TRS_RT,
+	TRS_S0X, TRS_S0Y, TRS_S0Z, TRS_S1X, TRS_S1Y, TRS_S1Z, TRS_ST,
+	TRS_STREAM_COUNT
+};
+
+/* Structure-of-arrays key pairs for a set of channels: lane i holds the two
+   keys surrounding the sample time of channel i and the blend factor
+   between them, for translation, rotation and scale. */
+class TRSSampleBatch
+{
+public:
+	void Resize(int count)
+	{
+		m_Count = count;
+		m_Data.assign(static_cast<size_t>(count) * TRS_STREAM_COUNT, 0.0f);
+	}
+
+	inline int GetCount() const { return m_Count; }
+	inline float* Stream(TRSStream stream) { return m_Data.data() + static_cast<size_t>(stream) * m_Count; }
+	inline const float* Stream(TRSStream stream) const { return m_Data.data() + static_cast<size_t>(stream) * m_Count; }
+
+	void SetPosition(int lane, const glm::vec3& p0, const glm::vec3& p1, float factor)
+	{
+		SetVec3(lane, TRS_P0X, p0);
+		SetVec3(lane, TRS_P1X, p1);
+		Stream(TRS_PT)[lane] = factor;
+	}
+
+	void SetRotation(int lane, const glm::quat& r0, const glm::quat& r1, float factor)
+	{
+		SetQuat(lane, TRS_R0X, r0);
+		SetQuat(lane, TRS_R1X, r1);
+		Stream(TRS_RT)[lane] = factor;
+	}
+
+	void SetScale(int lane, const glm::vec3& s0, const glm::vec3& s1, float factor)
+	{
+		SetVec3(lane, TRS_S0X, s0);
+		SetVec3(lane, TRS_S1X, s1);
+		Stream(TRS_ST)[lane] = factor;
+	}
+
+private:
+	void SetVec3(int lane, int first, const glm::vec3& value)
+	{
+		Stream(TRSStream(first))[lane] = value.x;
+		Stream(TRSStream(first + 1))[lane] = value.y;
+		Stream(TRSStream(first + 2))[lane] = value.z;
+	}
+
+	void SetQuat(int lane, int first, const glm::quat& value)
+	{
+		Stream(TRSStream(first))[lane] = value.x;
+		Stream(TRSStream(first + 1))[lane] = value.y;
+		Stream(TRSStream(first + 2))[lane] = value.z;
+		Stream(TRSStream(first + 3))[lane] = value.w;
+	}
+
+	std::vector<float> m_Data;
+	int m_Count = 0;
+};
+
+namespace TRSSampler
+{
+	// One wrapper per lane width; the kernel below is written once against them.
+	struct ScalarLanes
+	{
+		static constexpr int Width = 1;
+		float v;
+
+		static inline ScalarLanes Load(const float* p) { return { *p }; }
+		static inline ScalarLanes Splat(float f) { return { f }; }
+		friend inline ScalarLanes operator+(ScalarLanes a, ScalarLanes b) { return { a.v + b.v }; }
+		friend inline ScalarLanes operator-(ScalarLanes a, ScalarLanes b) { return { a.v - b.v }; }
+		friend inline ScalarLanes operator*(ScalarLanes a, ScalarLanes b) { return { a.v * b.v }; }
+		static inline ScalarLanes InvSqrt(ScalarLanes a) { return { 1.0f / std::sqrt(a.v) }; }
+		static inline ScalarLanes NegateIfNegative(ScalarLanes a, ScalarLanes sign) { return { sign.v < 0.0f ? -a.v : a.v }; }
+
+		static inline void StoreColumn(glm::mat4* out, int column, ScalarLanes x, ScalarLanes y, ScalarLanes z, ScalarLanes w)
+		{
+			out[0][column] = glm::vec4(x.v, y.v, z.v, w.v);
+		}
+	};
+
+#if defined(CGRAPHICS_TRS_SSE)
+	struct SseLanes
+	{
+		static constexpr int Width = 4;
+		__m128 v;
+
+		static inline SseLanes Load(const float* p) { return { _mm_loadu_ps(p) }; }
+		static inline SseLanes Splat(float f) { return { _mm_set1_ps(f) }; }
+		friend inline SseLanes operator+(SseLanes a, SseLanes b) { return { _mm_add_ps(a.v, b.v) }; }
+		friend inline SseLanes operator-(SseLanes a, SseLanes b) { return { _mm_sub_ps(a.v, b.v) }; }
+		friend inline SseLanes operator*(SseLanes a, SseLanes b) { return { _mm_mul_ps(a.v, b.v) }; }
+		static inline SseLanes InvSqrt(SseLanes a) { return { _mm_div_ps(_mm_set1_ps(1.0f), _mm_sqrt_ps(a.v)) }; }
+		static inline SseLanes NegateIfNegative(SseLanes a, SseLanes sign)
+		{
+			__m128 signBit = _mm_and_ps(sign.v, _mm_set1_ps(-0.0f));
+			return { _mm_xor_ps(a.v, signBit) };
+		}
+
+		// transposes four lanes of one column into four matrices
+		static inline void StoreColumn(glm::mat4* out, int column, SseLanes x, SseLanes y, SseLanes z, SseLanes w)
+		{
+			_MM_TRANSPOSE4_PS(x.v, y.v, z.v, w.v);
+			_mm_storeu_ps(&out[0][column][0], x.v);
+			_mm_storeu_ps(&out[1][column][0], y.v);
+			_mm_storeu_ps(&out[2][column][0], z.v);
+			_mm_storeu_ps(&out[3][column][0], w.v);
+		}
+	};
+#endif
+
+#if defined(CGRAPHICS_TRS_AVX)
+	struct AvxLanes
+	{
+		static constexpr int Width = 8;
+		__m256 v;
+
+		static inline AvxLanes Load(const float* p) { return { _mm256_loadu_ps(p) }; }
+		static inline AvxLanes Splat(float f) { return { _mm256_set1_ps(f) }; }
+		friend inline AvxLanes operator+(AvxLanes a, AvxLanes b) { return { _mm256_add_ps(a.v, b.v) }; }
+		friend inline AvxLanes operator-(AvxLanes a, AvxLanes b) { return { _mm256_sub_ps(a.v, b.v) }; }
+		friend inline AvxLanes operator*(AvxLanes a, AvxLanes b) { return { _mm256_mul_ps(a.v, b.v) }; }
+		static inline AvxLanes InvSqrt(AvxLanes a) { return { _mm256_div_ps(_mm256_set1_ps(1.0f), _mm256_sqrt_ps(a.v)) }; }
+		static inline AvxLanes NegateIfNegative(AvxLanes a, AvxLanes sign)
+		{
+			__m256 signBit = _mm256_and_ps(sign.v, _mm256_set1_ps(-0.0f));
+			return { _mm256_xor_ps(a.v, signBit) };
+		}
+
+		static inline void StoreColumn(glm::mat4* out, int column, AvxLanes x, AvxLanes y, AvxLanes z, AvxLanes w)
+		{
+			SseLanes::StoreColumn(out, column,
+				{ _mm256_castps256_ps128(x.v) }, { _mm256_castps256_ps128(y.v) },
+				{ _mm256_castps256_ps128(z.v) }, { _mm256_castps256_ps128(w.v) });
+			SseLanes::StoreColumn(out + 4, column,
+				{ _mm256_extractf128_ps(x.v, 1) }, { _mm256_extractf128_ps(y.v, 1) },
+				{ _mm256_extractf128_ps(z.v, 1) }, { _mm256_extractf128_ps(w.v, 1) });
+		}
+	};
+#endif
+
+	/* Samples Lanes::Width consecutive channels starting at lane: lerp for
+	   translation and scale, shortest-path nlerp for rotation, then builds
+	   T * R * S column by column without any intermediate matrices. */
+	template<typename Lanes>
+	inline void SampleLanes(const TRSSampleBatch& batch, int lane, glm::mat4* out)
+	{
+		auto load = [&](TRSStream stream) { return Lanes::Load(batch.Stream(stream) + lane); };
+		auto lerp = [](Lanes a, Lanes b, Lanes t) { return a + (b - a) * t; };
+
+		Lanes pt = load(TRS_PT);
+		Lanes px = lerp(load(TRS_P0X), load(TRS_P1X), pt);
+		Lanes py = lerp(load(TRS_P0Y), load(TRS_P1Y), pt);
+		Lanes pz = lerp(load(TRS_P0Z), load(TRS_P1Z), pt);
+
+		Lanes st = load(TRS_ST);
+		Lanes sx = lerp(load(TRS_S0X), load(TRS_S1X), st);
+		Lanes sy = lerp(load(TRS_S0Y), load(TRS_S1Y), st);
+		Lanes sz = lerp(load(TRS_S0Z), load(TRS_S1Z), st);
+
+		Lanes r0x = load(TRS_R0X), r0y = load(TRS_R0Y), r0z = load(TRS_R0Z), r0w = load(TRS_R0W);
+		Lanes r1x = load(TRS_R1X), r1y = load(TRS_R1Y), r1z = load(TRS_R1Z), r1w = load(TRS_R1W);
+		Lanes cosTheta = r0x * r1x + r0y * r1y + r0z * r1z + r0w * r1w;
+		r1x = Lanes::NegateIfNegative(r1x, cosTheta);
+		r1y = Lanes::NegateIfNegative(r1y, cosTheta);
+		r1z = Lanes::NegateIfNegative(r1z, cosTheta);
+		r1w = Lanes::NegateIfNegative(r1w, cosTheta);
+
+		Lanes rt = load(TRS_RT);
+		Lanes qx = lerp(r0x, r1x, rt);
+		Lanes qy = lerp(r0y, r1y, rt);
+		Lanes qz = lerp(r0z, r1z, rt);
+		Lanes qw = lerp(r0w, r1w, rt);
+		Lanes invLength = Lanes::InvSqrt(qx * qx + qy * qy + qz * qz + qw * qw);
+		qx = qx * invLength;
+		qy = qy * invLength;
+		qz = qz * invLength;
+		qw = qw * invLength;
+
+		Lanes x2 = qx + qx, y2 = qy + qy, z2 = qz + qz;
+		Lanes xx = qx * x2, xy = qx * y2, xz = qx * z2;
+		Lanes yy = qy * y2, yz = qy * z2, zz = qz * z2;
+		Lanes wx = qw * x2, wy = qw * y2, wz = qw * z2;
+		Lanes one = Lanes::Splat(1.0f);
+		Lanes zero = Lanes::Splat(0.0f);
+
+		Lanes::StoreColumn(out + lane, 0, (one - (yy + zz)) * sx, (xy + wz) * sx, (xz - wy) * sx, zero);
+		Lanes::StoreColumn(out + lane, 1, (xy - wz) * sy, (one - (xx + zz)) * sy, (yz + wx) * sy, zero);
+		Lanes::StoreColumn(out + lane, 2, (xz + wy) * sz, (yz - wx) * sz, (one - (xx + yy)) * sz, zero);
+		Lanes::StoreColumn(out + lane, 3, px, py, pz, one);
+	}
+
+	// reference path, one channel at a time
+	inline void SampleScalar(const TRSSampleBatch& batch, glm::mat4* out)
+	{
+		for (int lane = 0; lane < batch.GetCount(); ++lane)
+			SampleLanes<ScalarLanes>(batch, lane, out);
+	}
+
+	/* Writes one local matrix per channel of the batch into out */
+	inline void Sample(const TRSSampleBatch& batch, glm::mat4* out)
+	{
+		int lane = 0;
+		int count = batch.GetCount();
+#if defined(CGRAPHICS_TRS_AVX)
+		for (; lane + AvxLanes::Width <= count; lane += AvxLanes::Width)
+			SampleLanes<AvxLanes>(batch, lane, out);
+#endif
+#if defined(CGRAPHICS_TRS_SSE)
+		for (; lane + SseLanes::Width <= count; lane += SseLanes::Width)
+			SampleLanes<SseLanes>(batch, lane, out);
+#endif
+		for (; lane < count; ++lane)
+			SampleLanes<ScalarLanes>(batch, lane, out);
+	}
+}
@@ -0,0 +1,196 @@
+#ifndef UNIFORM_BLOCKS_H
+#define UNIFORM_BLOCKS_H
+
+#include <glad/glad.h>
+
+#include <glm/glm.hpp>
+
+#include "glState.hpp"
+
+#include <cstddef>
+#include <cstring>
+#include <vector>
+
+/* Binding points of the std140 blocks shared by the shaders in source/shaders.
+   GLSL 330 can't set them in the shader, so Shader binds every block it finds
+   with one of these names once the program is linked. */
+#define CAMERA_BLOCK_BINDING 0
+#define LIGHTS_BLOCK_BINDING 1
+#define CASCADES_BLOCK_BINDING 2
+#define MATERIALS_BLOCK_BINDING 3
+
+// shaders reading the Cascades block have to be built with NUM_CASCADES set to this
+#define CASCADES_BLOCK_COUNT 3
+#define MATERIALS_BLOCK_COUNT 64
+
+// shader storage binding of the Objects buffer (GL 4.3, see ObjectBuffer)
+#define OBJECTS_STORAGE_BINDING 0
+
+/* C++ mirrors of the blocks, padded to the std140 layout. In std140 a vec3 takes
+   16 bytes unless a scalar follows it, and array elements are 16 byte aligned. */
+
+// layout (std140) uniform Camera { mat4 projection; mat4 view; vec3 viewPos; };
+struct CameraBlock {
+    glm::mat4 projection;
+    glm::mat4 view;
+    glm::vec3 viewPos;
+    float padding = 0.0f;
+};
+
+struct DirectionalLightBlock {
+    int on;
+    float padding0[3];
+    glm::vec3 direction;
+    float padding1;
+    glm::vec3 ambient;
+    float padding2;
+    glm::vec3 diffuse;
+    float padding3;
+    glm::vec3 specular;
+    float padding4;
+};
+
+struct PointLightBlock {
+    int on;
+    float padding0[3];
+    glm::vec3 position;
+    float padding1;
+    glm::vec3 ambient;
+    float padding2;
+    glm::vec3 diffuse;
+    float padding3;
+    glm::vec3 specular;
+    float constant;
+    float linear;
+    float quadratic;
+    float padding4[2];
+};
+
+struct SpotLightBlock {
+    int on;
+    float padding0[3];
+    glm::vec3 position;
+    float padding1;
+    glm::vec3 direction;
+    float cutOff;
+    float outerCutOff;
+    float padding2[3];
+    glm::vec3 ambient;
+    float padding3;
+    glm::vec3 diffuse;
+    float padding4;
+    glm::vec3 specular;
+    float constant;
+    float linear;
+    float quadratic;
+    float padding5[2];
+};
+
+static_assert(sizeof(CameraBlock) == 144);
+static_assert(sizeof(DirectionalLightBlock) == 80 && offsetof(DirectionalLightBlock, specular) == 64);
+static_assert(sizeof(PointLightBlock) == 96 && offsetof(PointLightBlock, constant) == 76);
+static_assert(sizeof(SpotLightBlock) == 128 && offsetof(SpotLightBlock, cutOff) == 44 && offsetof(SpotLightBlock, ambient) == 64);
+
+// layout (std140) uniform Cascades { Light light; mat4 FragPosLP[3]; float cascadeEndClipSpace[3]; };
+struct CascadesBlock {
+    glm::vec3 direction;
+    float padding0;
+    glm::vec3 ambient;
+    float padding1;
+    glm::vec3 diffuse;
+    float padding2;
+    glm::vec3 specular;
+    float padding3;
+    glm::mat4 lightSpace[CASCADES_BLOCK_COUNT];
+    // only x is read, float arrays have a 16 byte stride
+    glm::vec4 cascadeEndClipSpace[CASCADES_BLOCK_COUNT];
+};
+
+static_assert(sizeof(CascadesBlock) == 64 + 64 * CASCADES_BLOCK_COUNT + 16 * CASCADES_BLOCK_COUNT);
+
+// layout (std140) uniform Materials { MaterialData materials[64]; }, indexed by the object's material index
+struct MaterialBlock {
+    glm::vec3 ambient;
+    float shininess;
+    glm::vec3 diffuse;
+    float padding0;
+    glm::vec3 specular;
+    float padding1;
+    glm::vec3 color;
+    float padding2;
+};
+
+static_assert(sizeof(MaterialBlock) == 64 && offsetof(MaterialBlock, color) == 48);
+
+/* Uniform buffer attached to a fixed binding point. Every program with a
+   block on that binding reads it, so per-frame data is uploaded once instead
+   of once per program. */
+class UniformBuffer {
+public:
+    explicit UniformBuffer(unsigned int binding) : binding(binding), buffer(0), capacity(0) {}
+
+    ~UniformBuffer()
+    {
+        if (buffer)
+            GLState::Get().DeleteBuffers(1, &buffer);
+    }
+
+    UniformBuffer(const UniformBuffer&) = delete;
+    UniformBuffer& operator=(const UniformBuffer&) = delete;
+
+    void Upload(const void* data, size_t size)
+    {
+        if (!buffer)
+            glGenBuffers(1, &buffer);
+
+        GLState::Get().BindBuffer(GL_UNIFORM_BUFFER, buffer);
+        if (size > capacity) {
+            capacity = size;
+            glBufferData(GL_UNIFORM_BUFFER, static_cast<GLsizeiptr>(size), data, GL_DYNAMIC_DRAW);
+            GLState::Get().BindBufferBase(GL_UNIFORM_BUFFER, binding, buffer);
+        }
+        else {
+            glBufferSubData(GL_UNIFORM_BUFFER, 0, static_cast<GLsizeiptr>(size), data);
+        }
+        GLState::Get().BindBuffer(GL_UNIFORM_BUFFER, 0);
+    }
+
+    template <typename T>
+    void Upload(const T& block) { Upload(&block, sizeof(T)); }
+
+private:
+    unsigned int binding;
+    unsigned int buffer;
+    size_t capacity;
+};
+
+/* The Lights block of the multiple light shaders:
+   layout (std140) uniform Lights { DirectionalLight dirLights[NR_DIR_LIGHTS]; PointLight pointLights[NR_POINT_LIGHTS]; SpotLight spotLights[NR_SPOT_LIGHTS]; };
+   The light counts must be the ones in the shader variant. */
+class LightsBuffer {
+public:
+    std::vector<DirectionalLightBlock> dirLights;
+    std::vector<PointLightBlock> pointLights;
+    std::vector<SpotLightBlock> spotLights;
+
+    LightsBuffer(int dirLightCount, int pointLightCount, int spotLightCount)
+        : dirLights(dirLightCount), pointLights(pointLightCount), spotLights(spotLightCount), buffer(LIGHTS_BLOCK_BINDING) {}
+
+    // the arrays follow each other with no padding, every element is a multiple of 16 bytes
+    void Upload()
+    {
+        size_t dirBytes = dirLights.size() * sizeof(DirectionalLightBlock);
+        size_t pointBytes = pointLights.size() * sizeof(PointLightBlock);
+        size_t spotBytes = spotLights.size() * sizeof(SpotLightBlock);
+        packed.resize(dirBytes + pointBytes + spotBytes);
+        std::memcpy(packed.data(), dirLights.data(), dirBytes);
+        std::memcpy(packed.data() + dirBytes, pointLights.data(), pointBytes);
+        std::memcpy(packed.data() + dirBytes + pointBytes, spotLights.data(), spotBytes);
+        buffer.Upload(packed.data(), packed.size());
+    }
+
+private:
+    UniformBuffer buffer;
+    std::vector<unsigned char> packed;
+};
+#endif
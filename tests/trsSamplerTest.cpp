@@ -0,0 +1,186 @@
+/* Samples random clips through every TRS sampler lane width compiled in and
+   compares the matrices with Bone::Update, the glm reference path. Update
+   slerps rotations while the sampler nlerps them, so neighbouring keys are
+   kept within a few degrees of each other and compared with a tolerance. */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include "bone.hpp"
+#include "trsSampler.hpp"
+
+// largest difference allowed in any element of a local matrix
+#define TRS_TEST_TOLERANCE 1e-3f
+
+static std::mt19937 generator(1234);
+
+static float Random(float low, float high)
+{
+	return std::uniform_real_distribution<float>(low, high)(generator);
+}
+
+static glm::vec3 RandomVec3(float low, float high)
+{
+	return glm::vec3(Random(low, high), Random(low, high), Random(low, high));
+}
+
+// unit quaternion rotated a small random step away from previous
+static glm::quat RandomStep(const glm::quat& previous)
+{
+	glm::quat step = glm::normalize(glm::quat(1.0f, Random(-0.1f, 0.1f), Random(-0.1f, 0.1f), Random(-0.1f, 0.1f)));
+	glm::quat next = glm::normalize(previous * step);
+	// flip the sign half of the time, which the sampler has to take the shortest path through
+	return Random(0.0f, 1.0f) < 0.5f ? next : -next;
+}
+
+// evenly spaced key times, the inner ones jittered by less than half the spacing so they stay in order
+static std::vector<double> RandomTimes(int count, float duration)
+{
+	std::vector<double> times(count);
+	if (count == 1)
+		return times;
+	float spacing = duration / (count - 1);
+	for (int i = 0; i < count; i++)
+		times[i] = spacing * i + (i > 0 && i < count - 1 ? Random(-0.4f, 0.4f) * spacing : 0.0f);
+	return times;
+}
+
+// one channel with 1 to 12 keys per track; the keys are owned by the node, as in an aiScene
+static aiNodeAnim* RandomChannel(float duration)
+{
+	aiNodeAnim* channel = new aiNodeAnim();
+	std::uniform_int_distribution<int> keyCount(1, 12);
+
+	channel->mNumPositionKeys = keyCount(generator);
+	channel->mPositionKeys = new aiVectorKey[channel->mNumPositionKeys];
+	std::vector<double> times = RandomTimes(channel->mNumPositionKeys, duration);
+	for (unsigned i = 0; i < channel->mNumPositionKeys; i++)
+	{
+		glm::vec3 position = RandomVec3(-10.0f, 10.0f);
+		channel->mPositionKeys[i].mTime = times[i];
+		channel->mPositionKeys[i].mValue.x = position.x;
+		channel->mPositionKeys[i].mValue.y = position.y;
+		channel->mPositionKeys[i].mValue.z = position.z;
+	}
+
+	channel->mNumRotationKeys = keyCount(generator);
+	channel->mRotationKeys = new aiQuatKey[channel->mNumRotationKeys];
+	times = RandomTimes(channel->mNumRotationKeys, duration);
+	glm::quat rotation = glm::normalize(glm::quat(Random(-1.0f, 1.0f), Random(-1.0f, 1.0f), Random(-1.0f, 1.0f), Random(-1.0f, 1.0f)));
+	for (unsigned i = 0; i < channel->mNumRotationKeys; i++)
+	{
+		rotation = RandomStep(rotation);
+		channel->mRotationKeys[i].mTime = times[i];
+		channel->mRotationKeys[i].mValue.w = rotation.w;
+		channel->mRotationKeys[i].mValue.x = rotation.x;
+		channel->mRotationKeys[i].mValue.y = rotation.y;
+		channel->mRotationKeys[i].mValue.z = rotation.z;
+	}
+
+	channel->mNumScalingKeys = keyCount(generator);
+	channel->mScalingKeys = new aiVectorKey[channel->mNumScalingKeys];
+	times = RandomTimes(channel->mNumScalingKeys, duration);
+	for (unsigned i = 0; i < channel->mNumScalingKeys; i++)
+	{
+		glm::vec3 scale = RandomVec3(0.5f, 2.0f);
+		channel->mScalingKeys[i].mTime = times[i];
+		channel->mScalingKeys[i].mValue.x = scale.x;
+		channel->mScalingKeys[i].mValue.y = scale.y;
+		channel->mScalingKeys[i].mValue.z = scale.z;
+	}
+	return channel;
+}
+
+static float MaxDifference(const glm::mat4& a, const glm::mat4& b)
+{
+	float difference = 0.0f;
+	for (int column = 0; column < 4; column++)
+		for (int row = 0; row < 4; row++)
+			difference = std::max(difference, std::abs(a[column][row] - b[column][row]));
+	return difference;
+}
+
+// samples the batch Lanes::Width channels at a time, the rest one by one
+template<typename Lanes>
+static void SampleWith(const TRSSampleBatch& batch, glm::mat4* out)
+{
+	int lane = 0;
+	for (; lane + Lanes::Width <= batch.GetCount(); lane += Lanes::Width)
+		TRSSampler::SampleLanes<Lanes>(batch, lane, out);
+	for (; lane < batch.GetCount(); ++lane)
+		TRSSampler::SampleLanes<TRSSampler::ScalarLanes>(batch, lane, out);
+}
+
+struct LaneResult
+{
+	const char* name;
+	void (*sample)(const TRSSampleBatch&, glm::mat4*);
+	float maxError = 0.0f;
+};
+
+int main()
+{
+	std::vector<LaneResult> lanes;
+	lanes.push_back({ "scalar", SampleWith<TRSSampler::ScalarLanes> });
+#if defined(CGRAPHICS_TRS_SSE)
+	lanes.push_back({ "sse", SampleWith<TRSSampler::SseLanes> });
+#endif
+#if defined(CGRAPHICS_TRS_AVX)
+	lanes.push_back({ "avx", SampleWith<TRSSampler::AvxLanes> });
+#endif
+	lanes.push_back({ "dispatch", TRSSampler::Sample });
+
+	const int clips = 20;
+	const int samplesPerClip = 50;
+	for (int clip = 0; clip < clips; clip++)
+	{
+		// odd channel counts leave a tail for the scalar lanes
+		int channelCount = std::uniform_int_distribution<int>(1, 37)(generator);
+		float duration = Random(1.0f, 10.0f);
+		std::vector<aiNodeAnim*> channels;
+		std::vector<Bone> bones;
+		for (int i = 0; i < channelCount; i++)
+		{
+			channels.push_back(RandomChannel(duration));
+			bones.emplace_back("bone" + std::to_string(i), i, channels.back());
+		}
+
+		std::vector<BoneCursor> cursors(channelCount);
+		TRSSampleBatch batch;
+		batch.Resize(channelCount);
+		std::vector<glm::mat4> sampled(channelCount);
+		for (int sample = 0; sample < samplesPerClip; sample++)
+		{
+			// also outside the clip, where the end keys clamp
+			float time = Random(-0.5f, duration + 0.5f);
+			for (int i = 0; i < channelCount; i++)
+			{
+				bones[i].Gather(time, cursors[i], batch, i);
+				bones[i].Update(time);
+			}
+
+			for (auto& lane : lanes)
+			{
+				lane.sample(batch, sampled.data());
+				for (int i = 0; i < channelCount; i++)
+					lane.maxError = std::max(lane.maxError, MaxDifference(sampled[i], bones[i].GetLocalTransform()));
+			}
+		}
+
+		for (aiNodeAnim* channel : channels)
+			delete channel;
+	}
+
+	bool passed = true;
+	for (const auto& lane : lanes)
+	{
+		bool lanePassed = lane.maxError <= TRS_TEST_TOLERANCE;
+		std::printf("%-8s max error %g %s\n", lane.name, lane.maxError, lanePassed ? "ok" : "FAILED");
+		passed = passed && lanePassed;
+	}
+	return passed ? 0 : 1;
+}